@@ -0,0 +1,138 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_INSTRUMENTATION_HH_
+#define SDF_INSTRUMENTATION_HH_
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <sdf/sdf_config.h>
+#include "sdf/system_util.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::string
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  /// \enum LoadPhase
+  /// \brief Phases of loading an SDFormat document that are measured. Phases
+  /// can be nested, in which case the time of the inner phase is also part
+  /// of the time of the outer phase. For example, the includes of a file are
+  /// read during the READ_XML phase of that file.
+  /// \sa LoadMeasurement
+  enum class LoadPhase
+  {
+    /// \brief Parsing a file or string into a TinyXML2 document.
+    XML_PARSE,
+
+    /// \brief Converting a document from an older SDFormat version, or
+    /// from URDF.
+    CONVERT,
+
+    /// \brief Building the SDF elements of a document. When XML streaming
+    /// is enabled (see sdf::setXmlStreaming), this includes parsing the XML.
+    READ_XML,
+
+    /// \brief Finding and reading the file of an <include> element.
+    INCLUDE,
+
+    /// \brief Constructing the DOM objects in sdf::Root::Load.
+    DOM_LOAD,
+
+    /// \brief Building and validating the frame graphs of a model or world.
+    FRAME_GRAPH,
+  };
+
+  /// \brief Time spent in one phase of loading, reported to the callback
+  /// set with sdf::setLoadMeasurementCallback.
+  class SDFORMAT_VISIBLE LoadMeasurement
+  {
+    /// \brief Constructor.
+    /// \param[in] _phase The measured phase.
+    /// \param[in] _source The file, string or object the phase worked on.
+    /// \param[in] _duration Wall time of the phase.
+    /// \param[in] _count Number of items handled by the phase.
+    public: LoadMeasurement(const LoadPhase _phase,
+                            const std::string &_source,
+                            const std::chrono::nanoseconds _duration,
+                            const std::size_t _count);
+
+    /// \brief Get the measured phase.
+    /// \return The phase.
+    public: LoadPhase Phase() const;
+
+    /// \brief Get what the phase worked on. This is the path of a file,
+    /// "data-string" or "urdf string" for a string, the URI of an <include>
+    /// element, or the name of a model or world for FRAME_GRAPH.
+    /// \return The source of the measurement.
+    public: const std::string &Source() const;
+
+    /// \brief Get the wall time of the phase.
+    /// \return The duration.
+    public: std::chrono::nanoseconds Duration() const;
+
+    /// \brief Get the number of items handled by the phase. This is the
+    /// number of elements built for READ_XML, the number of DOM objects
+    /// constructed under the root for DOM_LOAD, the number of frames in the
+    /// pose graph for FRAME_GRAPH, and 1 for the other phases.
+    /// \return The number of items.
+    public: std::size_t Count() const;
+
+    /// \brief The measured phase.
+    private: LoadPhase phase;
+
+    /// \brief Source of the measurement.
+    private: std::string source;
+
+    /// \brief Wall time of the phase.
+    private: std::chrono::nanoseconds duration;
+
+    /// \brief Number of items handled by the phase.
+    private: std::size_t count;
+  };
+
+  /// \brief Callback that receives load measurements.
+  using LoadMeasurementCallback =
+      std::function<void (const LoadMeasurement &)>;
+
+  /// \brief Set the callback that receives a measurement at the end of each
+  /// phase of loading, in all threads. The callback must be thread safe
+  /// when files are loaded by several threads, including when
+  /// sdf::setIncludeThreadCount or sdf::setDomLoadThreadCount are used,
+  /// and must not throw.
+  /// Measuring is disabled when no callback is set, which is the default,
+  /// and then only costs a check of a flag per phase.
+  /// \param[in] _callback The callback, or nullptr to disable measuring.
+  SDFORMAT_VISIBLE
+  void setLoadMeasurementCallback(LoadMeasurementCallback _callback);
+  }
+}
+
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+
+#endif
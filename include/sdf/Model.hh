@@ -273,6 +273,35 @@ namespace sdf
     /// \return SemanticPose object for this link.
     public: sdf::SemanticPose SemanticPose() const;
 
+    /// \brief Resolve the poses of all frames of this model, including the
+    /// frames of nested models, in a single pass over the pose graphs.
+    /// \param[out] _poses Names and resolved poses of the frames, sorted by
+    /// frame name. Names of frames in nested models are scoped, for example
+    /// "nested_model::link". Existing contents are replaced.
+    /// \param[in] _resolveTo Name of the frame relative to which the poses
+    /// are resolved, which may be a scoped name. An empty value resolves the
+    /// poses relative to the model frame.
+    /// \return Errors, for example if a frame or _resolveTo can't be
+    /// resolved. Frames that can't be resolved are left out of _poses.
+    public: Errors ResolveAllPoses(FramePoses &_poses,
+                                   const std::string &_resolveTo = "") const;
+
+    /// \brief Set the raw poses of several links, joints, frames or nested
+    /// models of this model and update the pose graph with them. The
+    /// resolved poses that depend on them are recomputed once for the whole
+    /// batch. Copies of this model keep their poses.
+    ///
+    /// As in Load, the pose given for a nested model with a placement frame
+    /// is the pose of its placement frame, and the model gets the matching
+    /// pose of its model frame. The same goes for the model frames of
+    /// included models with a placement frame.
+    /// \param[in] _poses Names of the links, joints, frames or nested models
+    /// paired with their new raw poses, which are relative to the frames
+    /// given by their relative_to attributes.
+    /// \return Errors, for example if no link, joint, frame or nested model
+    /// has one of the names. The other poses are still set.
+    public: Errors SetRawPoses(const FramePoses &_poses);
+
     /// \brief Get the name of the placement frame of the model.
     /// \return Name of the placement frame attribute of the model.
     public: const std::string &PlacementFrameName() const;
@@ -290,6 +319,25 @@ namespace sdf
     private: sdf::Errors SetPoseRelativeToGraph(
         std::weak_ptr<const PoseRelativeToGraph> _graph);
 
+    /// \brief Get the PoseRelativeToGraph of this model to modify it. The
+    /// graph is shared with the copies of this model, so while a copy still
+    /// uses it, this model first gets its own copy of the graph and points
+    /// its children to it.
+    /// \return The graph, or nullptr if it wasn't built in Load.
+    private: PoseRelativeToGraph *PoseGraphForUpdate();
+
+    /// \brief Convert a pose of the placement frame of this model, as
+    /// specified by //model/pose, to the pose of the model frame relative to
+    /// the same frame, as Load does. This is private and is intended to be
+    /// called by Load and by SetRawPoses of the parent model or world.
+    /// \param[in] _placementPose Pose of the placement frame (X_RPf).
+    /// \param[out] _modelPose Pose of the model frame (X_RM). It's set to
+    /// _placementPose if the model has no placement frame or on error.
+    /// \return Errors if the placement frame can't be resolved.
+    private: Errors ModelPoseFromPlacementPose(
+        const ignition::math::Pose3d &_placementPose,
+        ignition::math::Pose3d &_modelPose) const;
+
     /// \brief Get the model's canonical link and the nested name of the link
     /// relative to the current model, delimited by "::".
     /// \return An immutable pointer to the canonical link and the nested
@@ -297,7 +345,46 @@ namespace sdf
     private: std::pair<const Link *, std::string> CanonicalLinkAndRelativeName()
         const;
 
-    /// \brief Allow World::Load to call SetPoseRelativeToGraph.
+    /// \brief Append the resolved poses of the frames of this model and its
+    /// nested models. This is private and is intended to be called by
+    /// ResolveAllPoses of this model, its parent model or its world.
+    /// \param[in,out] _poses Table to append to.
+    /// \param[in] _prefix Prefix for the frame names, such as "model::".
+    /// \param[in] _pose Pose of the model frame relative to the frame the
+    /// appended poses are resolved to.
+    /// \param[in] _includeModelFrame True to append the model frame itself.
+    /// \return Errors.
+    private: Errors AppendPoses(FramePoses &_poses,
+                                const std::string &_prefix,
+                                const ignition::math::Pose3d &_pose,
+                                bool _includeModelFrame) const;
+
+    /// \brief Append the errors found while building and validating the
+    /// FrameAttachedToGraph of this model in Load. This is private and is
+    /// intended to be called by Root.
+    /// \param[in,out] _buildErrors Errors to append the build errors to.
+    /// \param[in,out] _validateErrors Errors to append the validation
+    /// errors to.
+    /// \return False if the graph wasn't built in Load, as is the case
+    /// for static models.
+    private: bool FrameAttachedToGraphErrors(Errors &_buildErrors,
+                                             Errors &_validateErrors) const;
+
+    /// \brief Append the errors found while building and validating the
+    /// PoseRelativeToGraph of this model in Load. This is private and is
+    /// intended to be called by Root.
+    /// \param[in,out] _buildErrors Errors to append the build errors to.
+    /// \param[in,out] _validateErrors Errors to append the validation
+    /// errors to.
+    /// \return False if the graph wasn't built in Load.
+    private: bool PoseRelativeToGraphErrors(Errors &_buildErrors,
+                                            Errors &_validateErrors) const;
+
+    /// \brief Allow Root to get the errors of the graphs.
+    friend class Root;
+
+    /// \brief Allow World::Load to call SetPoseRelativeToGraph, and
+    /// World::SetRawPoses to call ModelPoseFromPlacementPose.
     friend class World;
 
     /// \brief Allow helper function in FrameSemantics.cc to call
@@ -281,6 +281,31 @@ namespace sdf
     //// \brief Name of the type.
     public: std::string typeName;
 
+    /// \brief Types of value that a parameter can hold.
+    public: enum class ValueType
+    {
+      UNKNOWN,
+      BOOL,
+      CHAR,
+      STRING,
+      INT,
+      UINT64,
+      UNSIGNED_INT,
+      DOUBLE,
+      FLOAT,
+      TIME,
+      COLOR,
+      VECTOR2I,
+      VECTOR2D,
+      VECTOR3D,
+      POSE3D,
+      QUATERNIOND
+    };
+
+    /// \brief Type of value held by the parameter, resolved from typeName
+    /// when the parameter is constructed.
+    public: ValueType valueType = ValueType::UNKNOWN;
+
     /// \brief Description of the parameter.
     public: std::string description;
 
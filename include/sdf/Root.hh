@@ -51,6 +51,10 @@ namespace sdf
   ///
   /// \snippet examples/dom.cc rootUsage
   ///
+  /// # Thread safety
+  ///
+  /// Different Root objects can be loaded from several threads at once.
+  ///
   class SDFORMAT_VISIBLE Root
   {
     /// \brief Default constructor
@@ -161,6 +165,26 @@ namespace sdf
     /// not been called.
     public: sdf::ElementPtr Element() const;
 
+    /// \brief Get the errors in the FrameAttachedToGraph of each world and
+    /// model, including the models in the worlds but not nested models. The
+    /// graphs that were built and validated in Load are reused, so only the
+    /// graphs that Load doesn't build, such as those of static models, are
+    /// built here.
+    /// \param[out] _buildErrors Errors found while building the graphs.
+    /// \param[out] _validateErrors Errors found while validating the
+    /// graphs.
+    public: void FrameAttachedToGraphErrors(Errors &_buildErrors,
+                                            Errors &_validateErrors) const;
+
+    /// \brief Get the errors in the PoseRelativeToGraph of each world and
+    /// model, including the models in the worlds but not nested models. The
+    /// graphs that were built and validated in Load are reused.
+    /// \param[out] _buildErrors Errors found while building the graphs.
+    /// \param[out] _validateErrors Errors found while validating the
+    /// graphs.
+    public: void PoseRelativeToGraphErrors(Errors &_buildErrors,
+                                           Errors &_validateErrors) const;
+
     /// \brief Private data pointer
     private: RootPrivate *dataPtr = nullptr;
   };
@@ -59,6 +59,8 @@ namespace sdf
   /// \param[in] _useCallback True to find a file based on a registered
   /// callback if the file is not found via the normal mechanism.
   /// \return File's full path.
+  /// \note This function is thread-safe. The registered callback may be
+  /// called from several threads at once.
   SDFORMAT_VISIBLE
   std::string findFile(const std::string &_filename,
                        bool _searchLocalPath = true,
@@ -68,13 +70,15 @@ namespace sdf
   /// Example paramters: "model://", "/usr/share/models:~/.gazebo/models"
   /// \param[in] _uri URI that will be mapped to _path
   /// \param[in] _path Colon separated set of paths.
+  /// \note This function is thread-safe.
   SDFORMAT_VISIBLE
   void addURIPath(const std::string &_uri, const std::string &_path);
 
   /// \brief Set the callback to use when SDF can't find a file.
   /// The callback should return a complete path to the requested file, or
   /// and empty string if the file was not found in the callback.
-  /// \param[in] _cb The callback function.
+  /// \param[in] _cb The callback function. Since files may be loaded from
+  /// several threads at once, the callback should be thread-safe.
   SDFORMAT_VISIBLE
   void setFindCallback(std::function<std::string (const std::string &)> _cb);
 
@@ -19,6 +19,8 @@
 
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 #include <ignition/math/Pose3.hh>
 
 #include <sdf/Error.hh>
@@ -43,6 +45,11 @@ namespace sdf
   class SemanticPosePrivate;
   struct PoseRelativeToGraph;
 
+  /// \brief Names of frames paired with their resolved poses, as returned by
+  /// Model::ResolveAllPoses and World::ResolveAllPoses.
+  using FramePoses =
+      std::vector<std::pair<std::string, ignition::math::Pose3d>>;
+
   /// \brief SemanticPose is a data structure that can be used by different
   /// DOM objects to resolve poses on a PoseRelativeToGraph. This object holds
   /// a Pose3 object, the name of the frame relative to which it is defined,
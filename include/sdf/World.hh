@@ -24,6 +24,7 @@
 #include "sdf/Element.hh"
 #include "sdf/Gui.hh"
 #include "sdf/Scene.hh"
+#include "sdf/SemanticPose.hh"
 #include "sdf/Types.hh"
 #include "sdf/sdf_config.h"
 #include "sdf/system_util.hh"
@@ -269,6 +270,65 @@ namespace sdf
     /// \return True if there exists a physics profile with the given name.
     public: bool PhysicsNameExists(const std::string &_name) const;
 
+    /// \brief Resolve the poses of all frames of this world, including the
+    /// frames of its models and their nested models, in a single pass over
+    /// the pose graphs.
+    /// \param[out] _poses Names and resolved poses of the frames, sorted by
+    /// frame name. Names of frames in models are scoped, for example
+    /// "model::link". Existing contents are replaced.
+    /// \param[in] _resolveTo Name of the frame relative to which the poses
+    /// are resolved, which may be a scoped name. An empty value resolves the
+    /// poses relative to the world frame.
+    /// \return Errors, for example if a frame or _resolveTo can't be
+    /// resolved. Frames that can't be resolved are left out of _poses.
+    public: Errors ResolveAllPoses(FramePoses &_poses,
+                                   const std::string &_resolveTo = "") const;
+
+    /// \brief Set the raw poses of several models or frames of this world
+    /// and update the pose graph with them. The resolved poses that depend
+    /// on them are recomputed once for the whole batch. Copies of this world
+    /// keep their poses.
+    ///
+    /// As in Load, the pose given for a model with a placement frame is the
+    /// pose of its placement frame, and the model gets the matching pose of
+    /// its model frame.
+    /// \param[in] _poses Names of the models or frames paired with their new
+    /// raw poses, which are relative to the frames given by their
+    /// relative_to attributes.
+    /// \return Errors, for example if no model or frame has one of the
+    /// names. The other poses are still set.
+    public: Errors SetRawPoses(const FramePoses &_poses);
+
+    /// \brief Append the errors found while building and validating the
+    /// FrameAttachedToGraph of this world in Load. This is private and is
+    /// intended to be called by Root.
+    /// \param[in,out] _buildErrors Errors to append the build errors to.
+    /// \param[in,out] _validateErrors Errors to append the validation
+    /// errors to.
+    /// \return False if the graph wasn't built in Load.
+    private: bool FrameAttachedToGraphErrors(Errors &_buildErrors,
+                                             Errors &_validateErrors) const;
+
+    /// \brief Append the errors found while building and validating the
+    /// PoseRelativeToGraph of this world in Load. This is private and is
+    /// intended to be called by Root.
+    /// \param[in,out] _buildErrors Errors to append the build errors to.
+    /// \param[in,out] _validateErrors Errors to append the validation
+    /// errors to.
+    /// \return False if the graph wasn't built in Load.
+    private: bool PoseRelativeToGraphErrors(Errors &_buildErrors,
+                                            Errors &_validateErrors) const;
+
+    /// \brief Get the PoseRelativeToGraph of this world to modify it. The
+    /// graph is shared with the copies of this world, so while a copy still
+    /// uses it, this world first gets its own copy of the graph and points
+    /// its children to it.
+    /// \return The graph, or nullptr if it wasn't built in Load.
+    private: PoseRelativeToGraph *PoseGraphForUpdate();
+
+    /// \brief Allow Root to get the errors of the graphs.
+    friend class Root;
+
     /// \brief Private data pointer.
     private: WorldPrivate *dataPtr = nullptr;
   };
@@ -17,6 +17,7 @@
 #ifndef SDF_PARSER_HH_
 #define SDF_PARSER_HH_
 
+#include <cstddef>
 #include <string>
 
 #include "sdf/SDFImpl.hh"
@@ -33,6 +34,10 @@
 ///
 /// XML elements that are not part of the SDF specification are copied in
 /// place. This preserves the given XML structure and data.
+///
+/// The parsing functions can be called from several threads at once, as long
+/// as each call populates its own SDF object. Changing the SDF version with
+/// sdf::SDF::Version while files are being parsed is not thread safe.
 namespace sdf
 {
   // Inline bracket to help doxygen filtering.
@@ -56,6 +61,111 @@ namespace sdf
   SDFORMAT_VISIBLE
   bool initString(const std::string &_xmlString, SDFPtr _sdf);
 
+  /// \brief Build the description of the SDFormat spec for the current
+  /// version, if it has not been built yet.
+  ///
+  /// Spec descriptions are built once per version and kept in a
+  /// process-wide cache that is shared by sdf::init, sdf::initFile,
+  /// sdf::readFile, sdf::readString and sdf::Root::Load. The cache is filled
+  /// on first use, so calling this function is optional. It can be used to
+  /// move the cost of building the description to program startup.
+  /// This function is thread safe.
+  /// \return True if the spec description is available.
+  SDFORMAT_VISIBLE
+  bool warmSchemaCache();
+
+  /// \brief Set the number of threads used to load the files referenced by
+  /// <include> elements.
+  ///
+  /// By default included files are found and read one after the other. With
+  /// more than one thread, the files of all <include> children of an element
+  /// are found and read at the same time, then merged in document order, so
+  /// the result and the reported errors are the same as with a single
+  /// thread. Files included by included files are read serially. The find
+  /// callback set with sdf::setFindCallback must be thread safe when more
+  /// than one thread is used.
+  /// \param[in] _threadCount Number of threads. 0 and 1 both disable
+  /// parallel loading.
+  SDFORMAT_VISIBLE
+  void setIncludeThreadCount(unsigned int _threadCount);
+
+  /// \brief Get the number of threads used to load the files referenced by
+  /// <include> elements.
+  /// \return Number of threads, 1 if parallel loading is disabled.
+  /// \sa setIncludeThreadCount
+  SDFORMAT_VISIBLE
+  unsigned int includeThreadCount();
+
+  /// \brief Set the number of threads used to construct DOM objects, such
+  /// as sdf::Model and sdf::Light, in sdf::Root::Load.
+  ///
+  /// By default DOM objects are constructed one after the other. With more
+  /// than one thread, sibling objects of the same type, such as the models
+  /// of a world, are constructed at the same time. Their names are then
+  /// checked for uniqueness in document order, so the result and the
+  /// returned errors are the same as with a single thread, though console
+  /// messages may be printed in a different order. The children of objects
+  /// that are constructed on those threads are constructed serially.
+  /// The elements being loaded must not be modified by other threads.
+  /// \param[in] _threadCount Number of threads. 0 and 1 both disable
+  /// parallel construction.
+  SDFORMAT_VISIBLE
+  void setDomLoadThreadCount(unsigned int _threadCount);
+
+  /// \brief Get the number of threads used to construct DOM objects.
+  /// \return Number of threads, 1 if parallel construction is disabled.
+  /// \sa setDomLoadThreadCount
+  SDFORMAT_VISIBLE
+  unsigned int domLoadThreadCount();
+
+  /// \brief Set the maximum number of files kept in the include cache.
+  ///
+  /// By default the include cache is disabled. When enabled, files loaded
+  /// for <include> elements are kept in a process-wide cache, keyed by the
+  /// resolved model directory. Including the same model again
+  /// copies the cached elements instead of reading and parsing the files.
+  /// A cached file is only used while the model file, its model.config and
+  /// the files of its own includes are unchanged, which is checked using
+  /// their modification times and sizes. The least recently used files are
+  /// dropped when the cache is full. The cache is cleared when
+  /// sdf::setFindCallback or sdf::addURIPath is called.
+  /// \param[in] _maxEntries Maximum number of files. 0, the default,
+  /// disables the cache.
+  SDFORMAT_VISIBLE
+  void setIncludeCacheSize(std::size_t _maxEntries);
+
+  /// \brief Get the maximum number of files kept in the include cache.
+  /// \return Maximum number of files.
+  /// \sa setIncludeCacheSize
+  SDFORMAT_VISIBLE
+  std::size_t includeCacheSize();
+
+  /// \brief Remove all files from the include cache.
+  /// \sa setIncludeCacheSize
+  SDFORMAT_VISIBLE
+  void clearIncludeCache();
+
+  /// \brief Enable or disable streaming of XML documents.
+  ///
+  /// By default, readFile and readString first parse the whole document
+  /// into a TinyXML2 document, and then build the SDF elements from it.
+  /// With streaming enabled, SDF elements are built while the document is
+  /// read, so the XML tree of the document is never held in memory. This
+  /// reduces the peak memory use for large files. Documents that need to
+  /// be converted from an older SDFormat version, URDF files and
+  /// documents whose <include> elements are loaded on several threads (see
+  /// setIncludeThreadCount) are still parsed into a TinyXML2 document.
+  /// The resulting elements are the same either way.
+  /// \param[in] _enabled True to enable streaming.
+  SDFORMAT_VISIBLE
+  void setXmlStreaming(bool _enabled);
+
+  /// \brief Check whether streaming of XML documents is enabled.
+  /// \return True if it is enabled.
+  /// \sa setXmlStreaming
+  SDFORMAT_VISIBLE
+  bool xmlStreaming();
+
   /// \brief Populate the SDF values from a file
   ///
   /// This populates the given sdf pointer from a file. If the file is a URDF
@@ -0,0 +1,183 @@
+#!/usr/bin/env ruby
+
+# Generates EmbeddedSdfSchema.cc, which contains the element descriptions of
+# the supported SDF specification versions as constant tables. The parser
+# builds its description trees from these tables instead of parsing the
+# *.sdf files as XML at runtime. The tables mirror what initXml in
+# src/parser.cc reads from each file.
+
+require 'rexml/document'
+
+# The list of supported SDF specification versions. Keep this in sync with
+# embedSdf.rb.
+supportedSdfVersions = ['1.8', '1.7', '1.6', '1.5', '1.4', '1.3', '1.2']
+
+# Returns a C++ string literal for the given string, or nullptr if it is nil.
+def literal(str)
+  return 'nullptr' if str.nil?
+  out = String.new('"', encoding: 'BINARY')
+  str.gsub("\r\n", "\n").b.each_byte do |b|
+    case b
+    when 0x5c then out << '\\\\'
+    when 0x22 then out << '\\"'
+    when 0x0a then out << '\\n'
+    when 0x09 then out << '\\t'
+    when 0x00..0x1f, 0x7f then out << format('\\%03o', b)
+    else out << b.chr
+    end
+  end
+  out << '"'
+end
+
+# Returns the text of an element the same way tinyxml2's GetText does: the
+# value of the first child node if it is a text or CDATA node, nil
+# otherwise.
+def text_of(elem)
+  return nil if elem.nil?
+  child = elem.children.first
+  return nil unless child.is_a?(REXML::Text)
+  child.value
+end
+
+$attributes = []
+$includes = []
+$children = []
+$elements = []
+
+# Adds an element description and all of its children to the tables.
+# Returns the index of the element in $elements.
+def add_element(xml, pathname)
+  name = xml.attributes['name']
+  required = xml.attributes['required']
+  raise "#{pathname}: element is missing the name attribute" if name.nil?
+  raise "#{pathname}: element [#{name}] is missing the required attribute" \
+    if required.nil?
+
+  type = xml.attributes['type']
+  default = xml.attributes['default']
+  raise "#{pathname}: element [#{name}] is missing a default" \
+    if !type.nil? && default.nil?
+
+  attributes = []
+  xml.each_element('attribute') do |attr|
+    %w[name type default required].each do |key|
+      raise "#{pathname}: attribute of [#{name}] is missing a #{key}" \
+        if attr.attributes[key].nil?
+    end
+    attributes << [attr.attributes['name'], attr.attributes['type'],
+                   attr.attributes['default'], attr.attributes['required'],
+                   text_of(attr.elements['description']) || '']
+  end
+
+  copy_data = false
+  child_xml = []
+  xml.each_element('element') do |child|
+    if ['true', '1'].include?(child.attributes['copy_data'])
+      copy_data = true
+    else
+      child_xml << child
+    end
+  end
+
+  includes = []
+  xml.each_element('include') do |inc|
+    description = inc.elements['description']
+    includes << [inc.attributes['filename'],
+                 description.nil? ? nil : (text_of(description) || '')]
+  end
+
+  index = $elements.size
+  $elements << nil
+
+  # Children are added depth first, so their indices are collected before
+  # this element's ranges are recorded.
+  child_indices = child_xml.map { |child| add_element(child, pathname) }
+
+  first_attribute = $attributes.size
+  $attributes.concat(attributes)
+  first_include = $includes.size
+  $includes.concat(includes)
+  first_child = $children.size
+  $children.concat(child_indices)
+
+  $elements[index] = {
+    name: name, required: required, ref: xml.attributes['ref'],
+    type: type, default: default,
+    min: xml.attributes['min'], max: xml.attributes['max'],
+    description: text_of(xml.elements['description']) || '',
+    copy_data: copy_data,
+    attributes: [first_attribute, attributes.size],
+    children: [first_child, child_indices.size],
+    includes: [first_include, includes.size]
+  }
+  index
+end
+
+specs = []
+supportedSdfVersions.each do |version|
+  Dir.glob("#{version}/*.sdf").sort.each do |pathname|
+    doc = REXML::Document.new(File.read(pathname))
+    root = doc.elements['element']
+    raise "#{pathname}: could not find the 'element' element" if root.nil?
+    specs << [pathname, add_element(root, pathname)]
+  end
+end
+specs.sort_by! { |spec| spec[0] }
+
+puts %q!
+#include "EmbeddedSdf.hh"
+
+namespace sdf {
+inline namespace SDF_VERSION_NAMESPACE {
+
+namespace {
+!
+
+# Arrays can't be empty, so each table ends with an unused entry.
+puts 'constexpr EmbeddedSdfAttribute kAttributes[] = {'
+$attributes.each do |a|
+  puts "{#{a.map { |s| literal(s) }.join(', ')}},"
+end
+puts '{nullptr, nullptr, nullptr, nullptr, nullptr}};'
+
+puts 'constexpr EmbeddedSdfInclude kIncludes[] = {'
+$includes.each do |i|
+  puts "{#{literal(i[0])}, #{literal(i[1])}},"
+end
+puts '{nullptr, nullptr}};'
+
+puts 'constexpr std::size_t kChildren[] = {'
+$children.each_slice(16) { |slice| puts "#{slice.join(', ')}," }
+puts '0};'
+
+puts 'constexpr EmbeddedSdfElement kElements[] = {'
+$elements.each do |e|
+  puts "{#{literal(e[:name])}, #{literal(e[:required])}, " \
+       "#{literal(e[:ref])}, #{literal(e[:type])}, " \
+       "#{literal(e[:default])}, #{literal(e[:min])}, #{literal(e[:max])}, " \
+       "#{literal(e[:description])}, #{e[:copy_data]}, " \
+       "#{e[:attributes].join(', ')}, #{e[:children].join(', ')}, " \
+       "#{e[:includes].join(', ')}},"
+end
+puts '};'
+
+puts 'constexpr EmbeddedSdfSpec kSpecs[] = {'
+specs.each do |spec|
+  puts "{#{literal(spec[0])}, #{spec[1]}},"
+end
+puts '};'
+
+puts %q!}
+
+/////////////////////////////////////////////////
+const EmbeddedSdfSchema &GetEmbeddedSdfSchema()
+{
+  static constexpr EmbeddedSdfSchema schema{
+    kSpecs, sizeof(kSpecs) / sizeof(kSpecs[0]),
+    kElements, kAttributes, kIncludes, kChildren};
+  return schema;
+}
+
+}
+}
+!
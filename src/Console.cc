@@ -15,6 +15,7 @@
  *
  */
 
+#include <atomic>
 #include <cstdlib>
 #include <memory>
 #include <mutex>
@@ -34,9 +35,9 @@ static std::mutex g_instance_mutex;
 /// \todo Output disabled for windows, to allow tests to pass. We should
 /// disable output just for tests on windows.
 #ifndef _WIN32
-static bool g_quiet = false;
+static std::atomic<bool> g_quiet = false;
 #else
-static bool g_quiet = true;
+static std::atomic<bool> g_quiet = true;
 #endif
 
 static Console::ConsoleStream g_NullStream(nullptr);
@@ -151,9 +152,11 @@ void Console::ConsoleStream::Prefix(const std::string &_lbl,
 #endif
   }
 
-  if (Console::Instance()->dataPtr->logFileStream.is_open())
+  ConsolePtr console = Console::Instance();
+  std::lock_guard<std::mutex> lock(console->dataPtr->logFileMutex);
+  if (console->dataPtr->logFileStream.is_open())
   {
-    Console::Instance()->dataPtr->logFileStream << _lbl << " [" <<
+    console->dataPtr->logFileStream << _lbl << " [" <<
       _file.substr(index , _file.size() - index)<< ":" << _line << "] ";
   }
 }
@@ -66,7 +66,23 @@ void Element::SetParent(const ElementPtr _parent)
 /////////////////////////////////////////////////
 void Element::SetName(const std::string &_name)
 {
+  if (this->dataPtr->name == _name)
+  {
+    return;
+  }
+
   this->dataPtr->name = _name;
+
+  // The element this was added to indexes its children by name. Elements
+  // are usually named before they are added, so a full search isn't worth
+  // it here.
+  auto container = this->dataPtr->container.lock();
+  if (container &&
+      this->dataPtr->position < container->dataPtr->elements.size() &&
+      container->dataPtr->elements[this->dataPtr->position].get() == this)
+  {
+    container->IndexChildren();
+  }
 }
 
 /////////////////////////////////////////////////
@@ -176,18 +192,17 @@ ElementPtr Element::Clone() const
     clone->dataPtr->attributes.push_back((*aiter)->Clone());
   }
 
-  ElementPtr_V::const_iterator eiter;
-  for (eiter = this->dataPtr->elementDescriptions.begin();
-      eiter != this->dataPtr->elementDescriptions.end(); ++eiter)
-  {
-    clone->dataPtr->elementDescriptions.push_back((*eiter)->Clone());
-  }
+  // Element descriptions are immutable, so they are shared with the clone
+  clone->dataPtr->elementDescriptions = this->dataPtr->elementDescriptions;
 
+  ElementPtr_V::const_iterator eiter;
+  clone->dataPtr->elements.reserve(this->dataPtr->elements.size());
   for (eiter = this->dataPtr->elements.begin();
        eiter != this->dataPtr->elements.end(); ++eiter)
   {
-    clone->dataPtr->elements.push_back((*eiter)->Clone());
-    clone->dataPtr->elements.back()->SetParent(clone);
+    ElementPtr elem = (*eiter)->Clone();
+    elem->SetParent(clone);
+    clone->AppendChild(elem);
   }
 
   if (this->dataPtr->value)
@@ -201,7 +216,7 @@ ElementPtr Element::Clone() const
 /////////////////////////////////////////////////
 void Element::Copy(const ElementPtr _elem)
 {
-  this->dataPtr->name = _elem->GetName();
+  this->SetName(_elem->GetName());
   this->dataPtr->description = _elem->GetDescription();
   this->dataPtr->required = _elem->GetRequired();
   this->dataPtr->copyChildren = _elem->GetCopyChildren();
@@ -233,22 +248,17 @@ void Element::Copy(const ElementPtr _elem)
     }
   }
 
-  this->dataPtr->elementDescriptions.clear();
-  for (ElementPtr_V::const_iterator iter =
-       _elem->dataPtr->elementDescriptions.begin();
-       iter != _elem->dataPtr->elementDescriptions.end(); ++iter)
-  {
-    this->dataPtr->elementDescriptions.push_back((*iter)->Clone());
-  }
+  this->dataPtr->elementDescriptions = _elem->dataPtr->elementDescriptions;
 
   this->dataPtr->elements.clear();
+  this->dataPtr->childIndex.clear();
   for (ElementPtr_V::iterator iter = _elem->dataPtr->elements.begin();
        iter != _elem->dataPtr->elements.end(); ++iter)
   {
     ElementPtr elem = (*iter)->Clone();
     elem->Copy(*iter);
     elem->SetParent(shared_from_this());
-    this->dataPtr->elements.push_back(elem);
+    this->AppendChild(elem);
   }
 }
 
@@ -308,11 +318,9 @@ void Element::PrintDescription(const std::string &_prefix) const
               << "' required ='*'/>\n";
   }
 
-  ElementPtr_V::iterator eiter;
-  for (eiter = this->dataPtr->elementDescriptions.begin();
-      eiter != this->dataPtr->elementDescriptions.end(); ++eiter)
+  for (unsigned int i = 0; i < this->GetElementDescriptionCount(); ++i)
   {
-    (*eiter)->PrintDescription(_prefix + "  ");
+    this->GetElementDescription(i)->PrintDescription(_prefix + "  ");
   }
 
   std::cout << _prefix << "</element>\n";
@@ -323,15 +331,14 @@ void Element::PrintDocRightPane(std::string &_html, int _spacing,
                                 int &_index) const
 {
   std::ostringstream stream;
-  ElementPtr_V::iterator eiter;
 
   int start = _index++;
 
   std::string childHTML;
-  for (eiter = this->dataPtr->elementDescriptions.begin();
-      eiter != this->dataPtr->elementDescriptions.end(); ++eiter)
+  for (unsigned int i = 0; i < this->GetElementDescriptionCount(); ++i)
   {
-    (*eiter)->PrintDocRightPane(childHTML, _spacing + 4, _index);
+    this->GetElementDescription(i)->PrintDocRightPane(
+        childHTML, _spacing + 4, _index);
   }
 
   stream << "<a name=\"" << this->dataPtr->name << start
@@ -419,15 +426,14 @@ void Element::PrintDocLeftPane(std::string &_html, int _spacing,
                                int &_index) const
 {
   std::ostringstream stream;
-  ElementPtr_V::iterator eiter;
 
   int start = _index++;
 
   std::string childHTML;
-  for (eiter = this->dataPtr->elementDescriptions.begin();
-      eiter != this->dataPtr->elementDescriptions.end(); ++eiter)
+  for (unsigned int i = 0; i < this->GetElementDescriptionCount(); ++i)
   {
-    (*eiter)->PrintDocLeftPane(childHTML, _spacing + 4, _index);
+    this->GetElementDescription(i)->PrintDocLeftPane(
+        childHTML, _spacing + 4, _index);
   }
 
   stream << "<a id='" << start << "' onclick='highlight(" << start
@@ -573,16 +579,20 @@ ParamPtr Element::GetAttribute(unsigned int _index) const
 /////////////////////////////////////////////////
 size_t Element::GetElementDescriptionCount() const
 {
-  return this->dataPtr->elementDescriptions.size();
+  if (!this->dataPtr->elementDescriptions)
+  {
+    return 0;
+  }
+  return this->dataPtr->elementDescriptions->elements.size();
 }
 
 /////////////////////////////////////////////////
 ElementPtr Element::GetElementDescription(unsigned int _index) const
 {
   ElementPtr result;
-  if (_index < this->dataPtr->elementDescriptions.size())
+  if (_index < this->GetElementDescriptionCount())
   {
-    result = this->dataPtr->elementDescriptions[_index];
+    result = this->dataPtr->elementDescriptions->elements[_index];
   }
   return result;
 }
@@ -590,13 +600,13 @@ ElementPtr Element::GetElementDescription(unsigned int _index) const
 /////////////////////////////////////////////////
 ElementPtr Element::GetElementDescription(const std::string &_key) const
 {
-  ElementPtr_V::const_iterator iter;
-  for (iter = this->dataPtr->elementDescriptions.begin();
-       iter != this->dataPtr->elementDescriptions.end(); ++iter)
+  if (this->dataPtr->elementDescriptions)
   {
-    if ((*iter)->GetName() == _key)
+    const auto &descriptions = *this->dataPtr->elementDescriptions;
+    auto iter = descriptions.index.find(_key);
+    if (iter != descriptions.index.end())
     {
-      return (*iter);
+      return descriptions.elements[iter->second];
     }
   }
 
@@ -618,17 +628,13 @@ bool Element::HasElement(const std::string &_name) const
 /////////////////////////////////////////////////
 ElementPtr Element::GetElementImpl(const std::string &_name) const
 {
-  ElementPtr_V::const_iterator iter;
-  for (iter = this->dataPtr->elements.begin();
-       iter != this->dataPtr->elements.end(); ++iter)
+  auto iter = this->dataPtr->childIndex.find(_name);
+  if (iter == this->dataPtr->childIndex.end() || iter->second.empty())
   {
-    if ((*iter)->GetName() == _name)
-    {
-      return (*iter);
-    }
+    return ElementPtr();
   }
 
-  return ElementPtr();
+  return this->dataPtr->elements[iter->second.front()];
 }
 
 /////////////////////////////////////////////////
@@ -648,39 +654,115 @@ ElementPtr Element::GetFirstElement() const
 ElementPtr Element::GetNextElement(const std::string &_name) const
 {
   auto parent = this->dataPtr->parent.lock();
-  if (parent)
+  if (!parent)
   {
-    ElementPtr_V::const_iterator iter;
-    iter = std::find(parent->dataPtr->elements.begin(),
-        parent->dataPtr->elements.end(), shared_from_this());
+    return ElementPtr();
+  }
 
-    if (iter == parent->dataPtr->elements.end())
-    {
-      return ElementPtr();
-    }
+  const ElementPtr_V &siblings = parent->dataPtr->elements;
+  const std::size_t position = parent->ChildPosition(this);
+  if (position >= siblings.size())
+  {
+    return ElementPtr();
+  }
 
-    ++iter;
-    if (iter == parent->dataPtr->elements.end())
-    {
-      return ElementPtr();
-    }
-    else if (_name.empty())
-    {
-      return *(iter);
-    }
-    else
+  if (_name.empty())
+  {
+    return position + 1 < siblings.size() ? siblings[position + 1] :
+        ElementPtr();
+  }
+
+  auto iter = parent->dataPtr->childIndex.find(_name);
+  if (iter == parent->dataPtr->childIndex.end())
+  {
+    return ElementPtr();
+  }
+  const std::vector<std::size_t> &positions = iter->second;
+
+  // Siblings with the same name are usually iterated, in which case the
+  // next one follows this element in the index.
+  std::size_t next;
+  if (_name == this->dataPtr->name &&
+      this->dataPtr->namePosition < positions.size() &&
+      positions[this->dataPtr->namePosition] == position)
+  {
+    next = this->dataPtr->namePosition + 1;
+  }
+  else
+  {
+    next = static_cast<std::size_t>(std::upper_bound(positions.begin(),
+        positions.end(), position) - positions.begin());
+  }
+
+  return next < positions.size() ? siblings[positions[next]] : ElementPtr();
+}
+
+/////////////////////////////////////////////////
+ElementPtr_V Element::Children(const std::string &_name) const
+{
+  if (_name.empty())
+  {
+    return this->dataPtr->elements;
+  }
+
+  ElementPtr_V result;
+  auto iter = this->dataPtr->childIndex.find(_name);
+  if (iter != this->dataPtr->childIndex.end())
+  {
+    result.reserve(iter->second.size());
+    for (std::size_t position : iter->second)
     {
-      for (; iter != parent->dataPtr->elements.end(); ++iter)
-      {
-        if ((*iter)->GetName() == _name)
-        {
-          return (*iter);
-        }
-      }
+      result.push_back(this->dataPtr->elements[position]);
     }
   }
+  return result;
+}
 
-  return ElementPtr();
+/////////////////////////////////////////////////
+void Element::AppendChild(const ElementPtr &_child)
+{
+  std::vector<std::size_t> &positions =
+      this->dataPtr->childIndex[_child->dataPtr->name];
+  _child->dataPtr->container = this->weak_from_this();
+  _child->dataPtr->position = this->dataPtr->elements.size();
+  _child->dataPtr->namePosition = positions.size();
+  positions.push_back(this->dataPtr->elements.size());
+  this->dataPtr->elements.push_back(_child);
+}
+
+/////////////////////////////////////////////////
+void Element::IndexChildren()
+{
+  this->dataPtr->childIndex.clear();
+  for (std::size_t i = 0; i < this->dataPtr->elements.size(); ++i)
+  {
+    Element &child = *this->dataPtr->elements[i];
+    std::vector<std::size_t> &positions =
+        this->dataPtr->childIndex[child.dataPtr->name];
+    child.dataPtr->container = this->weak_from_this();
+    child.dataPtr->position = i;
+    child.dataPtr->namePosition = positions.size();
+    positions.push_back(i);
+  }
+}
+
+/////////////////////////////////////////////////
+std::size_t Element::ChildPosition(const Element *_child) const
+{
+  const ElementPtr_V &elements = this->dataPtr->elements;
+  const std::size_t position = _child->dataPtr->position;
+  if (position < elements.size() && elements[position].get() == _child)
+  {
+    return position;
+  }
+
+  // The element was added to another element after this one
+  auto iter = std::find_if(elements.begin(), elements.end(),
+      [_child](const ElementPtr &_elem)
+      {
+        return _elem.get() == _child;
+      });
+  return static_cast<std::size_t>(iter - elements.begin());
 }
 
 /////////////////////////////////////////////////
@@ -766,7 +848,7 @@ ElementPtr Element::GetElement(const std::string &_name)
 /////////////////////////////////////////////////
 void Element::InsertElement(ElementPtr _elem)
 {
-  this->dataPtr->elements.push_back(_elem);
+  this->AppendChild(_elem);
 }
 
 /////////////////////////////////////////////////
@@ -782,39 +864,31 @@ ElementPtr Element::AddElement(const std::string &_name)
   // descriptions then get them from its parent
   auto parent = this->dataPtr->parent.lock();
   if (!this->dataPtr->referenceSDF.empty() &&
-      this->dataPtr->elementDescriptions.empty() && parent &&
+      this->GetElementDescriptionCount() == 0 && parent &&
       parent->GetName() == this->dataPtr->name)
   {
-    for (unsigned int i = 0; i < parent->GetElementDescriptionCount(); ++i)
-    {
-      this->dataPtr->elementDescriptions.push_back(
-          parent->GetElementDescription(i)->Clone());
-    }
+    this->dataPtr->elementDescriptions = parent->dataPtr->elementDescriptions;
   }
 
-  ElementPtr_V::const_iterator iter, iter2;
-  for (iter = this->dataPtr->elementDescriptions.begin();
-      iter != this->dataPtr->elementDescriptions.end(); ++iter)
+  ElementPtr desc = this->GetElementDescription(_name);
+  if (desc)
   {
-    if ((*iter)->dataPtr->name == _name)
-    {
-      ElementPtr elem = (*iter)->Clone();
-      elem->SetParent(shared_from_this());
-      this->dataPtr->elements.push_back(elem);
+    ElementPtr elem = desc->Clone();
+    elem->SetParent(shared_from_this());
+    this->AppendChild(elem);
 
-      // Add all child elements.
-      for (iter2 = elem->dataPtr->elementDescriptions.begin();
-           iter2 != elem->dataPtr->elementDescriptions.end(); ++iter2)
+    // Add all child elements.
+    for (unsigned int i = 0; i < elem->GetElementDescriptionCount(); ++i)
+    {
+      // Add only required child element
+      ElementPtr childDesc = elem->GetElementDescription(i);
+      if (childDesc->GetRequired() == "1")
       {
-        // Add only required child element
-        if ((*iter2)->GetRequired() == "1")
-        {
-          elem->AddElement((*iter2)->dataPtr->name);
-        }
+        elem->AddElement(childDesc->dataPtr->name);
       }
-
-      return this->dataPtr->elements.back();
     }
+
+    return this->dataPtr->elements.back();
   }
 
   sdferr << "Missing element description for [" << _name << "]\n";
@@ -839,6 +913,7 @@ void Element::ClearElements()
   }
 
   this->dataPtr->elements.clear();
+  this->dataPtr->childIndex.clear();
 }
 
 /////////////////////////////////////////////////
@@ -874,18 +949,12 @@ void Element::Reset()
     }
     (*iter).reset();
   }
-
-  for (ElementPtr_V::iterator iter = this->dataPtr->elementDescriptions.begin();
-      iter != this->dataPtr->elementDescriptions.end(); ++iter)
-  {
-    if (*iter)
-    {
-      (*iter)->Reset();
-    }
-    (*iter).reset();
-  }
   this->dataPtr->elements.clear();
-  this->dataPtr->elementDescriptions.clear();
+  this->dataPtr->childIndex.clear();
+
+  // Element descriptions may be shared with other elements, so only release
+  // this element's reference to them.
+  this->dataPtr->elementDescriptions.reset();
 
   this->dataPtr->value.reset();
 
@@ -895,7 +964,21 @@ void Element::Reset()
 /////////////////////////////////////////////////
 void Element::AddElementDescription(ElementPtr _elem)
 {
-  this->dataPtr->elementDescriptions.push_back(_elem);
+  auto &descriptions = this->dataPtr->elementDescriptions;
+  if (!descriptions)
+  {
+    descriptions = std::make_shared<ElementDescriptions>();
+  }
+  else if (descriptions.use_count() > 1)
+  {
+    // Copy on write, since the descriptions are shared with another element
+    descriptions = std::make_shared<ElementDescriptions>(*descriptions);
+  }
+
+  // Only the first description with a given name is indexed, which matches
+  // the first-match behavior of a linear search.
+  descriptions->index.emplace(_elem->GetName(), descriptions->elements.size());
+  descriptions->elements.push_back(_elem);
 }
 
 /////////////////////////////////////////////////
@@ -952,13 +1035,12 @@ void Element::RemoveFromParent()
   auto parent = this->dataPtr->parent.lock();
   if (parent)
   {
-    ElementPtr_V::iterator iter;
-    iter = std::find(parent->dataPtr->elements.begin(),
-        parent->dataPtr->elements.end(), shared_from_this());
-
-    if (iter != parent->dataPtr->elements.end())
+    const std::size_t position = parent->ChildPosition(this);
+    if (position < parent->dataPtr->elements.size())
     {
-      parent->dataPtr->elements.erase(iter);
+      parent->dataPtr->elements.erase(
+          parent->dataPtr->elements.begin() + position);
+      parent->IndexChildren();
       parent.reset();
     }
   }
@@ -977,6 +1059,7 @@ void Element::RemoveChild(ElementPtr _child)
   {
     _child->SetParent(ElementPtr());
     this->dataPtr->elements.erase(iter);
+    this->IndexChildren();
   }
 }
 
@@ -15,6 +15,9 @@
  *
  */
 
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "sdf/Element.hh"
@@ -236,6 +239,65 @@ TEST(Element, AddElementReferenceSDF)
   ASSERT_EQ(child->GetAttributeCount(), 0UL);
 }
 
+/////////////////////////////////////////////////
+TEST(Element, GetElementDescriptionByName)
+{
+  sdf::ElementPtr parent = std::make_shared<sdf::Element>();
+  parent->SetName("parent");
+
+  for (const std::string &name : {"a", "b", "c", "b"})
+  {
+    sdf::ElementPtr desc = std::make_shared<sdf::Element>();
+    desc->SetName(name);
+    desc->SetDescription(name + std::to_string(
+        parent->GetElementDescriptionCount()));
+    parent->AddElementDescription(desc);
+  }
+  ASSERT_EQ(4UL, parent->GetElementDescriptionCount());
+
+  EXPECT_TRUE(parent->HasElementDescription("a"));
+  EXPECT_TRUE(parent->HasElementDescription("c"));
+  EXPECT_FALSE(parent->HasElementDescription("d"));
+
+  // The first description with a given name wins
+  sdf::ElementPtr desc = parent->GetElementDescription("b");
+  ASSERT_NE(nullptr, desc);
+  EXPECT_EQ("b1", desc->GetDescription());
+  EXPECT_EQ(parent->GetElementDescription(1), desc);
+
+  // The lookup survives Clone and Copy
+  sdf::ElementPtr clone = parent->Clone();
+  ASSERT_NE(nullptr, clone->GetElementDescription("c"));
+  EXPECT_EQ("c2", clone->GetElementDescription("c")->GetDescription());
+  ASSERT_NE(nullptr, clone->AddElement("c"));
+  EXPECT_TRUE(clone->HasElement("c"));
+
+  sdf::ElementPtr copy = std::make_shared<sdf::Element>();
+  copy->Copy(parent);
+  ASSERT_NE(nullptr, copy->GetElementDescription("a"));
+  EXPECT_EQ("a0", copy->GetElementDescription("a")->GetDescription());
+  EXPECT_EQ("b1", copy->GetElementDescription("b")->GetDescription());
+
+  // Clones share descriptions until one of them adds a description
+  EXPECT_EQ(parent->GetElementDescription("a"),
+            clone->GetElementDescription("a"));
+  sdf::ElementPtr extra = std::make_shared<sdf::Element>();
+  extra->SetName("d");
+  clone->AddElementDescription(extra);
+  EXPECT_EQ(5UL, clone->GetElementDescriptionCount());
+  EXPECT_TRUE(clone->HasElementDescription("d"));
+  EXPECT_EQ(4UL, parent->GetElementDescriptionCount());
+  EXPECT_FALSE(parent->HasElementDescription("d"));
+  EXPECT_EQ(parent->GetElementDescription("a"),
+            clone->GetElementDescription("a"));
+
+  // Reset removes all descriptions without affecting other elements
+  parent->Reset();
+  EXPECT_EQ(0UL, parent->GetElementDescriptionCount());
+  EXPECT_FALSE(parent->HasElementDescription("a"));
+  EXPECT_TRUE(copy->HasElementDescription("a"));
+}
+
 /////////////////////////////////////////////////
 TEST(Element, GetTemplates)
 {
@@ -629,6 +691,117 @@ TEST(Element, GetNextElementMultiple)
   ASSERT_EQ(child2->GetNextElement(""), nullptr);
 }
 
+/////////////////////////////////////////////////
+TEST(Element, GetNextElementByName)
+{
+  sdf::ElementPtr parent = std::make_shared<sdf::Element>();
+  std::vector<sdf::ElementPtr> children;
+  for (const std::string name : {"a", "b", "a", "c", "b", "a"})
+  {
+    sdf::ElementPtr child = std::make_shared<sdf::Element>();
+    child->SetName(name);
+    child->SetParent(parent);
+    parent->InsertElement(child);
+    children.push_back(child);
+  }
+
+  EXPECT_TRUE(parent->HasElement("a"));
+  EXPECT_TRUE(parent->HasElement("c"));
+  EXPECT_FALSE(parent->HasElement("d"));
+  EXPECT_EQ(children[1], parent->GetElementImpl("b"));
+  EXPECT_EQ(nullptr, parent->GetElementImpl("d"));
+
+  // Same name as the current element
+  EXPECT_EQ(children[2], children[0]->GetNextElement("a"));
+  EXPECT_EQ(children[5], children[2]->GetNextElement("a"));
+  EXPECT_EQ(nullptr, children[5]->GetNextElement("a"));
+
+  // Different name than the current element
+  EXPECT_EQ(children[4], children[2]->GetNextElement("b"));
+  EXPECT_EQ(children[3], children[0]->GetNextElement("c"));
+  EXPECT_EQ(nullptr, children[4]->GetNextElement("c"));
+  EXPECT_EQ(nullptr, children[0]->GetNextElement("d"));
+
+  // Any name
+  EXPECT_EQ(children[1], children[0]->GetNextElement());
+  EXPECT_EQ(nullptr, children[5]->GetNextElement());
+
+  // Removing children updates the index
+  parent->RemoveChild(children[2]);
+  EXPECT_EQ(children[5], children[0]->GetNextElement("a"));
+  EXPECT_EQ(nullptr, children[2]->GetNextElement("a"));
+  children[0]->RemoveFromParent();
+  EXPECT_EQ(children[5], parent->GetElementImpl("a"));
+
+  // Renaming a child updates the index
+  children[3]->SetName("a");
+  EXPECT_EQ(children[3], parent->GetElementImpl("a"));
+  EXPECT_EQ(children[5], children[3]->GetNextElement("a"));
+  EXPECT_FALSE(parent->HasElement("c"));
+
+  // Copying an element into a child renames it in the index
+  sdf::ElementPtr source = std::make_shared<sdf::Element>();
+  source->SetName("e");
+  children[4]->Copy(source);
+  EXPECT_EQ("e", children[4]->GetName());
+  EXPECT_EQ(children[4], parent->GetElementImpl("e"));
+  EXPECT_EQ(nullptr, children[1]->GetNextElement("b"));
+
+  // Renaming an element added to an element other than its parent updates
+  // the index of the element it was added to
+  sdf::ElementPtr other = std::make_shared<sdf::Element>();
+  sdf::ElementPtr inserted = std::make_shared<sdf::Element>();
+  inserted->SetName("f");
+  inserted->SetParent(parent);
+  other->InsertElement(inserted);
+  inserted->SetName("g");
+  EXPECT_EQ(inserted, other->GetElementImpl("g"));
+  EXPECT_FALSE(other->HasElement("f"));
+
+  // Clones have their own index
+  sdf::ElementPtr clone = parent->Clone();
+  sdf::ElementPtr cloneA = clone->GetElementImpl("a");
+  ASSERT_NE(nullptr, cloneA);
+  EXPECT_NE(children[3], cloneA);
+  ASSERT_NE(nullptr, cloneA->GetNextElement("a"));
+  EXPECT_EQ(nullptr, cloneA->GetNextElement("a")->GetNextElement("a"));
+
+  parent->ClearElements();
+  EXPECT_FALSE(parent->HasElement("a"));
+  EXPECT_EQ(nullptr, children[5]->GetNextElement("a"));
+}
+
+/////////////////////////////////////////////////
+TEST(Element, Children)
+{
+  sdf::ElementPtr parent = std::make_shared<sdf::Element>();
+  EXPECT_TRUE(parent->Children().empty());
+  EXPECT_TRUE(parent->Children("a").empty());
+
+  std::vector<sdf::ElementPtr> children;
+  for (const std::string name : {"a", "b", "a"})
+  {
+    sdf::ElementPtr child = std::make_shared<sdf::Element>();
+    child->SetName(name);
+    child->SetParent(parent);
+    parent->InsertElement(child);
+    children.push_back(child);
+  }
+
+  EXPECT_EQ(children, parent->Children());
+  EXPECT_EQ(sdf::ElementPtr_V({children[0], children[2]}),
+            parent->Children("a"));
+  EXPECT_EQ(sdf::ElementPtr_V({children[1]}), parent->Children("b"));
+  EXPECT_TRUE(parent->Children("c").empty());
+
+  // Children can be removed while iterating
+  for (sdf::ElementPtr child : parent->Children("a"))
+  {
+    parent->RemoveChild(child);
+  }
+  EXPECT_EQ(sdf::ElementPtr_V({children[1]}), parent->Children());
+}
+
 /////////////////////////////////////////////////
 TEST(Element, CountNamedElements)
 {
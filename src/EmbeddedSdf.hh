@@ -18,6 +18,7 @@
 #ifndef SDF_EMBEDDEDSDF_HH_
 #define SDF_EMBEDDEDSDF_HH_
 
+#include <cstddef>
 #include <map>
 #include <string>
 
@@ -35,6 +36,132 @@ namespace sdf
   /// directory such as "1.8/root.sdf", and the values are the contents of
   /// that source file.
   const std::map<std::string, std::string> &GetEmbeddedSdf();
+
+  /// \internal
+  /// \brief An attribute of an element in the generated spec tables.
+  struct EmbeddedSdfAttribute
+  {
+    /// \brief Name of the attribute.
+    const char *name;
+
+    /// \brief Type of the attribute, such as "string".
+    const char *type;
+
+    /// \brief Default value of the attribute.
+    const char *defaultValue;
+
+    /// \brief Required string of the attribute, such as "1".
+    const char *required;
+
+    /// \brief Description of the attribute.
+    const char *description;
+  };
+
+  /// \internal
+  /// \brief An <include> of another spec file in the generated spec tables.
+  struct EmbeddedSdfInclude
+  {
+    /// \brief Name of the included spec file, such as "link.sdf".
+    const char *filename;
+
+    /// \brief Description that overrides the description of the included
+    /// element, or nullptr if it is not overridden.
+    const char *description;
+  };
+
+  /// \internal
+  /// \brief An element description in the generated spec tables. The
+  /// attributes, child elements and includes of an element are stored as
+  /// ranges of the corresponding tables in EmbeddedSdfSchema.
+  struct EmbeddedSdfElement
+  {
+    /// \brief Name of the element.
+    const char *name;
+
+    /// \brief Required string of the element, such as "0" or "*".
+    const char *required;
+
+    /// \brief Name of the referenced spec, or nullptr if there is none.
+    const char *ref;
+
+    /// \brief Type of the element's value, or nullptr if it has no value.
+    const char *type;
+
+    /// \brief Default value, or nullptr if the element has no value.
+    const char *defaultValue;
+
+    /// \brief Minimum value, or nullptr if there is none.
+    const char *minValue;
+
+    /// \brief Maximum value, or nullptr if there is none.
+    const char *maxValue;
+
+    /// \brief Description of the element.
+    const char *description;
+
+    /// \brief True if unknown child elements should be copied.
+    bool copyData;
+
+    /// \brief Index of the first attribute in EmbeddedSdfSchema::attributes.
+    std::size_t firstAttribute;
+
+    /// \brief Number of attributes.
+    std::size_t attributeCount;
+
+    /// \brief Index of the first child in EmbeddedSdfSchema::children.
+    std::size_t firstChild;
+
+    /// \brief Number of child elements.
+    std::size_t childCount;
+
+    /// \brief Index of the first include in EmbeddedSdfSchema::includes.
+    std::size_t firstInclude;
+
+    /// \brief Number of includes.
+    std::size_t includeCount;
+  };
+
+  /// \internal
+  /// \brief The top level element of a spec file in the generated tables.
+  struct EmbeddedSdfSpec
+  {
+    /// \brief Source-relative pathname, such as "1.8/root.sdf".
+    const char *pathname;
+
+    /// \brief Index of the top level element in
+    /// EmbeddedSdfSchema::elements.
+    std::size_t element;
+  };
+
+  /// \internal
+  /// \brief Element descriptions of all the embedded spec files, generated
+  /// at build time by sdf/embedSdfSchema.rb.
+  struct EmbeddedSdfSchema
+  {
+    /// \brief Spec files, sorted by pathname.
+    const EmbeddedSdfSpec *specs;
+
+    /// \brief Number of spec files.
+    std::size_t specCount;
+
+    /// \brief All element descriptions.
+    const EmbeddedSdfElement *elements;
+
+    /// \brief All attributes.
+    const EmbeddedSdfAttribute *attributes;
+
+    /// \brief All includes.
+    const EmbeddedSdfInclude *includes;
+
+    /// \brief Indices into elements of the child elements.
+    const std::size_t *children;
+  };
+
+  /// \internal
+  /// \brief Get the generated element descriptions of the embedded spec
+  /// files. These contain the same information as the files returned by
+  /// GetEmbeddedSdf, without the need to parse XML.
+  const EmbeddedSdfSchema &GetEmbeddedSdfSchema();
 }
 }
 #endif
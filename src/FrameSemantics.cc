@@ -14,6 +14,7 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
 #include <string>
 #include <utility>
 #include <vector>
@@ -28,142 +29,384 @@
 #include "sdf/World.hh"
 
 #include "FrameSemantics.hh"
+#include "PoseBatch.hh"
 
 namespace sdf
 {
 inline namespace SDF_VERSION_NAMESPACE {
 
-// The following two functions were originally submitted to ign-math,
-// but were not accepted as they were not generic enough.
-// For now, they will be kept here.
-// https://osrf-migration.github.io/ignition-gh-pages/#!/ignitionrobotics/ign-math/pull-requests/333
-
-/// \brief Starting from a given vertex in a directed graph, traverse edges
-/// in reverse direction to find a source vertex (has only outgoing edges).
-/// This function returns a NullVertex if a graph cycle is detected or
-/// if a vertex with multiple incoming edges is found.
-/// Otherwise, this function returns the first source Vertex that is found.
-/// It also returns the sequence of edges leading to the source vertex.
-/// \param[in] _graph A directed graph.
-/// \param[in] _id VertexId of the starting vertex.
-/// \return A source vertex paired with a vector of the edges leading the
-/// source to the starting vertex, or a NullVertex paired with an empty
-/// vector if a cycle or vertex with multiple incoming edges are detected.
-template<typename V, typename E>
-std::pair<const ignition::math::graph::Vertex<V> &,
-          std::vector< ignition::math::graph::DirectedEdge<E> > >
-FindSourceVertex(
-    const ignition::math::graph::DirectedGraph<V, E> &_graph,
-    const ignition::math::graph::VertexId _id,
-    Errors &_errors)
+/// \brief Build the flat tree of a frame graph.
+/// \param[in] _graph The frame graph.
+/// \param[in] _parentIsTail True if the parent of a vertex is the tail of
+/// its incoming edge, as in a PoseRelativeToGraph, or false if it's the head
+/// of its outgoing edge, as in a FrameAttachedToGraph.
+/// \param[out] _tree Tree to write.
+/// \param[out] _edgeData If not null, this is set to the data of the edge
+/// from each vertex to its parent.
+template<typename E>
+static void buildFrameTree(
+    const ignition::math::graph::DirectedGraph<FrameType, E> &_graph,
+    bool _parentIsTail,
+    FrameTree &_tree,
+    std::vector<E> *_edgeData)
 {
-  using DirectedEdge = ignition::math::graph::DirectedEdge<E>;
-  using Vertex = ignition::math::graph::Vertex<V>;
-  using VertexId = ignition::math::graph::VertexId;
-  using EdgesType = std::vector<DirectedEdge>;
-  using PairType = std::pair<const Vertex &, EdgesType>;
-  EdgesType edges;
-  std::reference_wrapper<const Vertex> vertex(_graph.VertexFromId(_id));
-  if (!vertex.get().Valid())
+  _tree = FrameTree();
+
+  // Vertices are stored in the order of their ids
+  std::unordered_map<ignition::math::graph::VertexId, std::size_t> indices;
+  const auto vertices = _graph.Vertices();
+  _tree.names.reserve(vertices.size());
+  _tree.types.reserve(vertices.size());
+  for (const auto &vertexPair : vertices)
+  {
+    const auto &vertex = vertexPair.second.get();
+    indices[vertexPair.first] = _tree.names.size();
+    _tree.index[vertex.Name()] = _tree.names.size();
+    _tree.names.push_back(vertex.Name());
+    _tree.types.push_back(vertex.Data());
+  }
+  _tree.parentCounts.assign(_tree.names.size(), 0);
+  _tree.parents.assign(_tree.names.size(), FrameTree::kNoParent);
+  _tree.parentEdges.assign(
+      _tree.names.size(), ignition::math::graph::kNullId);
+  if (_edgeData)
+  {
+    _edgeData->assign(_tree.names.size(), E());
+  }
+
+  for (const auto &edgePair : _graph.Edges())
+  {
+    const auto &edge = edgePair.second.get();
+    const std::size_t tail = indices.at(edge.Tail());
+    const std::size_t head = indices.at(edge.Head());
+    const std::size_t child = _parentIsTail ? head : tail;
+    const std::size_t parent = _parentIsTail ? tail : head;
+
+    ++_tree.parentCounts[child];
+    const bool single = _tree.parentCounts[child] == 1;
+    _tree.parents[child] = single ? parent : FrameTree::kNoParent;
+    _tree.parentEdges[child] =
+        single ? edge.Id() : ignition::math::graph::kNullId;
+    if (_edgeData)
+    {
+      (*_edgeData)[child] = edge.Data();
+    }
+  }
+
+  // Group the children by parent
+  _tree.childOffsets.assign(_tree.names.size() + 1, 0);
+  for (std::size_t parent : _tree.parents)
+  {
+    if (parent != FrameTree::kNoParent)
+    {
+      ++_tree.childOffsets[parent + 1];
+    }
+  }
+  for (std::size_t i = 1; i < _tree.childOffsets.size(); ++i)
   {
-    _errors.push_back({ErrorCode::POSE_RELATIVE_TO_INVALID,
-        "Unable to resolve pose, invalid vertex[" + std::to_string(_id) + "] "
-        "in PoseRelativeToGraph."});
-    return PairType(Vertex::NullVertex, EdgesType());
+    _tree.childOffsets[i] += _tree.childOffsets[i - 1];
   }
+  _tree.children.resize(_tree.childOffsets.back());
+  std::vector<std::size_t> next(
+      _tree.childOffsets.begin(), _tree.childOffsets.end() - 1);
+  for (std::size_t i = 0; i < _tree.parents.size(); ++i)
+  {
+    if (_tree.parents[i] != FrameTree::kNoParent)
+    {
+      _tree.children[next[_tree.parents[i]]++] = i;
+    }
+  }
+}
 
-  std::set<VertexId> visited;
-  visited.insert(vertex.get().Id());
+/// \brief Starting from a given vertex of a frame tree, follow the parents
+/// until a vertex without parents is found, or until a vertex is visited
+/// twice. The vertices are followed by two walkers, one twice as fast as the
+/// other, so that cycles are detected without keeping track of the visited
+/// vertices.
+/// \param[in] _tree The frame tree.
+/// \param[in] _index Index of the starting vertex.
+/// \return Index of the vertex where the walk stopped: the vertex without
+/// parents, or the first vertex that is visited twice.
+static std::size_t findTreeStop(
+    const FrameTree &_tree,
+    const std::size_t _index)
+{
+  std::size_t slow = _index;
+  std::size_t fast = _index;
+  while (true)
+  {
+    for (int i = 0; i < 2; ++i)
+    {
+      if (_tree.parents[fast] == FrameTree::kNoParent)
+      {
+        return fast;
+      }
+      fast = _tree.parents[fast];
+    }
 
-  auto incidentsTo = _graph.IncidentsTo(vertex);
-  while (!incidentsTo.empty())
+    slow = _tree.parents[slow];
+    if (slow == fast)
+    {
+      break;
+    }
+  }
+
+  // The walkers met in a cycle. The first vertex that is visited twice is
+  // where the path from the starting vertex enters the cycle.
+  slow = _index;
+  while (slow != fast)
   {
-    if (incidentsTo.size() != 1)
+    slow = _tree.parents[slow];
+    fast = _tree.parents[fast];
+  }
+  return slow;
+}
+
+/// \brief Find where the walk from each vertex of a frame tree to its root
+/// stops, as findTreeStop does, in a single pass. Each vertex is visited
+/// once, and marked while it is on the current path so that cycles are
+/// detected when the path reaches a marked vertex.
+/// \param[in] _tree The frame tree.
+/// \param[out] _stops Index of the vertex where the walk from each vertex
+/// stops.
+static void findTreeStops(
+    const FrameTree &_tree,
+    std::vector<std::size_t> &_stops)
+{
+  enum class Colour : unsigned char
+  {
+    /// \brief Not visited yet.
+    WHITE,
+    /// \brief On the current path.
+    GRAY,
+    /// \brief Where the walk stops is known.
+    BLACK
+  };
+
+  const std::size_t count = _tree.names.size();
+  std::vector<Colour> colours(count, Colour::WHITE);
+  std::vector<bool> onCycle(count, false);
+  _stops.assign(count, FrameTree::kNoParent);
+
+  std::vector<std::size_t> path;
+  for (std::size_t start = 0; start < count; ++start)
+  {
+    path.clear();
+    std::size_t vertex = start;
+    while (colours[vertex] == Colour::WHITE &&
+           _tree.parents[vertex] != FrameTree::kNoParent)
+    {
+      colours[vertex] = Colour::GRAY;
+      path.push_back(vertex);
+      vertex = _tree.parents[vertex];
+    }
+
+    std::size_t stop = vertex;
+    if (colours[vertex] == Colour::GRAY)
     {
-      _errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
-          "PoseRelativeToGraph error: multiple incoming edges to "
-          "current vertex [" + vertex.get().Name() + "]."});
-      return PairType(Vertex::NullVertex, EdgesType());
+      // The path closed a cycle. A walk from a vertex in the cycle stops
+      // where it started, and a walk from a vertex before the cycle stops
+      // where it enters the cycle.
+      auto cycleStart = std::find(path.begin(), path.end(), vertex);
+      for (auto iter = cycleStart; iter != path.end(); ++iter)
+      {
+        _stops[*iter] = *iter;
+        onCycle[*iter] = true;
+        colours[*iter] = Colour::BLACK;
+      }
+      path.erase(cycleStart, path.end());
     }
-    auto const &edge = incidentsTo.begin()->second;
-    vertex = _graph.VertexFromId(edge.get().Vertices().first);
-    edges.push_back(edge);
-    if (visited.count(vertex.get().Id()))
+    else if (colours[vertex] == Colour::BLACK)
     {
-      _errors.push_back({ErrorCode::POSE_RELATIVE_TO_CYCLE,
-          "PoseRelativeToGraph cycle detected, already visited vertex [" +
-          vertex.get().Name() + "]."});
-      return PairType(Vertex::NullVertex, EdgesType());
+      stop = onCycle[vertex] ? vertex : _stops[vertex];
+    }
+    else
+    {
+      _stops[vertex] = vertex;
+      colours[vertex] = Colour::BLACK;
+    }
+
+    for (std::size_t pathVertex : path)
+    {
+      _stops[pathVertex] = stop;
+      colours[pathVertex] = Colour::BLACK;
     }
-    visited.insert(vertex.get().Id());
-    incidentsTo = _graph.IncidentsTo(vertex);
   }
+}
 
-  return PairType(vertex, edges);
+/// \brief Check the vertex where a walk towards the root of a frame tree
+/// stopped.
+/// \param[in] _tree The frame tree.
+/// \param[in] _stop Index of the vertex where the walk stopped.
+/// \param[in] _graphName Name of the graph, for error messages.
+/// \param[in] _multipleCode Error code used if the vertex has multiple
+/// parents.
+/// \param[in] _multipleMessage Error message used if the vertex has
+/// multiple parents.
+/// \param[in] _cycleCode Error code used if the vertex is in a cycle.
+/// \param[out] _errors Errors that are found.
+/// \return _stop if it is a vertex without parents, or FrameTree::kNoParent
+/// if it is in a cycle or has multiple parents.
+static std::size_t checkTreeStop(
+    const FrameTree &_tree,
+    const std::size_t _stop,
+    const std::string &_graphName,
+    const ErrorCode _multipleCode,
+    const std::string &_multipleMessage,
+    const ErrorCode _cycleCode,
+    Errors &_errors)
+{
+  if (_tree.parentCounts[_stop] > 1)
+  {
+    _errors.push_back({_multipleCode, _graphName + " error: " +
+        _multipleMessage + " current vertex [" + _tree.names[_stop] + "]."});
+    return FrameTree::kNoParent;
+  }
+  else if (_tree.parents[_stop] != FrameTree::kNoParent)
+  {
+    _errors.push_back({_cycleCode, _graphName +
+        " cycle detected, already visited vertex [" + _tree.names[_stop] +
+        "]."});
+    return FrameTree::kNoParent;
+  }
+  return _stop;
+}
+
+/// \brief Starting from a given vertex of a PoseRelativeToGraph, follow the
+/// relative-to frames to find a source vertex (has no incoming edges).
+/// \param[in] _graph The graph.
+/// \param[in] _index Index of the starting vertex in the tree of the graph.
+/// \param[in] _stops If not null, where the walk from each vertex stops, as
+/// found by findTreeStops.
+/// \param[out] _errors Errors if a cycle or a vertex with multiple incoming
+/// edges is found.
+/// \return Index of the source vertex, or FrameTree::kNoParent on error.
+static std::size_t findSourceVertex(
+    const PoseRelativeToGraph &_graph,
+    const std::size_t _index,
+    const std::vector<std::size_t> *_stops,
+    Errors &_errors)
+{
+  const std::size_t stop =
+      _stops ? (*_stops)[_index] : findTreeStop(_graph.tree, _index);
+  return checkTreeStop(_graph.tree, stop, "PoseRelativeToGraph",
+      ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR, "multiple incoming edges to",
+      ErrorCode::POSE_RELATIVE_TO_CYCLE, _errors);
 }
 
-/// \brief Starting from a given vertex in a directed graph, follow edges
-/// to find a sink vertex (has only incoming edges).
-/// This function returns a NullVertex if a graph cycle is detected or
-/// if a vertex with multiple outgoing edges is found.
-/// Otherwise, this function returns the first sink Vertex that is found.
-/// It also returns the sequence of edges leading to the sink vertex.
-/// \param[in] _graph A directed graph.
-/// \param[in] _id VertexId of the starting vertex.
-/// \return A sink vertex paired with a vector of the edges leading the
-/// sink to the starting vertex, or a NullVertex paired with an empty
-/// vector if a cycle or vertex with multiple outgoing edges are detected.
-template<typename V, typename E>
-std::pair<const ignition::math::graph::Vertex<V> &,
-          std::vector< ignition::math::graph::DirectedEdge<E> > >
-FindSinkVertex(
-    const ignition::math::graph::DirectedGraph<V, E> &_graph,
-    const ignition::math::graph::VertexId _id,
+/// \brief Starting from a given vertex of a FrameAttachedToGraph, follow the
+/// attached-to frames to find a sink vertex (has no outgoing edges).
+/// \param[in] _graph The graph.
+/// \param[in] _index Index of the starting vertex in the tree of the graph.
+/// \param[in] _stops If not null, where the walk from each vertex stops, as
+/// found by findTreeStops.
+/// \param[out] _errors Errors if a cycle or a vertex with multiple outgoing
+/// edges is found.
+/// \return Index of the sink vertex, or FrameTree::kNoParent on error.
+static std::size_t findSinkVertex(
+    const FrameAttachedToGraph &_graph,
+    const std::size_t _index,
+    const std::vector<std::size_t> *_stops,
     Errors &_errors)
 {
-  using DirectedEdge = ignition::math::graph::DirectedEdge<E>;
-  using Vertex = ignition::math::graph::Vertex<V>;
-  using VertexId = ignition::math::graph::VertexId;
-  using EdgesType = std::vector<DirectedEdge>;
-  using PairType = std::pair<const Vertex &, EdgesType>;
-  EdgesType edges;
-  std::reference_wrapper<const Vertex> vertex(_graph.VertexFromId(_id));
-  if (!vertex.get().Valid())
+  const std::size_t stop =
+      _stops ? (*_stops)[_index] : findTreeStop(_graph.tree, _index);
+  return checkTreeStop(_graph.tree, stop, "FrameAttachedToGraph",
+      ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR, "multiple outgoing edges from",
+      ErrorCode::FRAME_ATTACHED_TO_CYCLE, _errors);
+}
+
+/// \brief Find the body a vertex of a FrameAttachedToGraph is attached to.
+/// \param[out] _attachedToBody Name of the link, model or world.
+/// \param[in] _in The graph, which has a valid scope name.
+/// \param[in] _index Index of the vertex in the tree of the graph.
+/// \param[in] _stops If not null, where the walk from each vertex stops, as
+/// found by findTreeStops.
+/// \return Errors.
+static Errors resolveFrameAttachedToBodyImpl(
+    std::string &_attachedToBody,
+    const FrameAttachedToGraph &_in,
+    const std::size_t _index,
+    const std::vector<std::size_t> *_stops)
+{
+  Errors errors;
+
+  const std::size_t sinkIndex = findSinkVertex(_in, _index, _stops, errors);
+  if (!errors.empty())
   {
-    _errors.push_back({ErrorCode::FRAME_ATTACHED_TO_INVALID,
-        "Invalid vertex[" + std::to_string(_id) + "] "
-        "in FrameAttachedToGraph."});
-    return PairType(Vertex::NullVertex, EdgesType());
+    return errors;
   }
 
-  std::set<VertexId> visited;
-  visited.insert(vertex.get().Id());
+  const std::string &vertexName = _in.tree.names[_index];
+  const std::string &sinkName = _in.tree.names[sinkIndex];
+  const FrameType sinkType = _in.tree.types[sinkIndex];
 
-  auto incidentsFrom = _graph.IncidentsFrom(vertex);
-  while (!incidentsFrom.empty())
+  if (_in.scopeName == "world" &&
+      !(sinkType == FrameType::WORLD || sinkType == FrameType::MODEL))
   {
-    if (incidentsFrom.size() != 1)
+    errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
+        "Graph has world scope but sink vertex named [" +
+        sinkName + "] does not have FrameType WORLD or MODEL "
+        "when starting from vertex with name [" + vertexName + "]."});
+    return errors;
+  }
+
+  if (_in.scopeName == "__model__")
+  {
+    if (sinkType == FrameType::MODEL && sinkName == "__model__")
     {
-      _errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
-          "FrameAttachedToGraph error: multiple outgoing edges from "
-          "current vertex [" + vertex.get().Name() + "]."});
-      return PairType(Vertex::NullVertex, EdgesType());
+      errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
+          "Graph with __model__ scope has sink vertex named [__model__] "
+          "when starting from vertex with name [" + vertexName + "], "
+          "which is not permitted."});
+      return errors;
     }
-    auto const &edge = incidentsFrom.begin()->second;
-    vertex = _graph.VertexFromId(edge.get().Vertices().second);
-    edges.push_back(edge);
-    if (visited.count(vertex.get().Id()))
+    else if (sinkType != FrameType::LINK && sinkType != FrameType::MODEL)
     {
-      _errors.push_back({ErrorCode::FRAME_ATTACHED_TO_CYCLE,
-          "FrameAttachedToGraph cycle detected, already visited vertex [" +
-          vertex.get().Name() + "]."});
-      return PairType(Vertex::NullVertex, EdgesType());
+      errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
+          "Graph has __model__ scope but sink vertex named [" +
+          sinkName + "] does not have FrameType LINK OR MODEL "
+          "when starting from vertex with name [" + vertexName + "]."});
+      return errors;
     }
-    visited.insert(vertex.get().Id());
-    incidentsFrom = _graph.IncidentsFrom(vertex);
   }
 
-  return PairType(vertex, edges);
+  _attachedToBody = sinkName;
+
+  return errors;
+}
+
+/// \brief Find the source vertex of a vertex of a PoseRelativeToGraph, and
+/// check that it is the source of the graph.
+/// \param[in] _graph The graph.
+/// \param[in] _index Index of the vertex in the tree of the graph.
+/// \param[in] _stops If not null, where the walk from each vertex stops, as
+/// found by findTreeStops.
+/// \param[out] _errors Errors if the vertex isn't connected to the source of
+/// the graph.
+/// \return Index of the source vertex, or FrameTree::kNoParent on error.
+static std::size_t findGraphSourceVertex(
+    const PoseRelativeToGraph &_graph,
+    const std::size_t _index,
+    const std::vector<std::size_t> *_stops,
+    Errors &_errors)
+{
+  const std::size_t sourceIndex =
+      findSourceVertex(_graph, _index, _stops, _errors);
+  if (sourceIndex == FrameTree::kNoParent)
+  {
+    return sourceIndex;
+  }
+  else if (_graph.tree.names[sourceIndex] != _graph.sourceName)
+  {
+    _errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
+        "PoseRelativeToGraph frame with name [" + _graph.tree.names[_index] +
+        "] is disconnected; its source vertex has name [" +
+        _graph.tree.names[sourceIndex] +
+        "], but its source name should be " + _graph.sourceName + "."});
+    return FrameTree::kNoParent;
+  }
+  return sourceIndex;
 }
 
 /////////////////////////////////////////////////
@@ -178,7 +421,7 @@ std::pair<const Link *, std::string>
 }
 
 /////////////////////////////////////////////////
-Errors buildFrameAttachedToGraph(
+static Errors buildFrameAttachedToGraphImpl(
             FrameAttachedToGraph &_out, const Model *_model)
 {
   Errors errors;
@@ -376,7 +619,7 @@ Errors buildFrameAttachedToGraph(
 }
 
 /////////////////////////////////////////////////
-Errors buildFrameAttachedToGraph(
+static Errors buildFrameAttachedToGraphImpl(
             FrameAttachedToGraph &_out, const World *_world)
 {
   Errors errors;
@@ -483,7 +726,7 @@ Errors buildFrameAttachedToGraph(
 }
 
 /////////////////////////////////////////////////
-Errors buildPoseRelativeToGraph(
+static Errors buildPoseRelativeToGraphImpl(
             PoseRelativeToGraph &_out, const Model *_model)
 {
   Errors errors;
@@ -757,7 +1000,7 @@ Errors buildPoseRelativeToGraph(
 }
 
 /////////////////////////////////////////////////
-Errors buildPoseRelativeToGraph(
+static Errors buildPoseRelativeToGraphImpl(
             PoseRelativeToGraph &_out, const World *_world)
 {
   Errors errors;
@@ -919,6 +1162,56 @@ Errors buildPoseRelativeToGraph(
   return errors;
 }
 
+/////////////////////////////////////////////////
+Errors buildFrameAttachedToGraph(
+            FrameAttachedToGraph &_out, const Model *_model)
+{
+  Errors errors = buildFrameAttachedToGraphImpl(_out, _model);
+  rebuildFrameTree(_out);
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors buildFrameAttachedToGraph(
+            FrameAttachedToGraph &_out, const World *_world)
+{
+  Errors errors = buildFrameAttachedToGraphImpl(_out, _world);
+  rebuildFrameTree(_out);
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors buildPoseRelativeToGraph(
+            PoseRelativeToGraph &_out, const Model *_model)
+{
+  Errors errors = buildPoseRelativeToGraphImpl(_out, _model);
+  rebuildFrameTree(_out);
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors buildPoseRelativeToGraph(
+            PoseRelativeToGraph &_out, const World *_world)
+{
+  Errors errors = buildPoseRelativeToGraphImpl(_out, _world);
+  rebuildFrameTree(_out);
+  return errors;
+}
+
+/////////////////////////////////////////////////
+void rebuildFrameTree(FrameAttachedToGraph &_graph)
+{
+  buildFrameTree<bool>(_graph.graph, false, _graph.tree, nullptr);
+}
+
+/////////////////////////////////////////////////
+void rebuildFrameTree(PoseRelativeToGraph &_graph)
+{
+  buildFrameTree(_graph.graph, true, _graph.tree, &_graph.relativePoses);
+  _graph.rootPoseCache.clear();
+  _graph.rootPoseCached.clear();
+}
+
 /////////////////////////////////////////////////
 Errors validateFrameAttachedToGraph(const FrameAttachedToGraph &_in)
 {
@@ -935,15 +1228,17 @@ Errors validateFrameAttachedToGraph(const FrameAttachedToGraph &_in)
 
   // Expect one vertex with name "__model__" and FrameType MODEL
   // or with name "world" and FrameType WORLD
-  auto scopeVertices = _in.graph.Vertices(_in.scopeName);
-  if (scopeVertices.empty())
+  const FrameTree &tree = _in.tree;
+  const auto scopeCount =
+      std::count(tree.names.begin(), tree.names.end(), _in.scopeName);
+  if (scopeCount == 0)
   {
     errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
                      "FrameAttachedToGraph error: scope frame[" +
                      _in.scopeName + "] not found in graph."});
     return errors;
   }
-  else if (scopeVertices.size() > 1)
+  else if (scopeCount > 1)
   {
     errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
         "FrameAttachedToGraph error, "
@@ -951,8 +1246,7 @@ Errors validateFrameAttachedToGraph(const FrameAttachedToGraph &_in)
     return errors;
   }
 
-  auto scopeVertex = scopeVertices.begin()->second.get();
-  sdf::FrameType scopeFrameType = scopeVertex.Data();
+  sdf::FrameType scopeFrameType = tree.types[tree.index.at(_in.scopeName)];
   if (_in.scopeName == "__model__" && scopeFrameType != sdf::FrameType::MODEL)
   {
     errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
@@ -970,33 +1264,32 @@ Errors validateFrameAttachedToGraph(const FrameAttachedToGraph &_in)
   }
 
   // Check number of outgoing edges for each vertex
-  auto vertices = _in.graph.Vertices();
-  for (auto vertexPair : vertices)
+  for (std::size_t i = 0; i < tree.names.size(); ++i)
   {
     // Vertex names should not be empty
-    if (vertexPair.second.get().Name().empty())
+    if (tree.names[i].empty())
     {
       errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
           "FrameAttachedToGraph error, "
           "vertex with empty name detected."});
     }
 
-    auto outDegree = _in.graph.OutDegree(vertexPair.first);
+    auto outDegree = tree.parentCounts[i];
     if (outDegree > 1)
     {
       errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
           "FrameAttachedToGraph error, "
           "too many outgoing edges at a vertex with name [" +
-          vertexPair.second.get().Name() + "]."});
+          tree.names[i] + "]."});
     }
     else if (sdf::FrameType::MODEL == scopeFrameType)
     {
-      switch (vertexPair.second.get().Data())
+      switch (tree.types[i])
       {
         case sdf::FrameType::WORLD:
           errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
               "FrameAttachedToGraph error, "
-              "vertex with name [" + vertexPair.second.get().Name() + "]" +
+              "vertex with name [" + tree.names[i] + "]" +
               "should not have type WORLD in MODEL attached_to graph."});
           break;
         case sdf::FrameType::LINK:
@@ -1005,20 +1298,20 @@ Errors validateFrameAttachedToGraph(const FrameAttachedToGraph &_in)
             errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
                 "FrameAttachedToGraph error, "
                 "LINK vertex with name [" +
-                vertexPair.second.get().Name() +
+                tree.names[i] +
                 "] should have no outgoing edges "
                 "in MODEL attached_to graph."});
           }
           break;
         case sdf::FrameType::MODEL:
-          if ("__model__" != vertexPair.second.get().Name())
+          if ("__model__" != tree.names[i])
           {
             if (outDegree != 0)
             {
               errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
                   "FrameAttachedToGraph error, "
                   "nested MODEL vertex with name [" +
-                  vertexPair.second.get().Name() +
+                  tree.names[i] +
                   "] should have no outgoing edges "
                   "in MODEL attached_to graph."});
             }
@@ -1032,7 +1325,7 @@ Errors validateFrameAttachedToGraph(const FrameAttachedToGraph &_in)
             errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
                 "FrameAttachedToGraph error, "
                 "Non-LINK vertex with name [" +
-                vertexPair.second.get().Name() +
+                tree.names[i] +
                 "] is disconnected; it should have 1 outgoing edge " +
                 "in MODEL attached_to graph."});
           }
@@ -1041,7 +1334,7 @@ Errors validateFrameAttachedToGraph(const FrameAttachedToGraph &_in)
             errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
                 "FrameAttachedToGraph error, "
                 "Non-LINK vertex with name [" +
-                vertexPair.second.get().Name() +
+                tree.names[i] +
                 "] has " + std::to_string(outDegree) +
                 " outgoing edges; it should only have 1 "
                 "outgoing edge in MODEL attached_to graph."});
@@ -1052,7 +1345,7 @@ Errors validateFrameAttachedToGraph(const FrameAttachedToGraph &_in)
     else
     {
       // scopeFrameType must be sdf::FrameType::WORLD
-      switch (vertexPair.second.get().Data())
+      switch (tree.types[i])
       {
         case sdf::FrameType::JOINT:
         case sdf::FrameType::LINK:
@@ -1083,11 +1376,25 @@ Errors validateFrameAttachedToGraph(const FrameAttachedToGraph &_in)
     }
   }
 
-  // check graph for cycles by finding sink from each vertex
+  // check graph for cycles by finding the sink of every vertex in a single
+  // pass
+  std::vector<std::size_t> stops;
+  findTreeStops(tree, stops);
   for (auto const &namePair : _in.map)
   {
+    auto vertexIter = tree.index.find(namePair.first);
+    if (vertexIter == tree.index.end())
+    {
+      errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
+          "FrameAttachedToGraph error: frame with name [" + namePair.first +
+          "] is not in the frame tree; rebuildFrameTree must be called "
+          "after the graph is modified directly."});
+      continue;
+    }
+
     std::string resolvedBody;
-    Errors e = resolveFrameAttachedToBody(resolvedBody, _in, namePair.first);
+    Errors e = resolveFrameAttachedToBodyImpl(
+        resolvedBody, _in, vertexIter->second, &stops);
     errors.insert(errors.end(), e.begin(), e.end());
   }
 
@@ -1110,15 +1417,17 @@ Errors validatePoseRelativeToGraph(const PoseRelativeToGraph &_in)
 
   // Expect one vertex with name "__model__" and FrameType MODEL
   // or with name "world" and FrameType WORLD
-  auto sourceVertices = _in.graph.Vertices(_in.sourceName);
-  if (sourceVertices.empty())
+  const FrameTree &tree = _in.tree;
+  const auto sourceCount =
+      std::count(tree.names.begin(), tree.names.end(), _in.sourceName);
+  if (sourceCount == 0)
   {
     errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
                      "PoseRelativeToGraph error: source frame[" +
                      _in.sourceName + "] not found in graph."});
     return errors;
   }
-  else if (sourceVertices.size() > 1)
+  else if (sourceCount > 1)
   {
     errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
         "PoseRelativeToGraph error, "
@@ -1126,8 +1435,8 @@ Errors validatePoseRelativeToGraph(const PoseRelativeToGraph &_in)
     return errors;
   }
 
-  auto sourceVertex = sourceVertices.begin()->second.get();
-  sdf::FrameType sourceFrameType = sourceVertex.Data();
+  sdf::FrameType sourceFrameType =
+      tree.types[tree.index.at(_in.sourceName)];
   if (_in.sourceName == "__model__" && sourceFrameType != sdf::FrameType::MODEL)
   {
     errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
@@ -1145,37 +1454,36 @@ Errors validatePoseRelativeToGraph(const PoseRelativeToGraph &_in)
   }
 
   // Check number of incoming edges for each vertex
-  auto vertices = _in.graph.Vertices();
-  for (auto vertexPair : vertices)
+  for (std::size_t i = 0; i < tree.names.size(); ++i)
   {
     // Vertex names should not be empty
-    if (vertexPair.second.get().Name().empty())
+    if (tree.names[i].empty())
     {
       errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
           "PoseRelativeToGraph error, "
           "vertex with empty name detected."});
     }
 
-    auto inDegree = _in.graph.InDegree(vertexPair.first);
+    auto inDegree = tree.parentCounts[i];
     if (inDegree > 1)
     {
       errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
           "PoseRelativeToGraph error, "
           "too many incoming edges at a vertex with name [" +
-          vertexPair.second.get().Name() + "]."});
+          tree.names[i] + "]."});
     }
     else if (sdf::FrameType::MODEL == sourceFrameType)
     {
-      switch (vertexPair.second.get().Data())
+      switch (tree.types[i])
       {
         case sdf::FrameType::WORLD:
           errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
               "PoseRelativeToGraph error, "
-              "vertex with name [" + vertexPair.second.get().Name() + "]" +
+              "vertex with name [" + tree.names[i] + "]" +
               "should not have type WORLD in MODEL relative_to graph."});
           break;
         case sdf::FrameType::MODEL:
-          if ("__model__" == vertexPair.second.get().Name())
+          if ("__model__" == tree.names[i])
           {
             if (inDegree != 0)
             {
@@ -1195,7 +1503,7 @@ Errors validatePoseRelativeToGraph(const PoseRelativeToGraph &_in)
             errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
                 "PoseRelativeToGraph error, "
                 "Vertex with name [" +
-                vertexPair.second.get().Name() +
+                tree.names[i] +
                 "] is disconnected; it should have 1 incoming edge " +
                 "in MODEL relative_to graph."});
           }
@@ -1204,7 +1512,7 @@ Errors validatePoseRelativeToGraph(const PoseRelativeToGraph &_in)
             errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
                 "PoseRelativeToGraph error, "
                 "Non-MODEL vertex with name [" +
-                vertexPair.second.get().Name() +
+                tree.names[i] +
                 "] has " + std::to_string(inDegree) +
                 " incoming edges; it should only have 1 "
                 "incoming edge in MODEL relative_to graph."});
@@ -1215,7 +1523,7 @@ Errors validatePoseRelativeToGraph(const PoseRelativeToGraph &_in)
     else
     {
       // sourceFrameType must be sdf::FrameType::WORLD
-      switch (vertexPair.second.get().Data())
+      switch (tree.types[i])
       {
         case sdf::FrameType::JOINT:
         case sdf::FrameType::LINK:
@@ -1238,7 +1546,7 @@ Errors validatePoseRelativeToGraph(const PoseRelativeToGraph &_in)
             errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
                 "PoseRelativeToGraph error, "
                 "MODEL / FRAME vertex with name [" +
-                vertexPair.second.get().Name() +
+                tree.names[i] +
                 "] is disconnected; it should have 1 incoming edge " +
                 "in WORLD relative_to graph."});
           }
@@ -1247,7 +1555,7 @@ Errors validatePoseRelativeToGraph(const PoseRelativeToGraph &_in)
             errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
                 "PoseRelativeToGraph error, "
                 "MODEL / FRAME vertex with name [" +
-                vertexPair.second.get().Name() +
+                tree.names[i] +
                 "] has " + std::to_string(inDegree) +
                 " incoming edges; it should only have 1 "
                 "incoming edge in WORLD relative_to graph."});
@@ -1257,17 +1565,116 @@ Errors validatePoseRelativeToGraph(const PoseRelativeToGraph &_in)
     }
   }
 
-  // check graph for cycles by resolving pose of each vertex relative to root
+  // check graph for cycles by finding the source of every vertex in a single
+  // pass
+  std::vector<std::size_t> stops;
+  findTreeStops(tree, stops);
   for (auto const &namePair : _in.map)
   {
-    ignition::math::Pose3d pose;
-    Errors e = resolvePoseRelativeToRoot(pose, _in, namePair.first);
-    errors.insert(errors.end(), e.begin(), e.end());
+    auto vertexIter = tree.index.find(namePair.first);
+    if (vertexIter == tree.index.end())
+    {
+      errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
+          "PoseRelativeToGraph error: frame with name [" + namePair.first +
+          "] is not in the frame tree; rebuildFrameTree must be called "
+          "after the graph is modified directly."});
+      continue;
+    }
+
+    findGraphSourceVertex(_in, vertexIter->second, &stops, errors);
   }
 
   return errors;
 }
 
+/////////////////////////////////////////////////
+void cachePosesRelativeToRoot(PoseRelativeToGraph &_graph)
+{
+  const FrameTree &tree = _graph.tree;
+  const std::size_t count = tree.names.size();
+  _graph.rootPoseCache.assign(count, ignition::math::Pose3d::Zero);
+  _graph.rootPoseCached.assign(count, false);
+
+  auto sourceIter = tree.index.find(_graph.sourceName);
+  if (sourceIter == tree.index.end() ||
+      tree.parentCounts[sourceIter->second] != 0)
+  {
+    return;
+  }
+  const std::size_t sourceIndex = sourceIter->second;
+
+  // The vertices that can be resolved are the descendants of the source
+  // vertex. Vertices that lead to a cycle, to a vertex with multiple
+  // parents, or to a root other than the source vertex aren't descendants,
+  // so they aren't cached. The descendants are sorted by depth with a
+  // breadth-first traversal, and their poses are then composed as a batch.
+  std::vector<std::size_t> order = {sourceIndex};
+  std::vector<std::size_t> parents = {0};
+  std::vector<std::size_t> depthOffsets = {0};
+  for (std::size_t begin = 0, end = 1; begin < end;
+       begin = end, end = order.size())
+  {
+    depthOffsets.push_back(end);
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      for (std::size_t c = tree.childOffsets[order[i]];
+           c < tree.childOffsets[order[i] + 1]; ++c)
+      {
+        order.push_back(tree.children[c]);
+        parents.push_back(i);
+      }
+    }
+  }
+
+  // The source vertex keeps an identity pose
+  PoseArrays relativePoses;
+  relativePoses.Resize(order.size());
+  for (std::size_t i = 1; i < order.size(); ++i)
+  {
+    relativePoses.Set(i, _graph.relativePoses[order[i]]);
+  }
+
+  PoseArrays poses;
+  composePoses(relativePoses, parents, depthOffsets, poses);
+  for (std::size_t i = 0; i < order.size(); ++i)
+  {
+    _graph.rootPoseCache[order[i]] = poses.Pose(i);
+    _graph.rootPoseCached[order[i]] = true;
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Recompute the cached poses that were marked as dirty by
+/// updateGraphEdge. Dirty vertices could be resolved before, so following
+/// their parents always leads to a vertex whose pose is cached, which is at
+/// the latest the source vertex.
+/// \param[in,out] _graph Graph whose cache is refreshed.
+/// \param[in] _dirty Indices of the dirty vertices.
+static void refreshPosesRelativeToRoot(
+    PoseRelativeToGraph &_graph,
+    const std::vector<std::size_t> &_dirty)
+{
+  std::vector<std::size_t> path;
+  for (std::size_t vertex : _dirty)
+  {
+    while (!_graph.rootPoseCached[vertex])
+    {
+      path.push_back(vertex);
+      vertex = _graph.tree.parents[vertex];
+    }
+
+    ignition::math::Pose3d pose = _graph.rootPoseCache[vertex];
+    while (!path.empty())
+    {
+      vertex = path.back();
+      path.pop_back();
+      pose = pose * _graph.relativePoses[vertex];
+      _graph.rootPoseCache[vertex] = pose;
+      _graph.rootPoseCached[vertex] = true;
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 Errors resolveFrameAttachedToBody(
     std::string &_attachedToBody,
@@ -1284,67 +1691,17 @@ Errors resolveFrameAttachedToBody(
     return errors;
   }
 
-  if (_in.map.count(_vertexName) != 1)
+  auto vertexIter = _in.tree.index.find(_vertexName);
+  if (vertexIter == _in.tree.index.end())
   {
     errors.push_back({ErrorCode::FRAME_ATTACHED_TO_INVALID,
         "FrameAttachedToGraph unable to find unique frame with name [" +
         _vertexName + "] in graph."});
     return errors;
   }
-  auto vertexId = _in.map.at(_vertexName);
-
-  auto sinkVertexEdges = FindSinkVertex(_in.graph, vertexId, errors);
-  auto sinkVertex = sinkVertexEdges.first;
-
-  if (!errors.empty())
-  {
-    return errors;
-  }
-
-  if (!sinkVertex.Valid())
-  {
-    errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
-        "FrameAttachedToGraph unable to find sink vertex when starting "
-        "from vertex with name [" + _vertexName + "]."});
-    return errors;
-  }
-
-  if (_in.scopeName == "world" &&
-      !(sinkVertex.Data() == FrameType::WORLD ||
-        sinkVertex.Data() == FrameType::MODEL))
-  {
-    errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
-        "Graph has world scope but sink vertex named [" +
-        sinkVertex.Name() + "] does not have FrameType WORLD or MODEL "
-        "when starting from vertex with name [" + _vertexName + "]."});
-    return errors;
-  }
-
-  if (_in.scopeName == "__model__")
-  {
-    if (sinkVertex.Data() == FrameType::MODEL &&
-        sinkVertex.Name() == "__model__")
-    {
-      errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
-          "Graph with __model__ scope has sink vertex named [__model__] "
-          "when starting from vertex with name [" + _vertexName + "], "
-          "which is not permitted."});
-      return errors;
-    }
-    else if (sinkVertex.Data() != FrameType::LINK &&
-             sinkVertex.Data() != FrameType::MODEL)
-    {
-      errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
-          "Graph has __model__ scope but sink vertex named [" +
-          sinkVertex.Name() + "] does not have FrameType LINK OR MODEL "
-          "when starting from vertex with name [" + _vertexName + "]."});
-      return errors;
-    }
-  }
 
-  _attachedToBody = sinkVertex.Name();
-
-  return errors;
+  return resolveFrameAttachedToBodyImpl(
+      _attachedToBody, _in, vertexIter->second, nullptr);
 }
 
 /////////////////////////////////////////////////
@@ -1355,48 +1712,35 @@ Errors resolvePoseRelativeToRoot(
 {
   Errors errors;
 
-  if (_graph.map.count(_vertexName) != 1)
+  auto vertexIter = _graph.tree.index.find(_vertexName);
+  if (vertexIter == _graph.tree.index.end())
   {
     errors.push_back({ErrorCode::POSE_RELATIVE_TO_INVALID,
         "PoseRelativeToGraph unable to find unique frame with name [" +
         _vertexName + "] in graph."});
     return errors;
   }
-  auto vertexId = _graph.map.at(_vertexName);
+  const std::size_t index = vertexIter->second;
 
-  auto incomingVertexEdges = FindSourceVertex(_graph.graph, vertexId, errors);
-
-  if (!errors.empty())
-  {
-    return errors;
-  }
-  else if (!incomingVertexEdges.first.Valid())
+  if (index < _graph.rootPoseCached.size() && _graph.rootPoseCached[index])
   {
-    errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
-        "PoseRelativeToGraph unable to find path to source vertex "
-        "when starting from vertex with name [" + _vertexName + "]."});
+    _pose = _graph.rootPoseCache[index];
     return errors;
   }
-  else if (incomingVertexEdges.first.Name() != _graph.sourceName)
+
+  const std::size_t sourceIndex =
+      findGraphSourceVertex(_graph, index, nullptr, errors);
+  if (!errors.empty())
   {
-    errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
-        "PoseRelativeToGraph frame with name [" + _vertexName + "] "
-        "is disconnected; its source vertex has name [" +
-        incomingVertexEdges.first.Name() +
-        "], but its source name should be " + _graph.sourceName + "."});
     return errors;
   }
 
   ignition::math::Pose3d pose;
-  for (auto const &edge : incomingVertexEdges.second)
+  for (std::size_t i = index; i != sourceIndex; i = _graph.tree.parents[i])
   {
-    pose = edge.Data() * pose;
-  }
-
-  if (errors.empty())
-  {
-    _pose = pose;
+    pose = _graph.relativePoses[i] * pose;
   }
+  _pose = pose;
 
   return errors;
 }
@@ -1423,33 +1767,125 @@ Errors resolvePose(
 }
 
 /////////////////////////////////////////////////
-Errors updateGraphPose(
+Errors appendPosesRelativeToRoot(
+    FramePoses &_poses,
+    const PoseRelativeToGraph &_graph,
+    const std::string &_prefix,
+    const ignition::math::Pose3d &_sourcePose,
+    bool _includeSource)
+{
+  Errors errors;
+  _poses.reserve(_poses.size() + _graph.map.size());
+  for (const auto &namePair : _graph.map)
+  {
+    if (!_includeSource && namePair.first == _graph.sourceName)
+    {
+      continue;
+    }
+
+    ignition::math::Pose3d pose;
+    Errors e = resolvePoseRelativeToRoot(pose, _graph, namePair.first);
+    if (e.empty())
+    {
+      _poses.emplace_back(_prefix + namePair.first, _sourcePose * pose);
+    }
+    else
+    {
+      errors.insert(errors.end(), e.begin(), e.end());
+    }
+  }
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors resolvePosesTo(FramePoses &_poses, const std::string &_resolveTo)
+{
+  Errors errors;
+
+  auto frame = std::find_if(_poses.begin(), _poses.end(),
+      [&_resolveTo](const auto &_pose)
+      {
+        return _pose.first == _resolveTo;
+      });
+  if (frame == _poses.end())
+  {
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_INVALID,
+        "Unable to resolve poses relative to frame with name [" +
+        _resolveTo + "], which was not found."});
+    return errors;
+  }
+
+  const ignition::math::Pose3d inverse = frame->second.Inverse();
+  for (auto &pose : _poses)
+  {
+    pose.second = inverse * pose.second;
+  }
+  return errors;
+}
+
+/////////////////////////////////////////////////
+/// \brief Update the pose of a frame in the pose graph, and mark the cached
+/// poses of the frame and of the frames relative to it as dirty.
+/// \param[in] _graph PoseRelativeToGraph to update.
+/// \param[in] _frameName Name of frame whose pose is to be updated.
+/// \param[in] _pose New pose.
+/// \param[out] _dirty Indices of the vertices whose cached pose is dirty.
+/// \return Errors.
+static Errors updateGraphEdge(
     PoseRelativeToGraph &_graph,
     const std::string &_frameName,
-    const ignition::math::Pose3d &_pose)
+    const ignition::math::Pose3d &_pose,
+    std::vector<std::size_t> &_dirty)
 {
   Errors errors;
 
-  if (_graph.map.count(_frameName) != 1)
+  auto vertexIter = _graph.tree.index.find(_frameName);
+  if (vertexIter == _graph.tree.index.end())
   {
     errors.push_back({ErrorCode::POSE_RELATIVE_TO_INVALID,
         "PoseRelativeToGraph unable to find unique frame with name [" +
         _frameName+ "] in graph."});
     return errors;
   }
-  auto vertexId = _graph.map.at(_frameName);
-  auto incidentsTo = _graph.graph.IncidentsTo(vertexId);
-  if (incidentsTo.size() == 1)
+  const std::size_t index = vertexIter->second;
+  const std::size_t parentCount = _graph.tree.parentCounts[index];
+  if (parentCount == 1)
   {
-    // There's no API to update the data of an edge, so we remove the edge and
+    // The pose is updated in place in the tree. There's no API to update the
+    // data of an edge of the ignition graph, so we remove the edge and
     // insert a new one with the new pose.
-    auto &edge = incidentsTo.begin()->second;
-    auto tailVertexId = edge.get().Tail();
-    auto headVertexId = edge.get().Head();
-    _graph.graph.RemoveEdge(edge.get().Id());
-    _graph.graph.AddEdge({tailVertexId, headVertexId}, _pose);
+    auto &edgeId = _graph.tree.parentEdges[index];
+    const auto &edge = _graph.graph.EdgeFromId(edgeId);
+    auto tailVertexId = edge.Tail();
+    auto headVertexId = edge.Head();
+    _graph.graph.RemoveEdge(edgeId);
+    edgeId = _graph.graph.AddEdge({tailVertexId, headVertexId}, _pose).Id();
+    _graph.relativePoses[index] = _pose;
+
+    // Only the vertices whose pose is cached can become dirty. The others
+    // are either dirty already, along with the vertices relative to them,
+    // or can't be resolved.
+    if (_graph.rootPoseCached.size() == _graph.tree.names.size())
+    {
+      std::vector<std::size_t> stack = {index};
+      while (!stack.empty())
+      {
+        const std::size_t vertex = stack.back();
+        stack.pop_back();
+        if (!_graph.rootPoseCached[vertex])
+        {
+          continue;
+        }
+        _graph.rootPoseCached[vertex] = false;
+        _dirty.push_back(vertex);
+        stack.insert(stack.end(),
+            _graph.tree.children.begin() + _graph.tree.childOffsets[vertex],
+            _graph.tree.children.begin() +
+            _graph.tree.childOffsets[vertex + 1]);
+      }
+    }
   }
-  else if (incidentsTo.empty())
+  else if (parentCount == 0)
   {
     errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
         "PoseRelativeToGraph error: no incoming edge to "
@@ -1467,5 +1903,31 @@ Errors updateGraphPose(
 
   return errors;
 }
+
+/////////////////////////////////////////////////
+Errors updateGraphPose(
+    PoseRelativeToGraph &_graph,
+    const std::string &_frameName,
+    const ignition::math::Pose3d &_pose)
+{
+  return updateGraphPoses(_graph, {{_frameName, _pose}});
+}
+
+/////////////////////////////////////////////////
+Errors updateGraphPoses(
+    PoseRelativeToGraph &_graph,
+    const FramePoses &_poses)
+{
+  Errors errors;
+  std::vector<std::size_t> dirty;
+  for (const auto &framePose : _poses)
+  {
+    Errors e =
+        updateGraphEdge(_graph, framePose.first, framePose.second, dirty);
+    errors.insert(errors.end(), e.begin(), e.end());
+  }
+  refreshPosesRelativeToRoot(_graph, dirty);
+  return errors;
+}
 }
 }
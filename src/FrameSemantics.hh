@@ -17,13 +17,18 @@
 #ifndef SDF_FRAMESEMANTICS_HH_
 #define SDF_FRAMESEMANTICS_HH_
 
+#include <cstddef>
+#include <limits>
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/graph/Graph.hh>
 
 #include "sdf/Error.hh"
+#include "sdf/SemanticPose.hh"
 #include "sdf/Types.hh"
 
 /// \ingroup sdf_frame_semantics
@@ -67,6 +72,56 @@ namespace sdf
     FRAME = 4,
   };
 
+  /// \brief Flat representation of a frame graph. In a valid frame graph
+  /// each vertex has at most one parent, so the graph is stored as arrays
+  /// indexed by vertex, in the order of the vertex ids of the graph. The
+  /// parent of a vertex is the vertex it is attached to in a
+  /// FrameAttachedToGraph, and the vertex its pose is relative to in a
+  /// PoseRelativeToGraph.
+  ///
+  /// The tree is built by the functions that build the graphs, and kept in
+  /// sync by updateGraphPose and updateGraphPoses. The functions that
+  /// validate and resolve frames only read the tree, so if the graph or map
+  /// of a graph is modified directly, rebuildFrameTree must be called before
+  /// any of them. Until it is, they see the graph as it was when the tree
+  /// was last built, and validation reports the frames of the map that are
+  /// missing from the tree.
+  struct FrameTree
+  {
+    /// \brief Parent index of a vertex that doesn't have exactly one parent.
+    static constexpr std::size_t kNoParent =
+        std::numeric_limits<std::size_t>::max();
+
+    /// \brief Names of the vertices.
+    std::vector<std::string> names;
+
+    /// \brief Frame types of the vertices.
+    std::vector<FrameType> types;
+
+    /// \brief Number of parents of each vertex.
+    std::vector<std::size_t> parentCounts;
+
+    /// \brief Index of the parent of each vertex, or kNoParent.
+    std::vector<std::size_t> parents;
+
+    /// \brief Id of the edge between each vertex and its parent in the
+    /// graph, or kNullId if the vertex doesn't have exactly one parent.
+    std::vector<ignition::math::graph::EdgeId> parentEdges;
+
+    /// \brief Offsets of the children of each vertex in the children array.
+    /// The children of vertex i are children[childOffsets[i]] up to
+    /// children[childOffsets[i + 1] - 1].
+    std::vector<std::size_t> childOffsets;
+
+    /// \brief Indices of the vertices that have exactly one parent, grouped
+    /// by parent.
+    std::vector<std::size_t> children;
+
+    /// \brief Index of each vertex by name. Like the map of the graph, a
+    /// name that is used by several vertices refers to the last one.
+    std::unordered_map<std::string, std::size_t> index;
+  };
+
   /// \brief Data structure for frame attached_to graphs for Model or World.
   struct FrameAttachedToGraph
   {
@@ -82,6 +137,10 @@ namespace sdf
 
     /// \brief Name of scope vertex, either __model__ or world.
     std::string scopeName;
+
+    /// \brief Flat representation of the graph, which is used to validate
+    /// the graph and to resolve attached-to bodies.
+    FrameTree tree;
   };
 
   /// \brief Data structure for pose relative_to graphs for Model or World.
@@ -102,6 +161,22 @@ namespace sdf
 
     /// \brief Name of source vertex, either __model__ or world.
     std::string sourceName;
+
+    /// \brief Flat representation of the graph, which is used to validate
+    /// the graph and to resolve poses.
+    FrameTree tree;
+
+    /// \brief Pose of each vertex of the tree relative to its parent.
+    std::vector<Pose3d> relativePoses;
+
+    /// \brief Poses of the vertices of the tree relative to the source
+    /// vertex, computed by cachePosesRelativeToRoot and refreshed by
+    /// updateGraphPose and updateGraphPoses.
+    std::vector<Pose3d> rootPoseCache;
+
+    /// \brief Whether each entry of rootPoseCache is valid. Vertices whose
+    /// pose isn't cached are resolved by walking the tree.
+    std::vector<bool> rootPoseCached;
   };
 
   /// \brief Build a FrameAttachedToGraph for a model.
@@ -133,6 +208,17 @@ namespace sdf
               PoseRelativeToGraph &_out, const World *_world);
 
 
+  /// \brief Rebuild the flat tree of a FrameAttachedToGraph from its graph.
+  /// This must be called after the graph or map is modified directly.
+  /// \param[in,out] _graph Graph whose tree is rebuilt.
+  void rebuildFrameTree(FrameAttachedToGraph &_graph);
+
+  /// \brief Rebuild the flat tree and the relative poses of a
+  /// PoseRelativeToGraph from its graph, and clear its cached poses. This
+  /// must be called after the graph or map is modified directly.
+  /// \param[in,out] _graph Graph whose tree is rebuilt.
+  void rebuildFrameTree(PoseRelativeToGraph &_graph);
+
   /// \brief Confirm that FrameAttachedToGraph is valid by checking the number
   /// of outbound edges for each vertex and checking for graph cycles.
   /// \param[in] _in Graph object to validate.
@@ -145,6 +231,14 @@ namespace sdf
   /// \return Errors.
   Errors validatePoseRelativeToGraph(const PoseRelativeToGraph &_in);
 
+  /// \brief Compute the pose of every vertex relative to the source vertex
+  /// in a single pass from the source vertex, and cache them in the graph
+  /// so that resolvePoseRelativeToRoot and resolvePose don't need to walk
+  /// the graph. Only vertices whose pose can be resolved are cached, so
+  /// invalid graphs still report the same errors.
+  /// \param[in,out] _graph Graph whose poses are cached.
+  void cachePosesRelativeToRoot(PoseRelativeToGraph &_graph);
+
   /// \brief Resolve the attached-to body for a given frame. Following the
   /// edges of the frame attached-to graph from a given frame must lead
   /// to a link or world frame.
@@ -184,9 +278,34 @@ namespace sdf
       const std::string &_frameName,
       const std::string &_resolveTo);
 
+  /// \brief Append the pose of every vertex of a graph to a table, in the
+  /// order of the graph's name map.
+  /// \param[in,out] _poses Table to append to.
+  /// \param[in] _graph PoseRelativeToGraph to read from.
+  /// \param[in] _prefix Prefix for the vertex names, such as "model::".
+  /// \param[in] _sourcePose Pose of the source vertex relative to the frame
+  /// the appended poses are resolved to.
+  /// \param[in] _includeSource True to append the source vertex itself.
+  /// \return Errors for the vertices whose pose can't be resolved. These
+  /// vertices aren't appended.
+  Errors appendPosesRelativeToRoot(
+      FramePoses &_poses,
+      const PoseRelativeToGraph &_graph,
+      const std::string &_prefix,
+      const ignition::math::Pose3d &_sourcePose,
+      bool _includeSource);
+
+  /// \brief Express every pose of a table relative to one of its frames.
+  /// \param[in,out] _poses Table to update.
+  /// \param[in] _resolveTo Name of the frame in the table relative to which
+  /// the poses are expressed.
+  /// \return Errors if the frame isn't in the table.
+  Errors resolvePosesTo(FramePoses &_poses, const std::string &_resolveTo);
+
   /// \brief Update the pose of a frame in the pose graph. This updates the
   /// content of the edge incident to the vertex identified by the given
-  /// _frameName.
+  /// _frameName. If the poses of the graph are cached, only the cached poses
+  /// of the frame and of the frames relative to it are recomputed.
   /// \param[in] _graph PoseRelativeToGraph to update.
   /// \param[in] _frameName Name of frame whose pose is to be updated.
   /// \param[in] _pose New pose.
@@ -195,6 +314,17 @@ namespace sdf
       PoseRelativeToGraph &_graph,
       const std::string &_frameName,
       const ignition::math::Pose3d &_pose);
+
+  /// \brief Update the poses of several frames in the pose graph, as with
+  /// updateGraphPose. The cached poses that are affected by any of the
+  /// updates are only recomputed once, after all the edges are updated.
+  /// \param[in] _graph PoseRelativeToGraph to update.
+  /// \param[in] _poses Names of the frames paired with their new poses.
+  /// \return Errors for the frames whose pose can't be updated. The other
+  /// frames are still updated.
+  Errors updateGraphPoses(
+      PoseRelativeToGraph &_graph,
+      const FramePoses &_poses);
   }
 }
 #endif
@@ -15,6 +15,7 @@
  *
  */
 
+#include <map>
 #include <sstream>
 #include <string>
 
@@ -287,6 +288,101 @@ TEST(FrameSemantics, buildPoseRelativeToGraph)
         "invalid] in graph."));
 }
 
+/////////////////////////////////////////////////
+TEST(FrameSemantics, cachePosesRelativeToRoot)
+{
+  const std::string testFile =
+    sdf::filesystem::append(PROJECT_SOURCE_PATH, "test", "sdf",
+        "model_frame_relative_to_joint.sdf");
+
+  // Load the SDF file
+  sdf::Root root;
+  EXPECT_TRUE(root.Load(testFile).empty());
+  const sdf::Model *model = root.ModelByIndex(0);
+
+  sdf::PoseRelativeToGraph graph;
+  EXPECT_TRUE(sdf::buildPoseRelativeToGraph(graph, model).empty());
+  EXPECT_TRUE(sdf::validatePoseRelativeToGraph(graph).empty());
+
+  // Resolve every frame by walking the graph
+  std::map<std::string, ignition::math::Pose3d> walkedPoses;
+  for (const auto &namePair : graph.map)
+  {
+    EXPECT_TRUE(sdf::resolvePoseRelativeToRoot(
+        walkedPoses[namePair.first], graph, namePair.first).empty());
+  }
+
+  // The cached poses match
+  EXPECT_TRUE(graph.rootPoseCache.empty());
+  sdf::cachePosesRelativeToRoot(graph);
+  EXPECT_EQ(graph.map.size(), graph.rootPoseCache.size());
+  for (const auto &namePair : graph.map)
+  {
+    ignition::math::Pose3d pose;
+    EXPECT_TRUE(
+        sdf::resolvePoseRelativeToRoot(pose, graph, namePair.first).empty());
+    EXPECT_EQ(walkedPoses[namePair.first], pose) << namePair.first;
+  }
+
+  ignition::math::Pose3d pose;
+  EXPECT_TRUE(sdf::resolvePose(pose, graph, "F4", "F3").empty());
+  EXPECT_EQ(ignition::math::Pose3d(0, 0, 4, 0, -IGN_PI/2, 0), pose);
+
+  // A vertex added to the graph directly isn't seen until the tree is
+  // rebuilt, but validation reports that it's missing from the tree.
+  auto vertexId = graph.graph.AddVertex("disconnected",
+      sdf::FrameType::FRAME).Id();
+  graph.map["disconnected"] = vertexId;
+  EXPECT_EQ(0u, graph.tree.index.count("disconnected"));
+  EXPECT_FALSE(
+      sdf::resolvePoseRelativeToRoot(pose, graph, "disconnected").empty());
+  sdf::Errors staleErrors = sdf::validatePoseRelativeToGraph(graph);
+  ASSERT_EQ(1u, staleErrors.size());
+  EXPECT_EQ(sdf::ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
+      staleErrors[0].Code());
+  EXPECT_NE(std::string::npos, staleErrors[0].Message().find("disconnected"));
+  EXPECT_TRUE(sdf::resolvePose(pose, graph, "F4", "F3").empty());
+  EXPECT_EQ(ignition::math::Pose3d(0, 0, 4, 0, -IGN_PI/2, 0), pose);
+
+  // Vertices that aren't connected to the source vertex aren't cached, so
+  // they still report errors.
+  sdf::rebuildFrameTree(graph);
+  EXPECT_TRUE(graph.rootPoseCached.empty());
+  sdf::cachePosesRelativeToRoot(graph);
+  ASSERT_EQ(1u, graph.tree.index.count("disconnected"));
+  EXPECT_FALSE(graph.rootPoseCached[graph.tree.index.at("disconnected")]);
+  EXPECT_TRUE(graph.rootPoseCached[graph.tree.index.at("F4")]);
+  EXPECT_FALSE(
+      sdf::resolvePoseRelativeToRoot(pose, graph, "disconnected").empty());
+
+  // Vertices in a cycle aren't cached, so they still report errors.
+  const std::string cycleFile =
+    sdf::filesystem::append(PROJECT_SOURCE_PATH, "test", "sdf",
+        "model_invalid_frame_relative_to_cycle.sdf");
+  sdf::Root cycleRoot;
+  EXPECT_FALSE(cycleRoot.Load(cycleFile).empty());
+  model = cycleRoot.ModelByIndex(0);
+  ASSERT_NE(nullptr, model);
+
+  sdf::PoseRelativeToGraph cycleGraph;
+  EXPECT_TRUE(sdf::buildPoseRelativeToGraph(cycleGraph, model).empty());
+  EXPECT_FALSE(sdf::validatePoseRelativeToGraph(cycleGraph).empty());
+  sdf::cachePosesRelativeToRoot(cycleGraph);
+  EXPECT_TRUE(cycleGraph.rootPoseCached[cycleGraph.tree.index.at("L")]);
+  EXPECT_FALSE(cycleGraph.rootPoseCached[cycleGraph.tree.index.at("F1")]);
+  EXPECT_FALSE(cycleGraph.rootPoseCached[cycleGraph.tree.index.at("F2")]);
+
+  EXPECT_TRUE(
+      sdf::resolvePoseRelativeToRoot(pose, cycleGraph, "L").empty());
+  EXPECT_EQ(ignition::math::Pose3d(1, 0, 0, 0, 0, 0), pose);
+  sdf::Errors errors =
+      sdf::resolvePoseRelativeToRoot(pose, cycleGraph, "F1");
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::POSE_RELATIVE_TO_CYCLE, errors[0].Code());
+  EXPECT_EQ("PoseRelativeToGraph cycle detected, already visited vertex [F1].",
+      errors[0].Message());
+}
+
 /////////////////////////////////////////////////
 TEST(FrameSemantics, updateGraphPose)
 {
@@ -305,6 +401,8 @@ TEST(FrameSemantics, updateGraphPose)
     sdf::Errors errors = sdf::buildPoseRelativeToGraph(graph, model);
     EXPECT_TRUE(errors.empty());
     EXPECT_TRUE(sdf::validatePoseRelativeToGraph(graph).empty());
+    sdf::cachePosesRelativeToRoot(graph);
+    EXPECT_FALSE(graph.rootPoseCache.empty());
   }
 
   using ignition::math::Pose3d;
@@ -332,6 +430,11 @@ TEST(FrameSemantics, updateGraphPose)
   Pose3d l1NewPose(0, 5, 0, 0, 0, 0);
   EXPECT_TRUE(sdf::updateGraphPose(graph, "L1", l1NewPose).empty());
 
+  // The cached poses of L1 and L3 are refreshed
+  EXPECT_TRUE(graph.rootPoseCached[graph.tree.index.at("L1")]);
+  EXPECT_TRUE(graph.rootPoseCached[graph.tree.index.at("L3")]);
+  EXPECT_EQ(l1NewPose, graph.rootPoseCache[graph.tree.index.at("L1")]);
+
   {
     // L1 relative to __model__ is l1NewPose
     Pose3d pose;
@@ -368,4 +471,67 @@ TEST(FrameSemantics, updateGraphPose)
     EXPECT_TRUE(sdf::resolvePose(pose, graph, "L3", "__model__").empty());
     EXPECT_EQ(l1NewPose * l3NewPose, pose);
   }
+
+  // The same poses are resolved once they are cached again
+  sdf::cachePosesRelativeToRoot(graph);
+  {
+    Pose3d pose;
+    EXPECT_TRUE(sdf::resolvePose(pose, graph, "L3", "__model__").empty());
+    EXPECT_EQ(l1NewPose * l3NewPose, pose);
+    EXPECT_TRUE(sdf::resolvePose(pose, graph, "L3", "L1").empty());
+    EXPECT_EQ(l3NewPose, pose);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(FrameSemantics, updateGraphPoses)
+{
+  const std::string testFile = sdf::filesystem::append(
+      PROJECT_SOURCE_PATH, "test", "sdf", "model_link_relative_to.sdf");
+
+  // Load the SDF file
+  sdf::Root root;
+  EXPECT_TRUE(root.Load(testFile).empty());
+  const sdf::Model *model = root.ModelByIndex(0);
+
+  sdf::PoseRelativeToGraph graph;
+  EXPECT_TRUE(sdf::buildPoseRelativeToGraph(graph, model).empty());
+  EXPECT_TRUE(sdf::validatePoseRelativeToGraph(graph).empty());
+  sdf::cachePosesRelativeToRoot(graph);
+
+  using ignition::math::Pose3d;
+
+  // Update L3 before L1, which L3 is relative to
+  const Pose3d l1NewPose(0, 5, 0, 0, 0, 0);
+  const Pose3d l3NewPose(0, 0, 2, 0, 0, 0);
+  sdf::Errors errors = sdf::updateGraphPoses(graph,
+      {{"L3", l3NewPose}, {"nonexistent", {}}, {"L1", l1NewPose}});
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::POSE_RELATIVE_TO_INVALID, errors[0].Code());
+
+  // All poses are cached again
+  for (std::size_t i = 0; i < graph.tree.names.size(); ++i)
+  {
+    EXPECT_TRUE(graph.rootPoseCached[i]) << graph.tree.names[i];
+  }
+
+  Pose3d pose;
+  EXPECT_TRUE(sdf::resolvePose(pose, graph, "L1", "__model__").empty());
+  EXPECT_EQ(l1NewPose, pose);
+  EXPECT_TRUE(sdf::resolvePose(pose, graph, "L2", "__model__").empty());
+  EXPECT_EQ(Pose3d(2, 0, 0, 0, 0, 0), pose);
+  EXPECT_TRUE(sdf::resolvePose(pose, graph, "L3", "__model__").empty());
+  EXPECT_EQ(l1NewPose * l3NewPose, pose);
+  EXPECT_TRUE(sdf::resolvePose(pose, graph, "L3", "L1").empty());
+  EXPECT_EQ(l3NewPose, pose);
+
+  // The same poses are resolved without the cache
+  graph.rootPoseCached.assign(graph.rootPoseCached.size(), false);
+  EXPECT_TRUE(sdf::resolvePose(pose, graph, "L3", "__model__").empty());
+  EXPECT_EQ(l1NewPose * l3NewPose, pose);
+
+  // The pose of the model frame can't be updated
+  errors = sdf::updateGraphPoses(graph, {{"__model__", l1NewPose}});
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR, errors[0].Code());
 }
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "sdf/SDFImpl.hh"
+#include "IncludeCache.hh"
+
+namespace sdf
+{
+inline namespace SDF_VERSION_NAMESPACE
+{
+/// \brief Dependency scopes of the current thread, innermost last.
+static thread_local std::vector<std::vector<FileStamp> *> t_dependencyScopes;
+
+/////////////////////////////////////////////////
+FileStamp FileStamp::Of(const std::string &_path)
+{
+  FileStamp stamp;
+  stamp.path = _path;
+
+#ifndef _WIN32
+  struct stat fileStat;
+  if (::stat(_path.c_str(), &fileStat) == 0)
+  {
+    stamp.modificationTime = static_cast<std::int64_t>(fileStat.st_mtime);
+#if defined(__APPLE__)
+    stamp.modificationTimeNsec = fileStat.st_mtimespec.tv_nsec;
+#else
+    stamp.modificationTimeNsec = fileStat.st_mtim.tv_nsec;
+#endif
+    stamp.size = static_cast<std::int64_t>(fileStat.st_size);
+  }
+#else
+  struct _stat64 fileStat;
+  if (::_stat64(_path.c_str(), &fileStat) == 0)
+  {
+    stamp.modificationTime = static_cast<std::int64_t>(fileStat.st_mtime);
+    stamp.size = static_cast<std::int64_t>(fileStat.st_size);
+  }
+#endif
+
+  return stamp;
+}
+
+/////////////////////////////////////////////////
+bool FileStamp::IsCurrent() const
+{
+  FileStamp current = FileStamp::Of(this->path);
+  return current.modificationTime == this->modificationTime &&
+         current.modificationTimeNsec == this->modificationTimeNsec &&
+         current.size == this->size;
+}
+
+/////////////////////////////////////////////////
+IncludeCache &IncludeCache::Instance()
+{
+  static IncludeCache instance;
+  return instance;
+}
+
+/////////////////////////////////////////////////
+std::string IncludeCache::Key(const std::string &_modelPath)
+{
+  return SDF::Version() + ":" + _modelPath;
+}
+
+/////////////////////////////////////////////////
+ElementPtr IncludeCache::Find(const std::string &_modelPath,
+                              std::string &_filename)
+{
+  const std::string key = Key(_modelPath);
+  std::string filename;
+  ElementPtr root;
+  std::vector<FileStamp> files;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto iter = this->index.find(key);
+    if (iter == this->index.end())
+    {
+      return nullptr;
+    }
+
+    // Move the entry to the front of the list
+    this->entries.splice(this->entries.begin(), this->entries, iter->second);
+    const Entry &entry = *iter->second;
+    filename = entry.filename;
+    root = entry.root;
+    files = entry.files;
+  }
+
+  // Check that none of the files have changed without holding the lock, so
+  // that other threads aren't blocked by the file system. A stale entry is
+  // dropped, unless it has been replaced in the meantime.
+  for (const FileStamp &file : files)
+  {
+    if (!file.IsCurrent())
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      auto iter = this->index.find(key);
+      if (iter != this->index.end() && iter->second->root == root)
+      {
+        this->entries.erase(iter->second);
+        this->index.erase(iter);
+      }
+      return nullptr;
+    }
+  }
+
+  // Cached elements are never modified, so they can be copied without
+  // holding the lock.
+  _filename = filename;
+  AddDependencies(files);
+  return root->Clone();
+}
+
+/////////////////////////////////////////////////
+void IncludeCache::Insert(const std::string &_modelPath,
+                          const std::string &_filename,
+                          const ElementPtr &_root,
+                          const std::vector<FileStamp> &_files)
+{
+  // Don't copy the element if it won't be kept
+  if (this->MaxSize() == 0)
+  {
+    return;
+  }
+
+  Entry entry;
+  entry.key = Key(_modelPath);
+  entry.filename = _filename;
+  entry.root = _root->Clone();
+  entry.files = _files;
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (this->maxSize == 0)
+  {
+    return;
+  }
+
+  auto iter = this->index.find(entry.key);
+  if (iter != this->index.end())
+  {
+    this->entries.erase(iter->second);
+    this->index.erase(iter);
+  }
+
+  this->entries.push_front(std::move(entry));
+  this->index[this->entries.front().key] = this->entries.begin();
+  this->Trim();
+}
+
+/////////////////////////////////////////////////
+void IncludeCache::SetMaxSize(std::size_t _maxSize)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->maxSize = _maxSize;
+  this->Trim();
+}
+
+/////////////////////////////////////////////////
+std::size_t IncludeCache::MaxSize() const
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->maxSize;
+}
+
+/////////////////////////////////////////////////
+void IncludeCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->entries.clear();
+  this->index.clear();
+}
+
+/////////////////////////////////////////////////
+void IncludeCache::Trim()
+{
+  while (this->entries.size() > this->maxSize)
+  {
+    this->index.erase(this->entries.back().key);
+    this->entries.pop_back();
+  }
+}
+
+/////////////////////////////////////////////////
+IncludeCache::DependencyScope::DependencyScope()
+{
+  t_dependencyScopes.push_back(&this->files);
+}
+
+/////////////////////////////////////////////////
+IncludeCache::DependencyScope::~DependencyScope()
+{
+  t_dependencyScopes.pop_back();
+}
+
+/////////////////////////////////////////////////
+const std::vector<FileStamp> &IncludeCache::DependencyScope::Files() const
+{
+  return this->files;
+}
+
+/////////////////////////////////////////////////
+void IncludeCache::AddDependencies(const std::vector<FileStamp> &_files)
+{
+  for (std::vector<FileStamp> *scope : t_dependencyScopes)
+  {
+    scope->insert(scope->end(), _files.begin(), _files.end());
+  }
+}
+}
+}
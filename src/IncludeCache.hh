@@ -0,0 +1,168 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDFORMAT_INCLUDECACHE_HH_
+#define SDFORMAT_INCLUDECACHE_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sdf/Element.hh"
+#include "sdf/Types.hh"
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  /// \brief State of a file used to detect whether it has changed.
+  struct FileStamp
+  {
+    /// \brief Path of the file.
+    std::string path;
+
+    /// \brief Modification time, or -1 if the file doesn't exist.
+    std::int64_t modificationTime = -1;
+
+    /// \brief Nanoseconds part of the modification time, if available.
+    std::int64_t modificationTimeNsec = 0;
+
+    /// \brief Size of the file in bytes.
+    std::int64_t size = 0;
+
+    /// \brief Get the current stamp of a file.
+    /// \param[in] _path Path of the file.
+    /// \return The stamp.
+    static FileStamp Of(const std::string &_path);
+
+    /// \brief Check whether the file still has this stamp.
+    /// \return True if the file hasn't changed.
+    bool IsCurrent() const;
+  };
+
+  /// \brief Process-wide cache of the files loaded by <include> elements.
+  ///
+  /// Entries are keyed by the resolved model directory and hold the parsed
+  /// root element of the model file. Each entry records the stamps of the
+  /// files it was built from, including the model.config and the files of
+  /// nested includes, and is only used while none of them has changed.
+  /// The least recently used entries are dropped when the cache is full.
+  class IncludeCache
+  {
+    /// \brief Get the process-wide instance.
+    /// \return The cache.
+    public: static IncludeCache &Instance();
+
+    /// \brief Look up a model directory.
+    /// \param[in] _modelPath Resolved model directory.
+    /// \param[out] _filename Set to the model file if found.
+    /// \return A copy of the cached root element, or nullptr if there's no
+    /// current entry for the directory.
+    public: ElementPtr Find(const std::string &_modelPath,
+                            std::string &_filename);
+
+    /// \brief Add the root element of a loaded model file.
+    /// \param[in] _modelPath Resolved model directory.
+    /// \param[in] _filename Model file.
+    /// \param[in] _root Root element of the model file. The cache keeps a
+    /// copy of it.
+    /// \param[in] _files Stamps of the files the element was built from.
+    public: void Insert(const std::string &_modelPath,
+                        const std::string &_filename,
+                        const ElementPtr &_root,
+                        const std::vector<FileStamp> &_files);
+
+    /// \brief Set the maximum number of entries.
+    /// \param[in] _maxSize Maximum number of entries. 0 disables the cache.
+    public: void SetMaxSize(std::size_t _maxSize);
+
+    /// \brief Get the maximum number of entries.
+    /// \return Maximum number of entries.
+    public: std::size_t MaxSize() const;
+
+    /// \brief Remove all entries.
+    public: void Clear();
+
+    /// \brief Collects the stamps of the files read while an included file
+    /// is loaded. Scopes on the same thread nest, and a stamp added while
+    /// several scopes are alive is added to all of them, so that an entry
+    /// also depends on the files of its nested includes.
+    public: class DependencyScope
+    {
+      /// \brief Constructor. Starts collecting on the current thread.
+      public: DependencyScope();
+
+      /// \brief Destructor. Stops collecting.
+      public: ~DependencyScope();
+
+      /// \brief Get the stamps collected so far.
+      /// \return The stamps.
+      public: const std::vector<FileStamp> &Files() const;
+
+      /// \brief Stamps collected by this scope.
+      private: std::vector<FileStamp> files;
+    };
+
+    /// \brief Add stamps to all the dependency scopes of the current thread.
+    /// \param[in] _files Stamps to add.
+    public: static void AddDependencies(const std::vector<FileStamp> &_files);
+
+    /// \brief A cached model file.
+    private: struct Entry
+    {
+      /// \brief Key of the entry.
+      std::string key;
+
+      /// \brief Model file.
+      std::string filename;
+
+      /// \brief Root element of the model file.
+      ElementPtr root;
+
+      /// \brief Stamps of the files the element was built from.
+      std::vector<FileStamp> files;
+    };
+
+    /// \brief Get the key of a model directory.
+    /// \param[in] _modelPath Resolved model directory.
+    /// \return The key, which also depends on the SDFormat version.
+    private: static std::string Key(const std::string &_modelPath);
+
+    /// \brief Drop least recently used entries until the cache fits.
+    private: void Trim();
+
+    /// \brief Mutex that protects the entries.
+    private: mutable std::mutex mutex;
+
+    /// \brief Maximum number of entries. The cache is disabled by default.
+    private: std::size_t maxSize = 0;
+
+    /// \brief Entries, from most to least recently used.
+    private: std::list<Entry> entries;
+
+    /// \brief Entries by key.
+    private: std::unordered_map<std::string, std::list<Entry>::iterator>
+        index;
+  };
+  }
+}
+#endif
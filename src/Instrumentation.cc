@@ -0,0 +1,106 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "sdf/Instrumentation.hh"
+#include "InstrumentationPrivate.hh"
+
+namespace sdf
+{
+inline namespace SDF_VERSION_NAMESPACE {
+
+std::atomic<bool> g_loadMeasurementEnabled{false};
+
+/// \brief Protects g_loadMeasurementCallback.
+static std::mutex g_loadMeasurementMutex;
+
+/// \brief The callback set with setLoadMeasurementCallback. It's shared
+/// with the threads that are calling it, so it can be replaced meanwhile.
+static std::shared_ptr<const LoadMeasurementCallback>
+    g_loadMeasurementCallback;
+
+/////////////////////////////////////////////////
+LoadMeasurement::LoadMeasurement(const LoadPhase _phase,
+    const std::string &_source, const std::chrono::nanoseconds _duration,
+    const std::size_t _count)
+  : phase(_phase), source(_source), duration(_duration), count(_count)
+{
+}
+
+/////////////////////////////////////////////////
+LoadPhase LoadMeasurement::Phase() const
+{
+  return this->phase;
+}
+
+/////////////////////////////////////////////////
+const std::string &LoadMeasurement::Source() const
+{
+  return this->source;
+}
+
+/////////////////////////////////////////////////
+std::chrono::nanoseconds LoadMeasurement::Duration() const
+{
+  return this->duration;
+}
+
+/////////////////////////////////////////////////
+std::size_t LoadMeasurement::Count() const
+{
+  return this->count;
+}
+
+/////////////////////////////////////////////////
+void setLoadMeasurementCallback(LoadMeasurementCallback _callback)
+{
+  std::shared_ptr<const LoadMeasurementCallback> callback;
+  if (_callback)
+  {
+    callback = std::make_shared<const LoadMeasurementCallback>(
+        std::move(_callback));
+  }
+
+  std::lock_guard<std::mutex> lock(g_loadMeasurementMutex);
+  g_loadMeasurementCallback = std::move(callback);
+  g_loadMeasurementEnabled = g_loadMeasurementCallback != nullptr;
+}
+
+/////////////////////////////////////////////////
+void ScopedLoadTimer::Report() const
+{
+  const auto duration = std::chrono::steady_clock::now() - this->start;
+
+  std::shared_ptr<const LoadMeasurementCallback> callback;
+  {
+    std::lock_guard<std::mutex> lock(g_loadMeasurementMutex);
+    callback = g_loadMeasurementCallback;
+  }
+
+  // The callback may have been removed since the measurement started
+  if (callback)
+  {
+    (*callback)(LoadMeasurement(this->phase, this->source,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(duration),
+        this->count));
+  }
+}
+}
+}
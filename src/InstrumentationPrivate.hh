@@ -0,0 +1,118 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_INSTRUMENTATION_PRIVATE_HH_
+#define SDF_INSTRUMENTATION_PRIVATE_HH_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <sdf/sdf_config.h>
+
+#include "sdf/Instrumentation.hh"
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  /// \internal
+  /// \brief True while a load measurement callback is set.
+  extern std::atomic<bool> g_loadMeasurementEnabled;
+
+  /// \internal
+  /// \brief Measures a phase of loading from its construction to its
+  /// destruction, and reports it to the load measurement callback. It does
+  /// nothing when no callback was set at construction.
+  class ScopedLoadTimer
+  {
+    /// \brief Constructor. Starts the measurement.
+    /// \param[in] _phase The measured phase.
+    /// \param[in] _source What the phase works on.
+    public: ScopedLoadTimer(const LoadPhase _phase,
+                            const std::string &_source)
+      : active(g_loadMeasurementEnabled.load(std::memory_order_relaxed))
+    {
+      if (this->active)
+      {
+        this->phase = _phase;
+        this->source = _source;
+        this->start = std::chrono::steady_clock::now();
+      }
+    }
+
+    /// \brief Destructor. Reports the measurement if Stop wasn't called.
+    public: ~ScopedLoadTimer()
+    {
+      this->Stop();
+    }
+
+    /// \brief Copying would report the measurement twice.
+    public: ScopedLoadTimer(const ScopedLoadTimer &) = delete;
+
+    /// \brief Copying would report the measurement twice.
+    public: ScopedLoadTimer &operator=(const ScopedLoadTimer &) = delete;
+
+    /// \brief Whether the phase is measured. Counts that are expensive to
+    /// compute should only be computed in that case.
+    /// \return True if a callback was set at construction.
+    public: bool Active() const
+    {
+      return this->active;
+    }
+
+    /// \brief Set the number of items handled by the phase. The default is
+    /// 1.
+    /// \param[in] _count Number of items.
+    public: void SetCount(const std::size_t _count)
+    {
+      this->count = _count;
+    }
+
+    /// \brief End the phase and report the measurement, for phases that end
+    /// before the end of the scope. Later calls do nothing.
+    public: void Stop()
+    {
+      if (this->active)
+      {
+        this->Report();
+        this->active = false;
+      }
+    }
+
+    /// \brief Report the measurement to the callback.
+    private: void Report() const;
+
+    /// \brief True if the phase is measured and hasn't been reported.
+    private: bool active;
+
+    /// \brief The measured phase.
+    private: LoadPhase phase = LoadPhase::XML_PARSE;
+
+    /// \brief What the phase works on.
+    private: std::string source;
+
+    /// \brief Number of items handled by the phase.
+    private: std::size_t count = 1;
+
+    /// \brief Time at which the phase started.
+    private: std::chrono::steady_clock::time_point start;
+  };
+  }
+}
+#endif
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "sdf/Instrumentation.hh"
+#include "sdf/Root.hh"
+#include "sdf/sdf_config.h"
+
+/////////////////////////////////////////////////
+TEST(Instrumentation, LoadMeasurement)
+{
+  sdf::LoadMeasurement measurement(sdf::LoadPhase::INCLUDE,
+      "model://test_model", std::chrono::nanoseconds(42), 1u);
+  EXPECT_EQ(sdf::LoadPhase::INCLUDE, measurement.Phase());
+  EXPECT_EQ("model://test_model", measurement.Source());
+  EXPECT_EQ(std::chrono::nanoseconds(42), measurement.Duration());
+  EXPECT_EQ(1u, measurement.Count());
+}
+
+/////////////////////////////////////////////////
+TEST(Instrumentation, RootLoad)
+{
+  const std::string sdfString =
+    "<?xml version='1.0'?>"
+    "<sdf version='" SDF_VERSION "'>"
+    "  <model name='box'>"
+    "    <link name='link'/>"
+    "    <frame name='frame' attached_to='link'/>"
+    "  </model>"
+    "</sdf>";
+
+  std::mutex mutex;
+  std::vector<sdf::LoadMeasurement> measurements;
+  sdf::setLoadMeasurementCallback(
+      [&](const sdf::LoadMeasurement &_measurement)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        measurements.push_back(_measurement);
+      });
+
+  sdf::Root root;
+  sdf::Errors errors = root.LoadSdfString(sdfString);
+  sdf::setLoadMeasurementCallback(nullptr);
+  EXPECT_TRUE(errors.empty());
+
+  // Phases are reported when they end, so inner phases come first
+  ASSERT_EQ(4u, measurements.size());
+
+  EXPECT_EQ(sdf::LoadPhase::XML_PARSE, measurements[0].Phase());
+  EXPECT_EQ("data-string", measurements[0].Source());
+
+  EXPECT_EQ(sdf::LoadPhase::READ_XML, measurements[1].Phase());
+  EXPECT_EQ("data-string", measurements[1].Source());
+  EXPECT_LE(4u, measurements[1].Count());
+
+  EXPECT_EQ(sdf::LoadPhase::FRAME_GRAPH, measurements[2].Phase());
+  EXPECT_EQ("box", measurements[2].Source());
+  // __model__, link and frame
+  EXPECT_EQ(3u, measurements[2].Count());
+
+  EXPECT_EQ(sdf::LoadPhase::DOM_LOAD, measurements[3].Phase());
+  EXPECT_EQ(1u, measurements[3].Count());
+  EXPECT_LE(measurements[2].Duration(), measurements[3].Duration());
+
+  // Nothing is reported once the callback is removed
+  sdf::Root otherRoot;
+  EXPECT_TRUE(otherRoot.LoadSdfString(sdfString).empty());
+  EXPECT_EQ(4u, measurements.size());
+}
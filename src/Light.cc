@@ -127,6 +127,8 @@ void Light::CopyFrom(const Light &_light)
   this->dataPtr->poseRelativeTo = _light.dataPtr->poseRelativeTo;
   this->dataPtr->type = _light.dataPtr->type;
   this->dataPtr->sdf = _light.dataPtr->sdf;
+  this->dataPtr->xmlParentName = _light.dataPtr->xmlParentName;
+  this->dataPtr->poseRelativeToGraph = _light.dataPtr->poseRelativeToGraph;
   this->dataPtr->castShadows = _light.dataPtr->castShadows;
   this->dataPtr->attenuationRange = _light.dataPtr->attenuationRange;
   this->dataPtr->linearAttenuation = _light.dataPtr->linearAttenuation;
@@ -55,6 +55,12 @@ class sdf::LinkPrivate
   /// \brief The sensors specified in this link.
   public: std::vector<Sensor> sensors;
 
+  /// \brief Indices of the visuals, lights, collisions and sensors by name.
+  public: NameIndex visualIndex;
+  public: NameIndex lightIndex;
+  public: NameIndex collisionIndex;
+  public: NameIndex sensorIndex;
+
   /// \brief The inertial information for this link.
   public: ignition::math::Inertiald inertial {{1.0,
             ignition::math::Vector3d::One, ignition::math::Vector3d::Zero},
@@ -163,6 +169,11 @@ Errors Link::Load(ElementPtr _sdf)
       this->dataPtr->sensors);
   errors.insert(errors.end(), sensorLoadErrors.begin(), sensorLoadErrors.end());
 
+  this->dataPtr->visualIndex = buildNameIndex(this->dataPtr->visuals);
+  this->dataPtr->lightIndex = buildNameIndex(this->dataPtr->lights);
+  this->dataPtr->collisionIndex = buildNameIndex(this->dataPtr->collisions);
+  this->dataPtr->sensorIndex = buildNameIndex(this->dataPtr->sensors);
+
   ignition::math::Vector3d xxyyzz = ignition::math::Vector3d::One;
   ignition::math::Vector3d xyxzyz = ignition::math::Vector3d::Zero;
   ignition::math::Pose3d inertiaPose;
@@ -239,14 +250,7 @@ const Visual *Link::VisualByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Link::VisualNameExists(const std::string &_name) const
 {
-  for (auto const &v : this->dataPtr->visuals)
-  {
-    if (v.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->visualIndex.count(_name) > 0;
 }
 
 /////////////////////////////////////////////////
@@ -266,14 +270,7 @@ const Collision *Link::CollisionByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Link::CollisionNameExists(const std::string &_name) const
 {
-  for (auto const &c : this->dataPtr->collisions)
-  {
-    if (c.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->collisionIndex.count(_name) > 0;
 }
 
 /////////////////////////////////////////////////
@@ -293,7 +290,7 @@ const Light *Link::LightByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Link::LightNameExists(const std::string &_name) const
 {
-  return this->LightByName(_name) != nullptr;
+  return this->dataPtr->lightIndex.count(_name) > 0;
 }
 
 /////////////////////////////////////////////////
@@ -313,27 +310,13 @@ const Sensor *Link::SensorByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Link::SensorNameExists(const std::string &_name) const
 {
-  for (auto const &s : this->dataPtr->sensors)
-  {
-    if (s.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->sensorIndex.count(_name) > 0;
 }
 
 /////////////////////////////////////////////////
 const Sensor *Link::SensorByName(const std::string &_name) const
 {
-  for (auto const &s : this->dataPtr->sensors)
-  {
-    if (s.Name() == _name)
-    {
-      return &s;
-    }
-  }
-  return nullptr;
+  return findByName(this->dataPtr->sensors, this->dataPtr->sensorIndex, _name);
 }
 
 /////////////////////////////////////////////////
@@ -415,40 +398,20 @@ sdf::SemanticPose Link::SemanticPose() const
 /////////////////////////////////////////////////
 const Visual *Link::VisualByName(const std::string &_name) const
 {
-  for (auto const &v : this->dataPtr->visuals)
-  {
-    if (v.Name() == _name)
-    {
-      return &v;
-    }
-  }
-  return nullptr;
+  return findByName(this->dataPtr->visuals, this->dataPtr->visualIndex, _name);
 }
 
 /////////////////////////////////////////////////
 const Collision *Link::CollisionByName(const std::string &_name) const
 {
-  for (auto const &c : this->dataPtr->collisions)
-  {
-    if (c.Name() == _name)
-    {
-      return &c;
-    }
-  }
-  return nullptr;
+  return findByName(this->dataPtr->collisions,
+      this->dataPtr->collisionIndex, _name);
 }
 
 /////////////////////////////////////////////////
 const Light *Link::LightByName(const std::string &_name) const
 {
-  for (auto const &c : this->dataPtr->lights)
-  {
-    if (c.Name() == _name)
-    {
-      return &c;
-    }
-  }
-  return nullptr;
+  return findByName(this->dataPtr->lights, this->dataPtr->lightIndex, _name);
 }
 
 /////////////////////////////////////////////////
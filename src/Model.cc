@@ -14,9 +14,11 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/SemanticVersion.hh>
@@ -27,6 +29,7 @@
 #include "sdf/Model.hh"
 #include "sdf/Types.hh"
 #include "FrameSemantics.hh"
+#include "InstrumentationPrivate.hh"
 #include "Utils.hh"
 
 using namespace sdf;
@@ -73,15 +76,40 @@ class sdf::ModelPrivate
   /// \brief The nested models specified in this model.
   public: std::vector<Model> models;
 
+  /// \brief Indices of the links, joints, frames and nested models by name.
+  public: NameIndex linkIndex;
+  public: NameIndex jointIndex;
+  public: NameIndex frameIndex;
+  public: NameIndex modelIndex;
+
   /// \brief The SDF element pointer used during load.
   public: sdf::ElementPtr sdf;
 
-  /// \brief Frame Attached-To Graph constructed during Load.
+  /// \brief Frame Attached-To Graph constructed during Load. It's shared
+  /// by the copies of this model.
   public: std::shared_ptr<sdf::FrameAttachedToGraph> frameAttachedToGraph;
 
-  /// \brief Pose Relative-To Graph constructed during Load.
+  /// \brief Pose Relative-To Graph constructed during Load. It's shared by
+  /// the copies of this model, until one of them gets its own copy to
+  /// modify it (see Model::PoseGraphForUpdate).
   public: std::shared_ptr<sdf::PoseRelativeToGraph> poseGraph;
 
+  /// \brief Errors found while building the Frame Attached-To Graph
+  /// during Load.
+  public: Errors frameAttachedToGraphBuildErrors;
+
+  /// \brief Errors found while validating the Frame Attached-To Graph
+  /// during Load.
+  public: Errors frameAttachedToGraphValidateErrors;
+
+  /// \brief Errors found while building the Pose Relative-To Graph during
+  /// Load.
+  public: Errors poseGraphBuildErrors;
+
+  /// \brief Errors found while validating the Pose Relative-To Graph
+  /// during Load.
+  public: Errors poseGraphValidateErrors;
+
   /// \brief Pose Relative-To Graph in parent (world or __model__) scope.
   public: std::weak_ptr<const sdf::PoseRelativeToGraph> parentPoseGraph;
 
@@ -106,35 +134,9 @@ Model::~Model()
 Model::Model(const Model &_model)
   : dataPtr(new ModelPrivate(*_model.dataPtr))
 {
-  if (_model.dataPtr->frameAttachedToGraph)
-  {
-    this->dataPtr->frameAttachedToGraph =
-        std::make_shared<sdf::FrameAttachedToGraph>(
-            *_model.dataPtr->frameAttachedToGraph);
-  }
-  if (_model.dataPtr->poseGraph)
-  {
-    this->dataPtr->poseGraph = std::make_shared<sdf::PoseRelativeToGraph>(
-        *_model.dataPtr->poseGraph);
-  }
-  for (auto &link : this->dataPtr->links)
-  {
-    link.SetPoseRelativeToGraph(this->dataPtr->poseGraph);
-  }
-  for (auto &model : this->dataPtr->models)
-  {
-    model.SetPoseRelativeToGraph(this->dataPtr->poseGraph);
-  }
-  for (auto &joint : this->dataPtr->joints)
-  {
-    joint.SetFrameAttachedToGraph(this->dataPtr->frameAttachedToGraph);
-    joint.SetPoseRelativeToGraph(this->dataPtr->poseGraph);
-  }
-  for (auto &frame : this->dataPtr->frames)
-  {
-    frame.SetFrameAttachedToGraph(this->dataPtr->frameAttachedToGraph);
-    frame.SetPoseRelativeToGraph(this->dataPtr->poseGraph);
-  }
+  // The graphs are shared with the copy instead of being copied. The copied
+  // children already point to them. The pose graph is copied before it's
+  // modified, as long as it's shared.
 }
 
 /////////////////////////////////////////////////
@@ -360,21 +362,33 @@ Errors Model::Load(ElementPtr _sdf)
     frameNames.insert(frameName);
   }
 
+  // Names don't change after this point, so index them for lookups by name
+  // during the rest of Load and afterwards.
+  this->dataPtr->linkIndex = buildNameIndex(this->dataPtr->links);
+  this->dataPtr->jointIndex = buildNameIndex(this->dataPtr->joints);
+  this->dataPtr->frameIndex = buildNameIndex(this->dataPtr->frames);
+  this->dataPtr->modelIndex = buildNameIndex(this->dataPtr->models);
+
   // Build the graphs.
+  ScopedLoadTimer graphTimer(LoadPhase::FRAME_GRAPH, this->dataPtr->name);
 
   // Build the FrameAttachedToGraph if the model is not static.
   // Re-enable this when the buildFrameAttachedToGraph implementation handles
   // static models.
   if (!this->Static())
   {
-    this->dataPtr->frameAttachedToGraph
-        = std::make_shared<FrameAttachedToGraph>();
-    Errors frameAttachedToGraphErrors =
-    buildFrameAttachedToGraph(*this->dataPtr->frameAttachedToGraph, this);
+    auto frameAttachedToGraph = std::make_shared<FrameAttachedToGraph>();
+    this->dataPtr->frameAttachedToGraph = frameAttachedToGraph;
+    Errors &frameAttachedToGraphErrors =
+        this->dataPtr->frameAttachedToGraphBuildErrors;
+    frameAttachedToGraphErrors =
+        buildFrameAttachedToGraph(*frameAttachedToGraph, this);
     errors.insert(errors.end(), frameAttachedToGraphErrors.begin(),
                                 frameAttachedToGraphErrors.end());
-    Errors validateFrameAttachedGraphErrors =
-      validateFrameAttachedToGraph(*this->dataPtr->frameAttachedToGraph);
+    Errors &validateFrameAttachedGraphErrors =
+        this->dataPtr->frameAttachedToGraphValidateErrors;
+    validateFrameAttachedGraphErrors =
+        validateFrameAttachedToGraph(*frameAttachedToGraph);
     errors.insert(errors.end(), validateFrameAttachedGraphErrors.begin(),
                                 validateFrameAttachedGraphErrors.end());
     for (auto &joint : this->dataPtr->joints)
@@ -387,16 +401,20 @@ Errors Model::Load(ElementPtr _sdf)
     }
   }
 
-  // Build the PoseRelativeToGraph
-  this->dataPtr->poseGraph = std::make_shared<PoseRelativeToGraph>();
-  Errors poseGraphErrors =
-  buildPoseRelativeToGraph(*this->dataPtr->poseGraph, this);
+  // Build the PoseRelativeToGraph. It's only modified through poseGraph
+  // until the end of Load, after which it can be shared by copies.
+  auto poseGraph = std::make_shared<PoseRelativeToGraph>();
+  this->dataPtr->poseGraph = poseGraph;
+  Errors &poseGraphErrors = this->dataPtr->poseGraphBuildErrors;
+  poseGraphErrors = buildPoseRelativeToGraph(*poseGraph, this);
   errors.insert(errors.end(), poseGraphErrors.begin(),
                               poseGraphErrors.end());
-  Errors validatePoseGraphErrors =
-    validatePoseRelativeToGraph(*this->dataPtr->poseGraph);
+  Errors &validatePoseGraphErrors = this->dataPtr->poseGraphValidateErrors;
+  validatePoseGraphErrors = validatePoseRelativeToGraph(*poseGraph);
   errors.insert(errors.end(), validatePoseGraphErrors.begin(),
                               validatePoseGraphErrors.end());
+  graphTimer.SetCount(poseGraph->map.size());
+  graphTimer.Stop();
   for (auto &link : this->dataPtr->links)
   {
     link.SetPoseRelativeToGraph(this->dataPtr->poseGraph);
@@ -418,33 +436,9 @@ Errors Model::Load(ElementPtr _sdf)
   }
 
   // Update the model pose to account for the placement frame.
-  if (!this->dataPtr->placementFrameName.empty())
-  {
-    ignition::math::Pose3d X_MPf;
-
-    sdf::Errors resolveErrors =
-        sdf::resolvePose(X_MPf, *this->dataPtr->poseGraph,
-            this->dataPtr->placementFrameName, "__model__");
-    if (resolveErrors.empty())
-    {
-      // Before this update, i.e, as specified in the SDFormat, the model pose
-      // (X_RPf) is the pose of the placement frame (Pf) relative to a frame (R)
-      // in the parent scope of the model. However, when this model (M) is
-      // inserted into a pose graph of the parent scope, only the pose (X_RM)
-      // of the __model__ frame can be used. Thus, the model pose has to be
-      // updated to X_RM.
-      //
-      // Note that X_RPf is the raw pose specified in //model/pose before this
-      // update.
-      const auto &X_RPf = this->dataPtr->pose;
-      auto &X_RM = this->dataPtr->pose;
-      X_RM = X_RPf * X_MPf.Inverse();
-    }
-    else
-    {
-      errors.insert(errors.end(), resolveErrors.begin(), resolveErrors.end());
-    }
-  }
+  Errors placementErrors = this->ModelPoseFromPlacementPose(
+      this->dataPtr->pose, this->dataPtr->pose);
+  errors.insert(errors.end(), placementErrors.begin(), placementErrors.end());
 
   // The placement_frame attributes of included child models are currently lost
   // during parsing because the parser expands the included models into the
@@ -484,10 +478,10 @@ Errors Model::Load(ElementPtr _sdf)
         // We need to update childModelFrame's pose relative to the parent
         // frame as well as the corresponding edge in the pose graph because
         // just updating childModelFrame doesn't update the pose graph.
+        // SetRawPoses does the same when the pose of childModelFrame is set.
         auto X_RM = X_RPf * X_MPf.Inverse();
         frame.SetRawPose(X_RM);
-        sdf::updateGraphPose(
-            *this->dataPtr->poseGraph, childModelFrame->Name(), X_RM);
+        sdf::updateGraphPose(*poseGraph, childModelFrame->Name(), X_RM);
       }
       else
       {
@@ -499,6 +493,9 @@ Errors Model::Load(ElementPtr _sdf)
     }
   }
 
+  // Cache the resolved poses now that the pose graph is complete.
+  sdf::cachePosesRelativeToRoot(*poseGraph);
+
   return errors;
 }
 
@@ -579,14 +576,7 @@ const Link *Model::LinkByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Model::LinkNameExists(const std::string &_name) const
 {
-  for (auto const &l : this->dataPtr->links)
-  {
-    if (l.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->linkIndex.count(_name) > 0;
 }
 
 /////////////////////////////////////////////////
@@ -606,27 +596,13 @@ const Joint *Model::JointByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Model::JointNameExists(const std::string &_name) const
 {
-  for (auto const &j : this->dataPtr->joints)
-  {
-    if (j.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->jointIndex.count(_name) > 0;
 }
 
 /////////////////////////////////////////////////
 const Joint *Model::JointByName(const std::string &_name) const
 {
-  for (auto const &j : this->dataPtr->joints)
-  {
-    if (j.Name() == _name)
-    {
-      return &j;
-    }
-  }
-  return nullptr;
+  return findByName(this->dataPtr->joints, this->dataPtr->jointIndex, _name);
 }
 
 /////////////////////////////////////////////////
@@ -646,27 +622,13 @@ const Frame *Model::FrameByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Model::FrameNameExists(const std::string &_name) const
 {
-  for (auto const &f : this->dataPtr->frames)
-  {
-    if (f.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->frameIndex.count(_name) > 0;
 }
 
 /////////////////////////////////////////////////
 const Frame *Model::FrameByName(const std::string &_name) const
 {
-  for (auto const &f : this->dataPtr->frames)
-  {
-    if (f.Name() == _name)
-    {
-      return &f;
-    }
-  }
-  return nullptr;
+  return findByName(this->dataPtr->frames, this->dataPtr->frameIndex, _name);
 }
 
 /////////////////////////////////////////////////
@@ -686,27 +648,13 @@ const Model *Model::ModelByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Model::ModelNameExists(const std::string &_name) const
 {
-  for (auto const &m : this->dataPtr->models)
-  {
-    if (m.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->modelIndex.count(_name) > 0;
 }
 
 /////////////////////////////////////////////////
 const Model *Model::ModelByName(const std::string &_name) const
 {
-  for (auto const &m : this->dataPtr->models)
-  {
-    if (m.Name() == _name)
-    {
-      return &m;
-    }
-  }
-  return nullptr;
+  return findByName(this->dataPtr->models, this->dataPtr->modelIndex, _name);
 }
 
 /////////////////////////////////////////////////
@@ -819,6 +767,41 @@ Errors Model::SetPoseRelativeToGraph(
   return errors;
 }
 
+/////////////////////////////////////////////////
+PoseRelativeToGraph *Model::PoseGraphForUpdate()
+{
+  auto &graph = this->dataPtr->poseGraph;
+  if (!graph)
+  {
+    return nullptr;
+  }
+
+  // The copies of this model that share the graph must not see the update,
+  // so this model gets its own copy of the graph first.
+  if (graph.use_count() > 1)
+  {
+    graph = std::make_shared<PoseRelativeToGraph>(*graph);
+    for (auto &link : this->dataPtr->links)
+    {
+      link.SetPoseRelativeToGraph(graph);
+    }
+    for (auto &model : this->dataPtr->models)
+    {
+      model.SetPoseRelativeToGraph(graph);
+    }
+    for (auto &joint : this->dataPtr->joints)
+    {
+      joint.SetPoseRelativeToGraph(graph);
+    }
+    for (auto &frame : this->dataPtr->frames)
+    {
+      frame.SetPoseRelativeToGraph(graph);
+    }
+  }
+
+  return graph.get();
+}
+
 /////////////////////////////////////////////////
 sdf::SemanticPose Model::SemanticPose() const
 {
@@ -830,16 +813,222 @@ sdf::SemanticPose Model::SemanticPose() const
 }
 
 /////////////////////////////////////////////////
-const Link *Model::LinkByName(const std::string &_name) const
+Errors Model::ResolveAllPoses(FramePoses &_poses,
+                              const std::string &_resolveTo) const
 {
-  for (auto const &l : this->dataPtr->links)
+  _poses.clear();
+  Errors errors =
+      this->AppendPoses(_poses, "", ignition::math::Pose3d::Zero, true);
+
+  // Nested models are appended after the frames of their parent
+  std::sort(_poses.begin(), _poses.end(),
+      [](const auto &_a, const auto &_b)
+      {
+        return _a.first < _b.first;
+      });
+
+  if (!_resolveTo.empty() && _resolveTo != "__model__")
   {
-    if (l.Name() == _name)
+    Errors resolveErrors = resolvePosesTo(_poses, _resolveTo);
+    errors.insert(errors.end(), resolveErrors.begin(), resolveErrors.end());
+  }
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors Model::SetRawPoses(const FramePoses &_poses)
+{
+  Errors errors;
+
+  if (!this->dataPtr->poseGraph)
+  {
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
+        "Model with name [" + this->Name() + "] has no PoseRelativeToGraph."});
+    return errors;
+  }
+
+  FramePoses graphPoses;
+  graphPoses.reserve(_poses.size());
+
+  // Model frames of included models whose pose is the pose of their
+  // placement frame. See the __placement_frame__ workaround in Load.
+  std::vector<std::pair<Frame *, const Frame *>> includedModelFrames;
+  FramePoses includedModelPoses;
+  const std::string modelFrameSuffix = "::__model__";
+
+  for (const auto &framePose : _poses)
+  {
+    const std::string &name = framePose.first;
+    ignition::math::Pose3d pose = framePose.second;
+    if (auto link = findByName(
+            this->dataPtr->links, this->dataPtr->linkIndex, name))
     {
-      return &l;
+      link->SetRawPose(pose);
     }
+    else if (auto joint = findByName(
+            this->dataPtr->joints, this->dataPtr->jointIndex, name))
+    {
+      joint->SetRawPose(pose);
+    }
+    else if (auto frame = findByName(
+            this->dataPtr->frames, this->dataPtr->frameIndex, name))
+    {
+      frame->SetRawPose(pose);
+
+      if (name.size() > modelFrameSuffix.size() &&
+          name.compare(name.size() - modelFrameSuffix.size(),
+                       modelFrameSuffix.size(), modelFrameSuffix) == 0)
+      {
+        auto placementFrame = findByName(this->dataPtr->frames,
+            this->dataPtr->frameIndex,
+            name.substr(0, name.size() - modelFrameSuffix.size()) +
+            "::__placement_frame__");
+        if (placementFrame)
+        {
+          // The placement frame may be relative to frames in this batch, so
+          // its pose is resolved once they're updated.
+          includedModelFrames.emplace_back(placementFrame, frame);
+          includedModelPoses.emplace_back(name, pose);
+          continue;
+        }
+      }
+    }
+    else if (auto model = findByName(
+            this->dataPtr->models, this->dataPtr->modelIndex, name))
+    {
+      Errors placementErrors =
+          model->ModelPoseFromPlacementPose(framePose.second, pose);
+      errors.insert(errors.end(), placementErrors.begin(),
+                                  placementErrors.end());
+      model->SetRawPose(pose);
+    }
+    else
+    {
+      errors.push_back({ErrorCode::POSE_RELATIVE_TO_INVALID,
+          "Model with name [" + this->Name() + "] has no link, joint, frame "
+          "or nested model with name [" + name + "]."});
+      continue;
+    }
+    graphPoses.emplace_back(name, pose);
   }
-  return nullptr;
+
+  if (graphPoses.empty() && includedModelPoses.empty())
+  {
+    return errors;
+  }
+
+  PoseRelativeToGraph *graph = this->PoseGraphForUpdate();
+  if (!graphPoses.empty())
+  {
+    Errors graphErrors = updateGraphPoses(*graph, graphPoses);
+    errors.insert(errors.end(), graphErrors.begin(), graphErrors.end());
+  }
+
+  // As in Load, the edge of an included model frame holds the pose of the
+  // model frame (X_RM), which is computed from the given pose of its
+  // placement frame (X_RPf).
+  for (std::size_t i = 0; i < includedModelFrames.size(); ++i)
+  {
+    Frame *placementFrame = includedModelFrames[i].first;
+    const Frame *modelFrame = includedModelFrames[i].second;
+    const ignition::math::Pose3d X_RPf = includedModelPoses[i].second;
+
+    ignition::math::Pose3d X_MPf;
+    Errors resolveErrors = resolvePose(X_MPf, *graph,
+        placementFrame->Name(), modelFrame->Name());
+    errors.insert(errors.end(), resolveErrors.begin(), resolveErrors.end());
+
+    auto &X_RM = includedModelPoses[i].second;
+    X_RM = X_RPf * X_MPf.Inverse();
+    placementFrame->SetRawPose(X_RM);
+  }
+
+  if (!includedModelPoses.empty())
+  {
+    Errors graphErrors = updateGraphPoses(*graph, includedModelPoses);
+    errors.insert(errors.end(), graphErrors.begin(), graphErrors.end());
+  }
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors Model::ModelPoseFromPlacementPose(
+    const ignition::math::Pose3d &_placementPose,
+    ignition::math::Pose3d &_modelPose) const
+{
+  Errors errors;
+  _modelPose = _placementPose;
+
+  if (this->dataPtr->placementFrameName.empty())
+  {
+    return errors;
+  }
+
+  if (!this->dataPtr->poseGraph)
+  {
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
+        "Model with name [" + this->Name() + "] has no PoseRelativeToGraph."});
+    return errors;
+  }
+
+  ignition::math::Pose3d X_MPf;
+  errors = sdf::resolvePose(X_MPf, *this->dataPtr->poseGraph,
+      this->dataPtr->placementFrameName, "__model__");
+  if (errors.empty())
+  {
+    // As specified in the SDFormat, the model pose (X_RPf) is the pose of
+    // the placement frame (Pf) relative to a frame (R) in the parent scope
+    // of the model. However, when this model (M) is inserted into a pose
+    // graph of the parent scope, only the pose (X_RM) of the __model__
+    // frame can be used. Thus, the model pose has to be converted to X_RM.
+    const ignition::math::Pose3d X_RPf = _placementPose;
+    _modelPose = X_RPf * X_MPf.Inverse();
+  }
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors Model::AppendPoses(FramePoses &_poses,
+                          const std::string &_prefix,
+                          const ignition::math::Pose3d &_pose,
+                          bool _includeModelFrame) const
+{
+  Errors errors;
+
+  if (!this->dataPtr->poseGraph)
+  {
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
+        "Model with name [" + this->Name() + "] has no PoseRelativeToGraph."});
+    return errors;
+  }
+
+  errors = appendPosesRelativeToRoot(_poses, *this->dataPtr->poseGraph,
+      _prefix, _pose, _includeModelFrame);
+
+  // The frames of nested models are in their own graphs
+  for (const Model &model : this->dataPtr->models)
+  {
+    ignition::math::Pose3d modelPose;
+    Errors modelErrors = resolvePoseRelativeToRoot(
+        modelPose, *this->dataPtr->poseGraph, model.Name());
+    if (modelErrors.empty())
+    {
+      modelErrors = model.AppendPoses(_poses, _prefix + model.Name() + "::",
+          _pose * modelPose, false);
+    }
+    errors.insert(errors.end(), modelErrors.begin(), modelErrors.end());
+  }
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+const Link *Model::LinkByName(const std::string &_name) const
+{
+  return findByName(this->dataPtr->links, this->dataPtr->linkIndex, _name);
 }
 
 /////////////////////////////////////////////////
@@ -847,3 +1036,37 @@ sdf::ElementPtr Model::Element() const
 {
   return this->dataPtr->sdf;
 }
+
+/////////////////////////////////////////////////
+bool Model::FrameAttachedToGraphErrors(Errors &_buildErrors,
+                                       Errors &_validateErrors) const
+{
+  if (!this->dataPtr->frameAttachedToGraph)
+  {
+    return false;
+  }
+  _buildErrors.insert(_buildErrors.end(),
+      this->dataPtr->frameAttachedToGraphBuildErrors.begin(),
+      this->dataPtr->frameAttachedToGraphBuildErrors.end());
+  _validateErrors.insert(_validateErrors.end(),
+      this->dataPtr->frameAttachedToGraphValidateErrors.begin(),
+      this->dataPtr->frameAttachedToGraphValidateErrors.end());
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool Model::PoseRelativeToGraphErrors(Errors &_buildErrors,
+                                      Errors &_validateErrors) const
+{
+  if (!this->dataPtr->poseGraph)
+  {
+    return false;
+  }
+  _buildErrors.insert(_buildErrors.end(),
+      this->dataPtr->poseGraphBuildErrors.begin(),
+      this->dataPtr->poseGraphBuildErrors.end());
+  _validateErrors.insert(_validateErrors.end(),
+      this->dataPtr->poseGraphValidateErrors.begin(),
+      this->dataPtr->poseGraphValidateErrors.end());
+  return true;
+}
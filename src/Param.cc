@@ -17,12 +17,15 @@
 
 #include <algorithm>
 #include <cctype>
+#include <charconv>
 #include <cstdint>
 #include <locale>
 #include <sstream>
 #include <string>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
 
-#include <locale.h>
 #include <math.h>
 
 #include "sdf/Assert.hh"
@@ -56,6 +59,43 @@ namespace sdf
   }
 }
 
+//////////////////////////////////////////////////
+/// \brief Get the type of value described by a parameter type name.
+/// \param[in] _typeName Name of the type.
+/// \return The value type, or ValueType::UNKNOWN if the name isn't known.
+static ParamPrivate::ValueType valueTypeFromName(const std::string &_typeName)
+{
+  using ValueType = ParamPrivate::ValueType;
+  static const std::unordered_map<std::string, ValueType> valueTypes = {
+    {"bool", ValueType::BOOL},
+    {"char", ValueType::CHAR},
+    {"std::string", ValueType::STRING},
+    {"string", ValueType::STRING},
+    {"int", ValueType::INT},
+    {"uint64_t", ValueType::UINT64},
+    {"unsigned int", ValueType::UNSIGNED_INT},
+    {"double", ValueType::DOUBLE},
+    {"float", ValueType::FLOAT},
+    {"sdf::Time", ValueType::TIME},
+    {"time", ValueType::TIME},
+    {"ignition::math::Color", ValueType::COLOR},
+    {"color", ValueType::COLOR},
+    {"ignition::math::Vector2i", ValueType::VECTOR2I},
+    {"vector2i", ValueType::VECTOR2I},
+    {"ignition::math::Vector2d", ValueType::VECTOR2D},
+    {"vector2d", ValueType::VECTOR2D},
+    {"ignition::math::Vector3d", ValueType::VECTOR3D},
+    {"vector3", ValueType::VECTOR3D},
+    {"ignition::math::Pose3d", ValueType::POSE3D},
+    {"pose", ValueType::POSE3D},
+    {"Pose", ValueType::POSE3D},
+    {"ignition::math::Quaterniond", ValueType::QUATERNIOND},
+    {"quaternion", ValueType::QUATERNIOND}};
+
+  auto iter = valueTypes.find(_typeName);
+  return iter != valueTypes.end() ? iter->second : ValueType::UNKNOWN;
+}
+
 //////////////////////////////////////////////////
 Param::Param(const std::string &_key, const std::string &_typeName,
              const std::string &_default, bool _required,
@@ -65,6 +105,7 @@ Param::Param(const std::string &_key, const std::string &_typeName,
   this->dataPtr->key = _key;
   this->dataPtr->required = _required;
   this->dataPtr->typeName = _typeName;
+  this->dataPtr->valueType = valueTypeFromName(_typeName);
   this->dataPtr->description = _description;
   this->dataPtr->set = false;
 
@@ -359,13 +400,99 @@ bool ParseUsingStringStream(const std::string &_input, const std::string &_key,
   return true;
 }
 
+//////////////////////////////////////////////////
+/// \brief Parse a number at the start of a character range. Leading
+/// whitespace and a leading plus sign are skipped, as the standard streams
+/// do. The parsing doesn't depend on the C or C++ locale.
+/// \param[in] _first Start of the range.
+/// \param[in] _last End of the range.
+/// \param[out] _value This will be set with the parsed value.
+/// \param[in] _hex True to parse a hexadecimal number without its "0x"
+/// prefix.
+/// \return Result of std::from_chars.
+template <typename T>
+std::from_chars_result ParseNumber(const char *_first, const char *_last,
+                                   T &_value, bool _hex = false)
+{
+  while (_first != _last && std::isspace(static_cast<unsigned char>(*_first)))
+  {
+    ++_first;
+  }
+
+  // std::from_chars doesn't accept a leading plus sign
+  if (_last - _first > 1 && _first[0] == '+' && _first[1] != '-')
+  {
+    ++_first;
+  }
+
+  if constexpr (std::is_floating_point_v<T>)
+  {
+    return std::from_chars(_first, _last, _value,
+        _hex ? std::chars_format::hex : std::chars_format::general);
+  }
+  else
+  {
+    return std::from_chars(_first, _last, _value, _hex ? 16 : 10);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Helper function for Param::ValueFromString that parses a single
+/// number the way std::stoi and std::stod do, ignoring any trailing
+/// characters.
+/// \param[in] _input Input string.
+/// \param[in] _isHex True if the input starts with "0x".
+/// \param[out] _value This will be set with the parsed value.
+/// \return std::errc() if parsing succeeded, the error otherwise.
+template <typename T>
+std::errc ParseScalar(const std::string &_input, bool _isHex, T &_value)
+{
+  const char *first = _input.data();
+  const char *last = first + _input.size();
+  if (_isHex)
+  {
+    first += 2;
+  }
+  return ParseNumber(first, last, _value, _isHex).ec;
+}
+
+//////////////////////////////////////////////////
+/// \brief Helper function for Param::ValueFromString that parses
+/// whitespace separated numbers, such as the components of a vector.
+/// \param[in] _input Input string.
+/// \param[out] _values Array that will be set with the parsed values.
+/// \param[in] _count Maximum number of values to parse.
+/// \param[out] _end If not null, set to the position in _input after the
+/// last parsed value.
+/// \return Number of values that were parsed.
+template <typename T>
+std::size_t ParseNumbers(const std::string &_input, T *_values,
+                         std::size_t _count, std::size_t *_end = nullptr)
+{
+  const char *first = _input.data();
+  const char *last = first + _input.size();
+  std::size_t parsed = 0;
+  for (; parsed < _count; ++parsed)
+  {
+    auto result = ParseNumber(first, last, _values[parsed]);
+    if (result.ec != std::errc())
+    {
+      break;
+    }
+    first = result.ptr;
+  }
+  if (_end)
+  {
+    *_end = static_cast<std::size_t>(first - _input.data());
+  }
+  return parsed;
+}
+
 //////////////////////////////////////////////////
 bool Param::ValueFromString(const std::string &_value)
 {
-  // Under some circumstances, latin locales (es_ES or pt_BR) will return a
-  // comma for decimal position instead of a dot, making the conversion
-  // to fail. See bug #60 for more information. Force to use always C
-  setlocale(LC_NUMERIC, "C");
+  using ValueType = ParamPrivate::ValueType;
+
   std::string trimmed = sdf::trim(_value);
   std::string tmp(trimmed);
   std::string lowerTmp = lowercase(trimmed);
@@ -382,17 +509,14 @@ bool Param::ValueFromString(const std::string &_value)
 
   bool isHex = lowerTmp.compare(0, 2, "0x") == 0;
 
-  try
+  // Numbers are parsed with std::from_chars, which always uses a decimal
+  // point regardless of the locale. See issues
+  // https://github.com/osrf/sdformat/issues/60 and
+  // https://github.com/osrf/sdformat/issues/207.
+  std::errc error = std::errc();
+  switch (this->dataPtr->valueType)
   {
-    // Try to use stoi and stoul for integers, and
-    // stof and stod for scalar floating point values.
-    int numericBase = 10;
-    if (isHex)
-    {
-      numericBase = 16;
-    }
-
-    if (this->dataPtr->typeName == "bool")
+    case ValueType::BOOL:
     {
       if (lowerTmp == "true" || lowerTmp == "1")
       {
@@ -407,116 +531,171 @@ bool Param::ValueFromString(const std::string &_value)
         sdferr << "Invalid boolean value\n";
         return false;
       }
+      break;
     }
-    else if (this->dataPtr->typeName == "char")
+    case ValueType::CHAR:
     {
       this->dataPtr->value = tmp[0];
+      break;
     }
-    else if (this->dataPtr->typeName == "std::string" ||
-             this->dataPtr->typeName == "string")
+    case ValueType::STRING:
     {
       this->dataPtr->value = tmp;
+      break;
     }
-    else if (this->dataPtr->typeName == "int")
+    case ValueType::INT:
     {
-      this->dataPtr->value = std::stoi(tmp, nullptr, numericBase);
+      int value = 0;
+      error = ParseScalar(tmp, isHex, value);
+      if (error == std::errc())
+      {
+        this->dataPtr->value = value;
+      }
+      break;
     }
-    else if (this->dataPtr->typeName == "uint64_t")
+    case ValueType::UINT64:
     {
       return ParseUsingStringStream<std::uint64_t>(tmp, this->dataPtr->key,
                                                    this->dataPtr->value);
     }
-    else if (this->dataPtr->typeName == "unsigned int")
+    case ValueType::UNSIGNED_INT:
     {
-      this->dataPtr->value = static_cast<unsigned int>(
-          std::stoul(tmp, nullptr, numericBase));
+      unsigned int value = 0;
+      error = ParseScalar(tmp, isHex, value);
+      if (error == std::errc())
+      {
+        this->dataPtr->value = value;
+      }
+      break;
     }
-    else if (this->dataPtr->typeName == "double")
+    case ValueType::DOUBLE:
     {
-      this->dataPtr->value = std::stod(tmp);
+      double value = 0;
+      error = ParseScalar(tmp, isHex, value);
+      if (error == std::errc())
+      {
+        this->dataPtr->value = value;
+      }
+      break;
     }
-    else if (this->dataPtr->typeName == "float")
+    case ValueType::FLOAT:
     {
-      this->dataPtr->value = std::stof(tmp);
+      float value = 0;
+      error = ParseScalar(tmp, isHex, value);
+      if (error == std::errc())
+      {
+        this->dataPtr->value = value;
+      }
+      break;
     }
-    else if (this->dataPtr->typeName == "sdf::Time" ||
-             this->dataPtr->typeName == "time")
+    case ValueType::TIME:
     {
       return ParseUsingStringStream<sdf::Time>(tmp, this->dataPtr->key,
                                                this->dataPtr->value);
     }
-    else if (this->dataPtr->typeName == "ignition::math::Color" ||
-             this->dataPtr->typeName == "color")
+    case ValueType::COLOR:
     {
-      // The insertion operator (>>) expects 4 values, but the last value (the
-      // alpha) is optional. We first try to parse assuming the alpha is
-      // specified. If that fails, we append the default value of alpha to the
-      // string and try to parse again.
-      bool result = ParseUsingStringStream<ignition::math::Color>(
-          tmp, this->dataPtr->key, this->dataPtr->value);
-
-      if (!result)
+      // The alpha value is optional, but anything after the blue value
+      // must be a valid alpha value.
+      ignition::math::Color color;
+      float rgba[4] = {0, 0, 0, color.A()};
+      std::size_t end = 0;
+      const std::size_t parsed = ParseNumbers(tmp, rgba, 4, &end);
+      if (parsed < 3 || (parsed == 3 &&
+          tmp.find_first_not_of(" \t\n\v\f\r", end) != std::string::npos))
       {
-        ignition::math::Color colortmp;
-        return ParseUsingStringStream<ignition::math::Color>(
-            tmp + " " + std::to_string(colortmp.A()), this->dataPtr->key,
-            this->dataPtr->value);
+        error = std::errc::invalid_argument;
+        break;
       }
-      else
-        return true;
-    }
-    else if (this->dataPtr->typeName == "ignition::math::Vector2i" ||
-             this->dataPtr->typeName == "vector2i")
-    {
-      return ParseUsingStringStream<ignition::math::Vector2i>(
-          tmp, this->dataPtr->key, this->dataPtr->value);
+      // Set the components directly, since the constructor clamps them
+      color.R(rgba[0]);
+      color.G(rgba[1]);
+      color.B(rgba[2]);
+      color.A(rgba[3]);
+      this->dataPtr->value = color;
+      break;
+    }
+    case ValueType::VECTOR2I:
+    {
+      int xy[2];
+      if (ParseNumbers(tmp, xy, 2) < 2)
+      {
+        error = std::errc::invalid_argument;
+        break;
+      }
+      this->dataPtr->value = ignition::math::Vector2i(xy[0], xy[1]);
+      break;
     }
-    else if (this->dataPtr->typeName == "ignition::math::Vector2d" ||
-             this->dataPtr->typeName == "vector2d")
+    case ValueType::VECTOR2D:
     {
-      return ParseUsingStringStream<ignition::math::Vector2d>(
-          tmp, this->dataPtr->key, this->dataPtr->value);
+      double xy[2];
+      if (ParseNumbers(tmp, xy, 2) < 2)
+      {
+        error = std::errc::invalid_argument;
+        break;
+      }
+      this->dataPtr->value = ignition::math::Vector2d(xy[0], xy[1]);
+      break;
     }
-    else if (this->dataPtr->typeName == "ignition::math::Vector3d" ||
-             this->dataPtr->typeName == "vector3")
+    case ValueType::VECTOR3D:
     {
-      return ParseUsingStringStream<ignition::math::Vector3d>(
-          tmp, this->dataPtr->key, this->dataPtr->value);
+      double xyz[3];
+      if (ParseNumbers(tmp, xyz, 3) < 3)
+      {
+        error = std::errc::invalid_argument;
+        break;
+      }
+      this->dataPtr->value = ignition::math::Vector3d(xyz[0], xyz[1], xyz[2]);
+      break;
     }
-    else if (this->dataPtr->typeName == "ignition::math::Pose3d" ||
-             this->dataPtr->typeName == "pose" ||
-             this->dataPtr->typeName == "Pose")
+    case ValueType::POSE3D:
     {
-      if (!tmp.empty())
+      // An empty pose leaves the value unchanged
+      if (tmp.empty())
       {
-        return ParseUsingStringStream<ignition::math::Pose3d>(
-            tmp, this->dataPtr->key, this->dataPtr->value);
+        break;
       }
+      double pose[6];
+      if (ParseNumbers(tmp, pose, 6) < 6)
+      {
+        error = std::errc::invalid_argument;
+        break;
+      }
+      this->dataPtr->value = ignition::math::Pose3d(
+          pose[0], pose[1], pose[2], pose[3], pose[4], pose[5]);
+      break;
     }
-    else if (this->dataPtr->typeName == "ignition::math::Quaterniond" ||
-             this->dataPtr->typeName == "quaternion")
+    case ValueType::QUATERNIOND:
     {
-      return ParseUsingStringStream<ignition::math::Quaterniond>(
-          tmp, this->dataPtr->key, this->dataPtr->value);
+      // Quaternions are given as roll, pitch and yaw angles
+      double rpy[3];
+      if (ParseNumbers(tmp, rpy, 3) < 3)
+      {
+        error = std::errc::invalid_argument;
+        break;
+      }
+      this->dataPtr->value =
+          ignition::math::Quaterniond(rpy[0], rpy[1], rpy[2]);
+      break;
     }
-    else
+    case ValueType::UNKNOWN:
+    default:
     {
       sdferr << "Unknown parameter type[" << this->dataPtr->typeName << "]\n";
       return false;
     }
   }
-  // Catch invalid argument exception from std::stoi/stoul/stod/stof
-  catch(std::invalid_argument &)
+
+  if (error == std::errc::result_out_of_range)
   {
-    sdferr << "Invalid argument. Unable to set value ["
+    sdferr << "Out of range. Unable to set value ["
            << _value << " ] for key["
            << this->dataPtr->key << "].\n";
     return false;
   }
-  // Catch out of range exception from std::stoi/stoul/stod/stof
-  catch(std::out_of_range &)
+  else if (error != std::errc())
   {
-    sdferr << "Out of range. Unable to set value ["
+    sdferr << "Invalid argument. Unable to set value ["
            << _value << " ] for key["
            << this->dataPtr->key << "].\n";
     return false;
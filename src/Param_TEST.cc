@@ -283,6 +283,68 @@ TEST(Param, Vector2i)
   EXPECT_EQ(value, ignition::math::Vector2i(0, 0));
 }
 
+////////////////////////////////////////////////////
+TEST(Param, Vector3d)
+{
+  sdf::Param vect3Param("key", "vector3", "0 0 0", false, "description");
+  ignition::math::Vector3d value;
+
+  EXPECT_TRUE(vect3Param.SetFromString(" 1.5  -2e1\t+3 "));
+  EXPECT_TRUE(vect3Param.Get<ignition::math::Vector3d>(value));
+  EXPECT_EQ(ignition::math::Vector3d(1.5, -20, 3), value);
+
+  // Missing or invalid components leave the value unchanged
+  EXPECT_FALSE(vect3Param.SetFromString("1 2"));
+  EXPECT_FALSE(vect3Param.SetFromString("1,5 2 3"));
+  EXPECT_FALSE(vect3Param.SetFromString("1 a 3"));
+  EXPECT_TRUE(vect3Param.Get<ignition::math::Vector3d>(value));
+  EXPECT_EQ(ignition::math::Vector3d(1.5, -20, 3), value);
+}
+
+////////////////////////////////////////////////////
+TEST(Param, Pose3d)
+{
+  sdf::Param poseParam("key", "pose", "0 0 0 0 0 0", false, "description");
+  ignition::math::Pose3d value;
+
+  EXPECT_TRUE(poseParam.SetFromString("1 2 3 0.1 0.2 0.3"));
+  EXPECT_TRUE(poseParam.Get<ignition::math::Pose3d>(value));
+  EXPECT_EQ(ignition::math::Pose3d(1, 2, 3, 0.1, 0.2, 0.3), value);
+
+  EXPECT_FALSE(poseParam.SetFromString("1 2 3 0.1 0.2"));
+  EXPECT_TRUE(poseParam.Get<ignition::math::Pose3d>(value));
+  EXPECT_EQ(ignition::math::Pose3d(1, 2, 3, 0.1, 0.2, 0.3), value);
+
+  sdf::Param quatParam("key", "quaternion", "0 0 0", false, "description");
+  ignition::math::Quaterniond quat;
+  EXPECT_TRUE(quatParam.SetFromString("0.1 0.2 0.3"));
+  EXPECT_TRUE(quatParam.Get<ignition::math::Quaterniond>(quat));
+  EXPECT_EQ(ignition::math::Quaterniond(0.1, 0.2, 0.3), quat);
+}
+
+////////////////////////////////////////////////////
+TEST(Param, Color)
+{
+  sdf::Param colorParam("key", "color", "0 0 0 1", false, "description");
+  ignition::math::Color value;
+
+  EXPECT_TRUE(colorParam.SetFromString("0.1 0.2 0.3 0.4"));
+  EXPECT_TRUE(colorParam.Get<ignition::math::Color>(value));
+  EXPECT_EQ(ignition::math::Color(0.1f, 0.2f, 0.3f, 0.4f), value);
+
+  // The alpha value is optional
+  EXPECT_TRUE(colorParam.SetFromString("0.5 0.6 0.7"));
+  EXPECT_TRUE(colorParam.Get<ignition::math::Color>(value));
+  EXPECT_EQ(ignition::math::Color(0.5f, 0.6f, 0.7f, 1.0f), value);
+
+  EXPECT_FALSE(colorParam.SetFromString("0.5 0.6"));
+
+  // An alpha value that isn't a number is rejected
+  EXPECT_FALSE(colorParam.SetFromString("0.1 0.2 0.3 invalid"));
+  EXPECT_TRUE(colorParam.Get<ignition::math::Color>(value));
+  EXPECT_EQ(ignition::math::Color(0.5f, 0.6f, 0.7f, 1.0f), value);
+}
+
 ////////////////////////////////////////////////////
 TEST(Param, InvalidConstructor)
 {
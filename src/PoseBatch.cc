@@ -0,0 +1,224 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <vector>
+
+#include "PoseBatch.hh"
+
+namespace sdf
+{
+inline namespace SDF_VERSION_NAMESPACE
+{
+/// \brief Number of poses composed by one call to composeBlock.
+static constexpr std::size_t kBlockSize = 64;
+
+/// \brief A block of poses stored as a structure of arrays. Blocks are
+/// local arrays, so the compiler knows that they don't overlap.
+struct PoseBlock
+{
+  double x[kBlockSize];
+  double y[kBlockSize];
+  double z[kBlockSize];
+  double qw[kBlockSize];
+  double qx[kBlockSize];
+  double qy[kBlockSize];
+  double qz[kBlockSize];
+};
+
+/////////////////////////////////////////////////
+std::size_t PoseArrays::Size() const
+{
+  return this->x.size();
+}
+
+/////////////////////////////////////////////////
+void PoseArrays::Resize(std::size_t _size)
+{
+  this->x.resize(_size, 0.0);
+  this->y.resize(_size, 0.0);
+  this->z.resize(_size, 0.0);
+  this->qw.resize(_size, 1.0);
+  this->qx.resize(_size, 0.0);
+  this->qy.resize(_size, 0.0);
+  this->qz.resize(_size, 0.0);
+}
+
+/////////////////////////////////////////////////
+void PoseArrays::Set(std::size_t _index, const ignition::math::Pose3d &_pose)
+{
+  this->x[_index] = _pose.Pos().X();
+  this->y[_index] = _pose.Pos().Y();
+  this->z[_index] = _pose.Pos().Z();
+  this->qw[_index] = _pose.Rot().W();
+  this->qx[_index] = _pose.Rot().X();
+  this->qy[_index] = _pose.Rot().Y();
+  this->qz[_index] = _pose.Rot().Z();
+}
+
+/////////////////////////////////////////////////
+ignition::math::Pose3d PoseArrays::Pose(std::size_t _index) const
+{
+  return ignition::math::Pose3d(
+      this->x[_index], this->y[_index], this->z[_index],
+      this->qw[_index], this->qx[_index], this->qy[_index], this->qz[_index]);
+}
+
+/////////////////////////////////////////////////
+/// \brief Copy poses from arrays to a block.
+/// \param[in] _poses Arrays to copy from.
+/// \param[in] _begin Index of the first pose to copy.
+/// \param[in] _count Number of poses.
+/// \param[out] _block Block to copy to.
+static void loadBlock(const PoseArrays &_poses, std::size_t _begin,
+                      std::size_t _count, PoseBlock &_block)
+{
+  std::copy_n(_poses.x.begin() + _begin, _count, _block.x);
+  std::copy_n(_poses.y.begin() + _begin, _count, _block.y);
+  std::copy_n(_poses.z.begin() + _begin, _count, _block.z);
+  std::copy_n(_poses.qw.begin() + _begin, _count, _block.qw);
+  std::copy_n(_poses.qx.begin() + _begin, _count, _block.qx);
+  std::copy_n(_poses.qy.begin() + _begin, _count, _block.qy);
+  std::copy_n(_poses.qz.begin() + _begin, _count, _block.qz);
+}
+
+/////////////////////////////////////////////////
+/// \brief Copy the poses of parents from arrays to a block.
+/// \param[in] _poses Arrays to copy from.
+/// \param[in] _parents Indices of the parents.
+/// \param[in] _begin Index in _parents of the first parent.
+/// \param[in] _count Number of poses.
+/// \param[out] _block Block to copy to.
+static void gatherBlock(const PoseArrays &_poses,
+                        const std::vector<std::size_t> &_parents,
+                        std::size_t _begin, std::size_t _count,
+                        PoseBlock &_block)
+{
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    const std::size_t parent = _parents[_begin + i];
+    _block.x[i] = _poses.x[parent];
+    _block.y[i] = _poses.y[parent];
+    _block.z[i] = _poses.z[parent];
+    _block.qw[i] = _poses.qw[parent];
+    _block.qx[i] = _poses.qx[parent];
+    _block.qy[i] = _poses.qy[parent];
+    _block.qz[i] = _poses.qz[parent];
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Copy poses from a block to arrays.
+/// \param[in] _block Block to copy from.
+/// \param[in] _begin Index of the first pose to copy to.
+/// \param[in] _count Number of poses.
+/// \param[in,out] _poses Arrays to copy to.
+static void storeBlock(const PoseBlock &_block, std::size_t _begin,
+                       std::size_t _count, PoseArrays &_poses)
+{
+  std::copy_n(_block.x, _count, _poses.x.begin() + _begin);
+  std::copy_n(_block.y, _count, _poses.y.begin() + _begin);
+  std::copy_n(_block.z, _count, _poses.z.begin() + _begin);
+  std::copy_n(_block.qw, _count, _poses.qw.begin() + _begin);
+  std::copy_n(_block.qx, _count, _poses.qx.begin() + _begin);
+  std::copy_n(_block.qy, _count, _poses.qy.begin() + _begin);
+  std::copy_n(_block.qz, _count, _poses.qz.begin() + _begin);
+}
+
+/////////////////////////////////////////////////
+/// \brief Compose a block of poses, X_OQ = X_OP * X_PQ, which is the same
+/// as ignition::math::Pose3d::operator*. The loop has no branches and no
+/// dependencies between iterations, so it can be vectorized.
+/// \param[in] _parent Poses X_OP.
+/// \param[in] _relative Poses X_PQ.
+/// \param[in] _count Number of poses.
+/// \param[out] _result Poses X_OQ.
+static void composeBlock(const PoseBlock &_parent, const PoseBlock &_relative,
+                         std::size_t _count, PoseBlock &_result)
+{
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    const double pw = _parent.qw[i];
+    const double px = _parent.qx[i];
+    const double py = _parent.qy[i];
+    const double pz = _parent.qz[i];
+    const double rw = _relative.qw[i];
+    const double rx = _relative.qx[i];
+    const double ry = _relative.qy[i];
+    const double rz = _relative.qz[i];
+    const double vx = _relative.x[i];
+    const double vy = _relative.y[i];
+    const double vz = _relative.z[i];
+
+    // Rotate the relative position by the parent rotation:
+    // v' = v + w t + u x t, with u the vector part and t = 2 u x v
+    const double tx = 2.0 * (py * vz - pz * vy);
+    const double ty = 2.0 * (pz * vx - px * vz);
+    const double tz = 2.0 * (px * vy - py * vx);
+    _result.x[i] = _parent.x[i] + vx + pw * tx + (py * tz - pz * ty);
+    _result.y[i] = _parent.y[i] + vy + pw * ty + (pz * tx - px * tz);
+    _result.z[i] = _parent.z[i] + vz + pw * tz + (px * ty - py * tx);
+
+    // Hamilton product of the rotations
+    _result.qw[i] = pw * rw - px * rx - py * ry - pz * rz;
+    _result.qx[i] = pw * rx + px * rw + py * rz - pz * ry;
+    _result.qy[i] = pw * ry - px * rz + py * rw + pz * rx;
+    _result.qz[i] = pw * rz + px * ry - py * rx + pz * rw;
+  }
+}
+
+/////////////////////////////////////////////////
+void composePoses(
+    const PoseArrays &_relative,
+    const std::vector<std::size_t> &_parents,
+    const std::vector<std::size_t> &_depthOffsets,
+    PoseArrays &_poses)
+{
+  _poses.Resize(_relative.Size());
+  if (_depthOffsets.size() < 2)
+  {
+    return;
+  }
+
+  // The poses of the roots are already relative to the frame of the roots
+  PoseBlock parent;
+  PoseBlock relative;
+  PoseBlock result;
+  for (std::size_t begin = 0; begin < _depthOffsets[1]; begin += kBlockSize)
+  {
+    const std::size_t count = std::min(kBlockSize, _depthOffsets[1] - begin);
+    loadBlock(_relative, begin, count, result);
+    storeBlock(result, begin, count, _poses);
+  }
+
+  // The parents of each depth are at lower depths, which are done
+  for (std::size_t depth = 1; depth + 1 < _depthOffsets.size(); ++depth)
+  {
+    const std::size_t end = _depthOffsets[depth + 1];
+    for (std::size_t begin = _depthOffsets[depth]; begin < end;
+         begin += kBlockSize)
+    {
+      const std::size_t count = std::min(kBlockSize, end - begin);
+      gatherBlock(_poses, _parents, begin, count, parent);
+      loadBlock(_relative, begin, count, relative);
+      composeBlock(parent, relative, count, result);
+      storeBlock(result, begin, count, _poses);
+    }
+  }
+}
+}
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDFORMAT_POSEBATCH_HH_
+#define SDFORMAT_POSEBATCH_HH_
+
+#include <cstddef>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
+
+#include "sdf/sdf_config.h"
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  /// \brief Poses stored as a structure of arrays, with one array per
+  /// coordinate, so that batches of poses can be composed by loops that the
+  /// compiler can vectorize.
+  class PoseArrays
+  {
+    /// \brief Get the number of poses.
+    /// \return Number of poses.
+    public: std::size_t Size() const;
+
+    /// \brief Set the number of poses. New poses are identities.
+    /// \param[in] _size Number of poses.
+    public: void Resize(std::size_t _size);
+
+    /// \brief Set a pose.
+    /// \param[in] _index Index of the pose.
+    /// \param[in] _pose Value of the pose.
+    public: void Set(std::size_t _index, const ignition::math::Pose3d &_pose);
+
+    /// \brief Get a pose.
+    /// \param[in] _index Index of the pose.
+    /// \return Value of the pose.
+    public: ignition::math::Pose3d Pose(std::size_t _index) const;
+
+    /// \brief Positions.
+    public: std::vector<double> x, y, z;
+
+    /// \brief Rotations, as unit quaternions.
+    public: std::vector<double> qw, qx, qy, qz;
+  };
+
+  /// \brief Compose the poses of the vertices of a forest with the poses of
+  /// their parents, which gives the pose of every vertex relative to the
+  /// frame of the roots. The vertices are sorted by depth, so that each
+  /// depth is a contiguous range whose parents are all at lower depths.
+  /// Each range is composed by a loop over contiguous arrays, without
+  /// dependencies between iterations.
+  /// \param[in] _relative Pose of each vertex relative to its parent, or
+  /// relative to the frame of the roots for the roots.
+  /// \param[in] _parents Index of the parent of each vertex. It's ignored
+  /// for the roots.
+  /// \param[in] _depthOffsets Index of the first vertex of each depth,
+  /// followed by the number of vertices. The roots are the vertices of the
+  /// first depth.
+  /// \param[out] _poses Pose of each vertex relative to the frame of the
+  /// roots.
+  void composePoses(
+      const PoseArrays &_relative,
+      const std::vector<std::size_t> &_parents,
+      const std::vector<std::size_t> &_depthOffsets,
+      PoseArrays &_poses);
+  }
+}
+#endif
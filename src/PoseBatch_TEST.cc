@@ -0,0 +1,96 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
+
+#include "PoseBatch.hh"
+
+using Pose = ignition::math::Pose3d;
+
+/////////////////////////////////////////////////
+TEST(PoseBatch, PoseArrays)
+{
+  sdf::PoseArrays poses;
+  EXPECT_EQ(0u, poses.Size());
+
+  poses.Resize(2);
+  EXPECT_EQ(2u, poses.Size());
+  EXPECT_EQ(Pose::Zero, poses.Pose(0));
+  EXPECT_EQ(Pose::Zero, poses.Pose(1));
+
+  poses.Set(1, Pose(1, 2, 3, 0.1, 0.2, 0.3));
+  EXPECT_EQ(Pose::Zero, poses.Pose(0));
+  EXPECT_EQ(Pose(1, 2, 3, 0.1, 0.2, 0.3), poses.Pose(1));
+}
+
+/////////////////////////////////////////////////
+TEST(PoseBatch, Empty)
+{
+  sdf::PoseArrays relative;
+  sdf::PoseArrays poses;
+  composePoses(relative, {}, {}, poses);
+  EXPECT_EQ(0u, poses.Size());
+
+  composePoses(relative, {}, {0}, poses);
+  EXPECT_EQ(0u, poses.Size());
+}
+
+/////////////////////////////////////////////////
+TEST(PoseBatch, ComposePoses)
+{
+  // A forest with two roots, sorted by depth. The widest depth is larger
+  // than the blocks that are composed at once.
+  std::vector<std::size_t> parents = {0, 0};
+  std::vector<std::size_t> depthOffsets = {0, 2};
+  for (std::size_t depth = 1; depth < 6; ++depth)
+  {
+    const std::size_t begin = depthOffsets[depth - 1];
+    const std::size_t end = depthOffsets[depth];
+    const std::size_t width = depth * 41;
+    for (std::size_t i = 0; i < width; ++i)
+    {
+      parents.push_back(begin + (i * 7) % (end - begin));
+    }
+    depthOffsets.push_back(parents.size());
+  }
+
+  sdf::PoseArrays relative;
+  relative.Resize(parents.size());
+  for (std::size_t i = 0; i < parents.size(); ++i)
+  {
+    const double d = static_cast<double>(i);
+    relative.Set(i, Pose(0.1 * d, 1.0 - 0.2 * d, 0.3,
+                         0.01 * d, -0.02 * d, 0.5 + 0.03 * d));
+  }
+
+  sdf::PoseArrays poses;
+  composePoses(relative, parents, depthOffsets, poses);
+  ASSERT_EQ(parents.size(), poses.Size());
+
+  // Compare with poses composed one at a time
+  std::vector<Pose> expected(parents.size());
+  for (std::size_t i = 0; i < parents.size(); ++i)
+  {
+    expected[i] = i < depthOffsets[1] ?
+        relative.Pose(i) : expected[parents[i]] * relative.Pose(i);
+    EXPECT_EQ(expected[i], poses.Pose(i)) << i;
+  }
+}
@@ -26,6 +26,8 @@
 #include "sdf/World.hh"
 #include "sdf/parser.hh"
 #include "sdf/sdf_config.h"
+#include "FrameSemantics.hh"
+#include "InstrumentationPrivate.hh"
 #include "Utils.hh"
 
 using namespace sdf;
@@ -48,6 +50,12 @@ class sdf::RootPrivate
   /// \brief The actors specified under the root SDF element
   public: std::vector<Actor> actors;
 
+  /// \brief Indices of the worlds, models, lights and actors by name.
+  public: NameIndex worldIndex;
+  public: NameIndex modelIndex;
+  public: NameIndex lightIndex;
+  public: NameIndex actorIndex;
+
   /// \brief The SDF element pointer generated during load.
   public: sdf::ElementPtr sdf;
 };
@@ -112,6 +120,7 @@ Errors Root::LoadSdfString(const std::string &_sdf)
 Errors Root::Load(SDFPtr _sdf)
 {
   Errors errors;
+  ScopedLoadTimer timer(LoadPhase::DOM_LOAD, _sdf->FilePath());
 
   this->dataPtr->sdf = _sdf->Root();
 
@@ -155,7 +164,8 @@ Errors Root::Load(SDFPtr _sdf)
       if (worldErrors.empty())
       {
         // Check that the world's name does not exist.
-        if (this->WorldNameExists(world.Name()))
+        if (!this->dataPtr->worldIndex.emplace(
+              world.Name(), this->dataPtr->worlds.size()).second)
         {
           errors.push_back({ErrorCode::DUPLICATE_NAME,
                 "World with name[" + world.Name() + "] already exists."
@@ -192,6 +202,13 @@ Errors Root::Load(SDFPtr _sdf)
       "actor", this->dataPtr->actors);
   errors.insert(errors.end(), actorLoadErrors.begin(), actorLoadErrors.end());
 
+  this->dataPtr->modelIndex = buildNameIndex(this->dataPtr->models);
+  this->dataPtr->lightIndex = buildNameIndex(this->dataPtr->lights);
+  this->dataPtr->actorIndex = buildNameIndex(this->dataPtr->actors);
+
+  timer.SetCount(this->dataPtr->worlds.size() + this->dataPtr->models.size() +
+      this->dataPtr->lights.size() + this->dataPtr->actors.size());
+
   return errors;
 }
 
@@ -224,14 +241,7 @@ const World *Root::WorldByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Root::WorldNameExists(const std::string &_name) const
 {
-  for (auto const &w : this->dataPtr->worlds)
-  {
-    if (w.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->worldIndex.count(_name) > 0;
 }
 
 /////////////////////////////////////////////////
@@ -251,14 +261,7 @@ const Model *Root::ModelByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Root::ModelNameExists(const std::string &_name) const
 {
-  for (auto const &m : this->dataPtr->models)
-  {
-    if (m.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->modelIndex.count(_name) > 0;
 }
 
 /////////////////////////////////////////////////
@@ -278,14 +281,7 @@ const Light *Root::LightByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Root::LightNameExists(const std::string &_name) const
 {
-  for (auto const &m : this->dataPtr->lights)
-  {
-    if (m.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->lightIndex.count(_name) > 0;
 }
 
 /////////////////////////////////////////////////
@@ -305,18 +301,83 @@ const Actor *Root::ActorByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Root::ActorNameExists(const std::string &_name) const
 {
-  for (auto const &m : this->dataPtr->actors)
+  return this->dataPtr->actorIndex.count(_name) > 0;
+}
+
+/////////////////////////////////////////////////
+sdf::ElementPtr Root::Element() const
+{
+  return this->dataPtr->sdf;
+}
+
+/////////////////////////////////////////////////
+void Root::FrameAttachedToGraphErrors(Errors &_buildErrors,
+                                      Errors &_validateErrors) const
+{
+  _buildErrors.clear();
+  _validateErrors.clear();
+
+  auto appendGraphErrors = [&](const auto &_object)
+  {
+    if (!_object.FrameAttachedToGraphErrors(_buildErrors, _validateErrors))
+    {
+      FrameAttachedToGraph graph;
+      Errors buildErrors = buildFrameAttachedToGraph(graph, &_object);
+      _buildErrors.insert(_buildErrors.end(), buildErrors.begin(),
+                                              buildErrors.end());
+      Errors validateErrors = validateFrameAttachedToGraph(graph);
+      _validateErrors.insert(_validateErrors.end(), validateErrors.begin(),
+                                                    validateErrors.end());
+    }
+  };
+
+  for (const Model &model : this->dataPtr->models)
   {
-    if (m.Name() == _name)
+    appendGraphErrors(model);
+  }
+
+  for (const World &world : this->dataPtr->worlds)
+  {
+    appendGraphErrors(world);
+    for (uint64_t m = 0; m < world.ModelCount(); ++m)
     {
-      return true;
+      appendGraphErrors(*world.ModelByIndex(m));
     }
   }
-  return false;
 }
 
 /////////////////////////////////////////////////
-sdf::ElementPtr Root::Element() const
+void Root::PoseRelativeToGraphErrors(Errors &_buildErrors,
+                                     Errors &_validateErrors) const
 {
-  return this->dataPtr->sdf;
+  _buildErrors.clear();
+  _validateErrors.clear();
+
+  auto appendGraphErrors = [&](const auto &_object)
+  {
+    if (!_object.PoseRelativeToGraphErrors(_buildErrors, _validateErrors))
+    {
+      PoseRelativeToGraph graph;
+      Errors buildErrors = buildPoseRelativeToGraph(graph, &_object);
+      _buildErrors.insert(_buildErrors.end(), buildErrors.begin(),
+                                              buildErrors.end());
+      Errors validateErrors = validatePoseRelativeToGraph(graph);
+      _validateErrors.insert(_validateErrors.end(), validateErrors.begin(),
+                                                    validateErrors.end());
+    }
+  };
+
+  for (const Model &model : this->dataPtr->models)
+  {
+    appendGraphErrors(model);
+  }
+
+  for (const World &world : this->dataPtr->worlds)
+  {
+    appendGraphErrors(world);
+    for (uint64_t m = 0; m < world.ModelCount(); ++m)
+    {
+      appendGraphErrors(*world.ModelByIndex(m));
+    }
+  }
 }
@@ -132,6 +132,74 @@ TEST(DOMRoot, StringParse)
   EXPECT_NE(nullptr, actor->Element());
 }
 
+/////////////////////////////////////////////////
+TEST(DOMRoot, GraphErrors)
+{
+  sdf::Root root;
+  sdf::Errors buildErrors;
+  sdf::Errors validateErrors;
+  root.FrameAttachedToGraphErrors(buildErrors, validateErrors);
+  EXPECT_TRUE(buildErrors.empty());
+  EXPECT_TRUE(validateErrors.empty());
+  root.PoseRelativeToGraphErrors(buildErrors, validateErrors);
+  EXPECT_TRUE(buildErrors.empty());
+  EXPECT_TRUE(validateErrors.empty());
+
+  // The graphs built in Load are valid
+  std::string sdf = "<?xml version=\"1.0\"?>"
+    " <sdf version=\"1.8\">"
+    "   <world name='default'>"
+    "     <frame name='F'/>"
+    "     <model name='M'>"
+    "       <link name='L'/>"
+    "     </model>"
+    "   </world>"
+    " </sdf>";
+  EXPECT_TRUE(root.LoadSdfString(sdf).empty());
+  root.FrameAttachedToGraphErrors(buildErrors, validateErrors);
+  EXPECT_TRUE(buildErrors.empty());
+  EXPECT_TRUE(validateErrors.empty());
+  root.PoseRelativeToGraphErrors(buildErrors, validateErrors);
+  EXPECT_TRUE(buildErrors.empty());
+  EXPECT_TRUE(validateErrors.empty());
+
+  // Load doesn't build the FrameAttachedToGraph of a static model, which
+  // needs a link
+  sdf = "<?xml version=\"1.0\"?>"
+    " <sdf version=\"1.8\">"
+    "   <model name='M'>"
+    "     <static>true</static>"
+    "   </model>"
+    " </sdf>";
+  sdf::Root staticRoot;
+  EXPECT_TRUE(staticRoot.LoadSdfString(sdf).empty());
+  staticRoot.FrameAttachedToGraphErrors(buildErrors, validateErrors);
+  ASSERT_FALSE(buildErrors.empty());
+  EXPECT_EQ(sdf::ErrorCode::MODEL_WITHOUT_LINK, buildErrors[0].Code());
+  staticRoot.PoseRelativeToGraphErrors(buildErrors, validateErrors);
+  EXPECT_TRUE(buildErrors.empty());
+  EXPECT_TRUE(validateErrors.empty());
+
+  // Build and validation errors are kept apart
+  sdf = "<?xml version=\"1.0\"?>"
+    " <sdf version=\"1.8\">"
+    "   <model name='M'>"
+    "     <link name='L'/>"
+    "     <frame name='F1' attached_to='F2'/>"
+    "     <frame name='F2' attached_to='F1'/>"
+    "   </model>"
+    " </sdf>";
+  sdf::Root cycleRoot;
+  EXPECT_FALSE(cycleRoot.LoadSdfString(sdf).empty());
+  cycleRoot.FrameAttachedToGraphErrors(buildErrors, validateErrors);
+  EXPECT_TRUE(buildErrors.empty());
+  ASSERT_FALSE(validateErrors.empty());
+  for (const auto &error : validateErrors)
+  {
+    EXPECT_EQ(sdf::ErrorCode::FRAME_ATTACHED_TO_CYCLE, error.Code());
+  }
+}
+
 /////////////////////////////////////////////////
 TEST(DOMRoot, Set)
 {
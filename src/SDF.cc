@@ -21,6 +21,7 @@
 #include <functional>
 #include <list>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -32,6 +33,7 @@
 #include "SDFImplPrivate.hh"
 #include "sdf/sdf_config.h"
 #include "EmbeddedSdf.hh"
+#include "IncludeCache.hh"
 
 namespace sdf
 {
@@ -44,13 +46,23 @@ static URIPathMap g_uriPathMap;
 
 static std::function<std::string(const std::string &)> g_findFileCB;
 
+/// \brief Mutex that protects g_uriPathMap and g_findFileCB, since files
+/// can be found from several threads at once.
+static std::mutex g_findFileMutex;
+
 std::string SDF::version = SDF_VERSION;
 
 /////////////////////////////////////////////////
 // cppcheck-suppress passedByValue
 void setFindCallback(std::function<std::string(const std::string &)> _cb)
 {
-  g_findFileCB = _cb;
+  {
+    std::lock_guard<std::mutex> lock(g_findFileMutex);
+    g_findFileCB = _cb;
+  }
+
+  // Includes may now be found in different places
+  IncludeCache::Instance().Clear();
 }
 
 /////////////////////////////////////////////////
@@ -59,34 +71,50 @@ std::string findFile(const std::string &_filename, bool _searchLocalPath,
 {
   std::string path = _filename;
 
-  // Check to see if _filename is URI. If so, resolve the URI path.
-  for (URIPathMap::iterator iter = g_uriPathMap.begin();
-       iter != g_uriPathMap.end(); ++iter)
+  // Collect the candidate paths of a URI and a copy of the callback while
+  // holding the lock, then search the file system without holding it.
+  PathList uriCandidates;
+  std::function<std::string(const std::string &)> findFileCB;
   {
-    // Check to see if the URI in the global map is the first part of the
-    // given filename
-    // cppcheck-suppress stlIfStrFind
-    if (_filename.find(iter->first) == 0)
+    std::lock_guard<std::mutex> lock(g_findFileMutex);
+
+    // Check to see if _filename is URI. If so, resolve the URI path.
+    for (URIPathMap::iterator iter = g_uriPathMap.begin();
+         iter != g_uriPathMap.end(); ++iter)
     {
-      std::string suffix = _filename;
-      size_t index = suffix.find(iter->first);
-      if (index != std::string::npos)
+      // Check to see if the URI in the global map is the first part of the
+      // given filename
+      // cppcheck-suppress stlIfStrFind
+      if (_filename.find(iter->first) == 0)
       {
-        suffix.replace(index, iter->first.length(), "");
-      }
+        std::string suffix = _filename;
+        size_t index = suffix.find(iter->first);
+        if (index != std::string::npos)
+        {
+          suffix.replace(index, iter->first.length(), "");
+        }
 
-      // Check each path in the list.
-      for (PathList::iterator pathIter = iter->second.begin();
-           pathIter != iter->second.end(); ++pathIter)
-      {
-        // Return the path string if the path + suffix exists.
-        std::string pathSuffix = sdf::filesystem::append(*pathIter, suffix);
-        if (sdf::filesystem::exists(pathSuffix))
+        for (PathList::iterator pathIter = iter->second.begin();
+             pathIter != iter->second.end(); ++pathIter)
         {
-          return pathSuffix;
+          uriCandidates.push_back(sdf::filesystem::append(*pathIter, suffix));
         }
       }
     }
+
+    if (_useCallback)
+    {
+      findFileCB = g_findFileCB;
+    }
+  }
+
+  // Return the first path + suffix that exists.
+  for (const std::string &pathSuffix : uriCandidates)
+  {
+    if (sdf::filesystem::exists(pathSuffix))
+    {
+      return pathSuffix;
+    }
   }
 
   // Strip scheme, if any
@@ -158,7 +186,7 @@ std::string findFile(const std::string &_filename, bool _searchLocalPath,
   // flag has been set
   if (_useCallback)
   {
-    if (!g_findFileCB)
+    if (!findFileCB)
     {
       sdferr << "Tried to use callback in sdf::findFile(), but the callback "
         "is empty.  Did you call sdf::setFindCallback()?";
@@ -166,7 +194,7 @@ std::string findFile(const std::string &_filename, bool _searchLocalPath,
     }
     else
     {
-      return g_findFileCB(_filename);
+      return findFileCB(_filename);
     }
   }
 
@@ -186,9 +214,13 @@ void addURIPath(const std::string &_uri, const std::string &_path)
     // Only add valid paths
     if (!(*iter).empty() && sdf::filesystem::is_directory(*iter))
     {
+      std::lock_guard<std::mutex> lock(g_findFileMutex);
       g_uriPathMap[_uri].push_back(*iter);
     }
   }
+
+  // Includes may now be found in different places
+  IncludeCache::Instance().Clear();
 }
 
 /////////////////////////////////////////////////
@@ -14,14 +14,28 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
+
+#include "sdf/parser.hh"
 #include "Utils.hh"
 
 namespace sdf
 {
 inline namespace SDF_VERSION_NAMESPACE {
 
+/// \brief Number of threads used to load sibling DOM objects.
+static std::atomic<unsigned int> g_domLoadThreadCount{1};
+
+/// \brief True on threads that run the calls of parallelForEach.
+static thread_local bool t_inParallelForEach = false;
+
 /////////////////////////////////////////////////
 bool isReservedName(const std::string &_name)
 {
@@ -74,5 +88,76 @@ bool loadPose(sdf::ElementPtr _sdf, ignition::math::Pose3d &_pose,
   // on the pose element value.
   return posePair.second;
 }
+/////////////////////////////////////////////////
+void setDomLoadThreadCount(unsigned int _threadCount)
+{
+  g_domLoadThreadCount = std::max(_threadCount, 1u);
+}
+
+/////////////////////////////////////////////////
+unsigned int domLoadThreadCount()
+{
+  return g_domLoadThreadCount;
+}
+
+/////////////////////////////////////////////////
+void parallelForEach(std::size_t _count,
+    const std::function<void(std::size_t)> &_func)
+{
+  const std::size_t threadCount =
+      std::min<std::size_t>(g_domLoadThreadCount, _count);
+  if (threadCount < 2 || t_inParallelForEach)
+  {
+    for (std::size_t i = 0; i < _count; ++i)
+    {
+      _func(i);
+    }
+    return;
+  }
+
+  // Each thread takes the next index until there are none left, so threads
+  // that get cheap objects take more of them.
+  std::atomic<std::size_t> next{0};
+  std::mutex exceptionMutex;
+  std::exception_ptr exception;
+  auto worker = [&]()
+  {
+    t_inParallelForEach = true;
+    for (std::size_t i = next++; i < _count; i = next++)
+    {
+      try
+      {
+        _func(i);
+      }
+      catch(...)
+      {
+        std::lock_guard<std::mutex> lock(exceptionMutex);
+        if (!exception)
+        {
+          exception = std::current_exception();
+        }
+        next = _count;
+      }
+    }
+    t_inParallelForEach = false;
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < threadCount; ++i)
+  {
+    threads.emplace_back(worker);
+  }
+  worker();
+
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  if (exception)
+  {
+    std::rethrow_exception(exception);
+  }
+}
 }
 }
@@ -18,7 +18,11 @@
 #define SDFORMAT_UTILS_HH
 
 #include <algorithm>
+#include <cstddef>
+#include <functional>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "sdf/Error.hh"
 #include "sdf/Element.hh"
@@ -55,6 +59,17 @@ namespace sdf
   bool loadPose(sdf::ElementPtr _sdf, ignition::math::Pose3d &_pose,
                 std::string &_frame);
 
+  /// \brief Call a function for each index from 0 to _count - 1. The calls
+  /// are spread over the number of threads set with
+  /// sdf::setDomLoadThreadCount. Calls made from those threads to this
+  /// function run serially, so that the number of threads stays bounded.
+  /// If a call throws, the remaining indices are skipped and the exception
+  /// is rethrown on the calling thread.
+  /// \param[in] _count Number of indices.
+  /// \param[in] _func Function to call with each index.
+  void parallelForEach(std::size_t _count,
+      const std::function<void(std::size_t)> &_func);
+
   /// \brief Load all objects of a specific sdf element type. No error
   /// is returned if an element is not present. This function assumes that
   /// an element has a "name" attribute that must be unique.
@@ -71,47 +86,40 @@ namespace sdf
   {
     Errors errors;
 
-    std::vector<std::string> names;
+    // Load all the elements, which may be done on several threads. Names
+    // are then checked in document order, so the result and the errors are
+    // the same for any number of threads.
+    const ElementPtr_V elems = _sdf->Children(_sdfName);
+    std::vector<Class> objs(elems.size());
+    std::vector<Errors> loadErrors(elems.size());
+    parallelForEach(elems.size(), [&](std::size_t _index)
+    {
+      loadErrors[_index] = objs[_index].Load(elems[_index]);
+    });
 
-    // Check that an element exists.
-    if (_sdf->HasElement(_sdfName))
+    std::unordered_set<std::string> names;
+    for (std::size_t i = 0; i < elems.size(); ++i)
     {
-      // Read all the elements.
-      sdf::ElementPtr elem = _sdf->GetElement(_sdfName);
-      while (elem)
+      std::string name;
+
+      // Read the name for uniqueness checks. Don't report errors here.
+      // Errors are captured by Load above.
+      sdf::loadName(elems[i], name);
+
+      // Check that the name does not exist.
+      if (!names.insert(name).second)
       {
-        Class obj;
-
-        // Load the model and capture the errors.
-        Errors loadErrors = obj.Load(elem);
-
-        // keep processing even if there are loadErrors
-        {
-          std::string name;
-
-          // Read the name for uniqueness checks. Don't report errors here.
-          // Errors are captured in obj.Load(elem) above.
-          sdf::loadName(elem, name);
-
-          // Check that the name does not exist.
-          if (std::find(names.begin(), names.end(), name) != names.end())
-          {
-            errors.push_back({ErrorCode::DUPLICATE_NAME,
-                _sdfName + " with name[" + name + "] already exists."});
-          }
-          else
-          {
-            // Add the object to the result if no errors have been encountered.
-            _objs.push_back(std::move(obj));
-            names.push_back(name);
-          }
-
-          // Add the load errors to the master error list.
-          errors.insert(errors.end(), loadErrors.begin(), loadErrors.end());
-        }
-
-        elem = elem->GetNextElement(_sdfName);
+        errors.push_back({ErrorCode::DUPLICATE_NAME,
+            _sdfName + " with name[" + name + "] already exists."});
       }
+      else
+      {
+        // Add the object to the result if no errors have been encountered.
+        _objs.push_back(std::move(objs[i]));
+      }
+
+      // Add the load errors to the master error list.
+      errors.insert(errors.end(), loadErrors[i].begin(), loadErrors[i].end());
     }
     // Do not add an error if the model tag is missing. This is an internal
     // function that is called by class without checking if an element actually
@@ -134,28 +142,22 @@ namespace sdf
   {
     Errors errors;
 
-    // Check that an element exists.
-    if (_sdf->HasElement(_sdfName))
+    // Load all the elements, which may be done on several threads.
+    const ElementPtr_V elems = _sdf->Children(_sdfName);
+    std::vector<Class> objs(elems.size());
+    std::vector<Errors> loadErrors(elems.size());
+    parallelForEach(elems.size(), [&](std::size_t _index)
     {
-      // Read all the elements.
-      sdf::ElementPtr elem = _sdf->GetElement(_sdfName);
-      while (elem)
-      {
-        Class obj;
+      loadErrors[_index] = objs[_index].Load(elems[_index]);
+    });
 
-        // Load the model and capture the errors.
-        Errors loadErrors = obj.Load(elem);
-
-        {
-          // Add the load errors to the master error list.
-          errors.insert(errors.end(), loadErrors.begin(), loadErrors.end());
-
-          // but keep object anyway
-          _objs.push_back(std::move(obj));
-        }
+    for (std::size_t i = 0; i < elems.size(); ++i)
+    {
+      // Add the load errors to the master error list.
+      errors.insert(errors.end(), loadErrors[i].begin(), loadErrors[i].end());
 
-        elem = elem->GetNextElement(_sdfName);
-      }
+      // but keep object anyway
+      _objs.push_back(std::move(objs[i]));
     }
     // Do not add an error if the model tag is missing. This is an internal
     // function that is called by class without checking if an element actually
@@ -163,6 +165,63 @@ namespace sdf
 
     return errors;
   }
+
+  /// \brief Index of a vector of objects by name. It maps the name of each
+  /// object to its position in the vector, so it remains valid when the
+  /// vector is copied.
+  using NameIndex = std::unordered_map<std::string, std::size_t>;
+
+  /// \brief Build the index by name of a vector of objects. If several
+  /// objects have the same name, the first one is indexed, which matches
+  /// the result of a linear search.
+  /// \param[in] _objs Objects to index. Each must have a Name() function.
+  /// \return The index of _objs by name.
+  template<typename Class>
+  NameIndex buildNameIndex(const std::vector<Class> &_objs)
+  {
+    NameIndex index;
+    index.reserve(_objs.size());
+    for (std::size_t i = 0; i < _objs.size(); ++i)
+    {
+      index.emplace(_objs[i].Name(), i);
+    }
+    return index;
+  }
+
+  /// \brief Find an object by name with the index of its vector.
+  /// \param[in] _objs Objects indexed by _index.
+  /// \param[in] _index Index of _objs by name.
+  /// \param[in] _name Name of the object to find.
+  /// \return Pointer to the object, or nullptr if no object has this name.
+  template<typename Class>
+  const Class *findByName(const std::vector<Class> &_objs,
+      const NameIndex &_index, const std::string &_name)
+  {
+    auto it = _index.find(_name);
+    if (it == _index.end() || it->second >= _objs.size())
+    {
+      return nullptr;
+    }
+    return &_objs[it->second];
+  }
+
+  /// \brief Find an object by name with the index of its vector.
+  /// \param[in] _objs Objects indexed by _index.
+  /// \param[in] _index Index of _objs by name.
+  /// \param[in] _name Name of the object to find.
+  /// \return Mutable pointer to the object, or nullptr if no object has
+  /// this name.
+  template<typename Class>
+  Class *findByName(std::vector<Class> &_objs,
+      const NameIndex &_index, const std::string &_name)
+  {
+    auto it = _index.find(_name);
+    if (it == _index.end() || it->second >= _objs.size())
+    {
+      return nullptr;
+    }
+    return &_objs[it->second];
+  }
   }
 }
 #endif
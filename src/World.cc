@@ -14,6 +14,7 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -27,6 +28,7 @@
 #include "sdf/Types.hh"
 #include "sdf/World.hh"
 #include "FrameSemantics.hh"
+#include "InstrumentationPrivate.hh"
 #include "Utils.hh"
 
 using namespace sdf;
@@ -81,6 +83,12 @@ class sdf::WorldPrivate
   /// \brief The physics profiles specified in this world.
   public: std::vector<Physics> physics;
 
+  /// \brief Indices of the models, frames, lights and actors by name.
+  public: NameIndex modelIndex;
+  public: NameIndex frameIndex;
+  public: NameIndex lightIndex;
+  public: NameIndex actorIndex;
+
   /// \brief The SDF element pointer used during load.
   public: sdf::ElementPtr sdf;
 
@@ -88,11 +96,30 @@ class sdf::WorldPrivate
   public: ignition::math::Vector3d windLinearVelocity =
            ignition::math::Vector3d::Zero;
 
-  /// \brief Frame Attached-To Graph constructed during Load.
+  /// \brief Frame Attached-To Graph constructed during Load. It's shared
+  /// by the copies of this world.
   public: std::shared_ptr<sdf::FrameAttachedToGraph> frameAttachedToGraph;
 
-  /// \brief Pose Relative-To Graph constructed during Load.
+  /// \brief Pose Relative-To Graph constructed during Load. It's shared by
+  /// the copies of this world, until one of them gets its own copy to
+  /// modify it (see World::PoseGraphForUpdate).
   public: std::shared_ptr<sdf::PoseRelativeToGraph> poseRelativeToGraph;
+
+  /// \brief Errors found while building the Frame Attached-To Graph
+  /// during Load.
+  public: Errors frameAttachedToGraphBuildErrors;
+
+  /// \brief Errors found while validating the Frame Attached-To Graph
+  /// during Load.
+  public: Errors frameAttachedToGraphValidateErrors;
+
+  /// \brief Errors found while building the Pose Relative-To Graph during
+  /// Load.
+  public: Errors poseRelativeToGraphBuildErrors;
+
+  /// \brief Errors found while validating the Pose Relative-To Graph
+  /// during Load.
+  public: Errors poseRelativeToGraphValidateErrors;
 };
 
 /////////////////////////////////////////////////
@@ -106,8 +133,22 @@ WorldPrivate::WorldPrivate(const WorldPrivate &_worldPrivate)
       models(_worldPrivate.models),
       name(_worldPrivate.name),
       physics(_worldPrivate.physics),
+      modelIndex(_worldPrivate.modelIndex),
+      frameIndex(_worldPrivate.frameIndex),
+      lightIndex(_worldPrivate.lightIndex),
+      actorIndex(_worldPrivate.actorIndex),
       sdf(_worldPrivate.sdf),
-      windLinearVelocity(_worldPrivate.windLinearVelocity)
+      windLinearVelocity(_worldPrivate.windLinearVelocity),
+      frameAttachedToGraph(_worldPrivate.frameAttachedToGraph),
+      poseRelativeToGraph(_worldPrivate.poseRelativeToGraph),
+      frameAttachedToGraphBuildErrors(
+          _worldPrivate.frameAttachedToGraphBuildErrors),
+      frameAttachedToGraphValidateErrors(
+          _worldPrivate.frameAttachedToGraphValidateErrors),
+      poseRelativeToGraphBuildErrors(
+          _worldPrivate.poseRelativeToGraphBuildErrors),
+      poseRelativeToGraphValidateErrors(
+          _worldPrivate.poseRelativeToGraphValidateErrors)
 {
   if (_worldPrivate.atmosphere)
   {
@@ -118,16 +159,6 @@ WorldPrivate::WorldPrivate(const WorldPrivate &_worldPrivate)
   {
     this->gui = std::make_unique<Gui>(*(_worldPrivate.gui));
   }
-  if (_worldPrivate.frameAttachedToGraph)
-  {
-    this->frameAttachedToGraph = std::make_shared<sdf::FrameAttachedToGraph>(
-        *(_worldPrivate.frameAttachedToGraph));
-  }
-  if (_worldPrivate.poseRelativeToGraph)
-  {
-    this->poseRelativeToGraph = std::make_shared<sdf::PoseRelativeToGraph>(
-        *(_worldPrivate.poseRelativeToGraph));
-  }
   if (_worldPrivate.scene)
   {
     this->scene = std::make_unique<Scene>(*(_worldPrivate.scene));
@@ -152,20 +183,9 @@ World::~World()
 World::World(const World &_world)
   : dataPtr(new WorldPrivate(*_world.dataPtr))
 {
-  for (auto &frame : this->dataPtr->frames)
-  {
-    frame.SetFrameAttachedToGraph(this->dataPtr->frameAttachedToGraph);
-    frame.SetPoseRelativeToGraph(this->dataPtr->poseRelativeToGraph);
-  }
-  for (auto &model : this->dataPtr->models)
-  {
-    model.SetPoseRelativeToGraph(this->dataPtr->poseRelativeToGraph);
-  }
-  for (auto &light : this->dataPtr->lights)
-  {
-    light.SetXmlParentName("world");
-    light.SetPoseRelativeToGraph(this->dataPtr->poseRelativeToGraph);
-  }
+  // The graphs are shared with the copy instead of being copied. The copied
+  // children already point to them. The pose graph is copied before it's
+  // modified, as long as it's shared.
 }
 
 /////////////////////////////////////////////////
@@ -324,6 +344,13 @@ Errors World::Load(sdf::ElementPtr _sdf)
     frameNames.insert(frameName);
   }
 
+  // Names don't change after this point, so index them for lookups by name
+  // during the rest of Load and afterwards.
+  this->dataPtr->modelIndex = buildNameIndex(this->dataPtr->models);
+  this->dataPtr->frameIndex = buildNameIndex(this->dataPtr->frames);
+  this->dataPtr->lightIndex = buildNameIndex(this->dataPtr->lights);
+  this->dataPtr->actorIndex = buildNameIndex(this->dataPtr->actors);
+
   // Load the Gui
   if (_sdf->HasElement("gui"))
   {
@@ -341,15 +368,21 @@ Errors World::Load(sdf::ElementPtr _sdf)
     errors.insert(errors.end(), sceneLoadErrors.begin(), sceneLoadErrors.end());
   }
 
-  // Build the graphs.
-  this->dataPtr->frameAttachedToGraph =
-      std::make_shared<FrameAttachedToGraph>();
-  Errors frameAttachedToGraphErrors =
-  buildFrameAttachedToGraph(*this->dataPtr->frameAttachedToGraph, this);
+  // Build the graphs. They're only modified through the local pointers,
+  // after which they can be shared by copies.
+  ScopedLoadTimer graphTimer(LoadPhase::FRAME_GRAPH, this->dataPtr->name);
+  auto frameAttachedToGraph = std::make_shared<FrameAttachedToGraph>();
+  this->dataPtr->frameAttachedToGraph = frameAttachedToGraph;
+  Errors &frameAttachedToGraphErrors =
+      this->dataPtr->frameAttachedToGraphBuildErrors;
+  frameAttachedToGraphErrors =
+      buildFrameAttachedToGraph(*frameAttachedToGraph, this);
   errors.insert(errors.end(), frameAttachedToGraphErrors.begin(),
                               frameAttachedToGraphErrors.end());
-  Errors validateFrameAttachedGraphErrors =
-    validateFrameAttachedToGraph(*this->dataPtr->frameAttachedToGraph);
+  Errors &validateFrameAttachedGraphErrors =
+      this->dataPtr->frameAttachedToGraphValidateErrors;
+  validateFrameAttachedGraphErrors =
+      validateFrameAttachedToGraph(*frameAttachedToGraph);
   errors.insert(errors.end(), validateFrameAttachedGraphErrors.begin(),
                               validateFrameAttachedGraphErrors.end());
   for (auto &frame : this->dataPtr->frames)
@@ -357,15 +390,23 @@ Errors World::Load(sdf::ElementPtr _sdf)
     frame.SetFrameAttachedToGraph(this->dataPtr->frameAttachedToGraph);
   }
 
-  this->dataPtr->poseRelativeToGraph = std::make_shared<PoseRelativeToGraph>();
-  Errors poseRelativeToGraphErrors =
-  buildPoseRelativeToGraph(*this->dataPtr->poseRelativeToGraph, this);
+  auto poseRelativeToGraph = std::make_shared<PoseRelativeToGraph>();
+  this->dataPtr->poseRelativeToGraph = poseRelativeToGraph;
+  Errors &poseRelativeToGraphErrors =
+      this->dataPtr->poseRelativeToGraphBuildErrors;
+  poseRelativeToGraphErrors =
+      buildPoseRelativeToGraph(*poseRelativeToGraph, this);
   errors.insert(errors.end(), poseRelativeToGraphErrors.begin(),
                               poseRelativeToGraphErrors.end());
-  Errors validatePoseGraphErrors =
-    validatePoseRelativeToGraph(*this->dataPtr->poseRelativeToGraph);
+  Errors &validatePoseGraphErrors =
+      this->dataPtr->poseRelativeToGraphValidateErrors;
+  validatePoseGraphErrors =
+      validatePoseRelativeToGraph(*poseRelativeToGraph);
   errors.insert(errors.end(), validatePoseGraphErrors.begin(),
                               validatePoseGraphErrors.end());
+  cachePosesRelativeToRoot(*poseRelativeToGraph);
+  graphTimer.SetCount(poseRelativeToGraph->map.size());
+  graphTimer.Stop();
   for (auto &frame : this->dataPtr->frames)
   {
     frame.SetPoseRelativeToGraph(this->dataPtr->poseRelativeToGraph);
@@ -463,27 +504,13 @@ const Model *World::ModelByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool World::ModelNameExists(const std::string &_name) const
 {
-  for (auto const &m : this->dataPtr->models)
-  {
-    if (m.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->modelIndex.count(_name) > 0;
 }
 
 /////////////////////////////////////////////////
 const Model *World::ModelByName(const std::string &_name) const
 {
-  for (auto const &m : this->dataPtr->models)
-  {
-    if (m.Name() == _name)
-    {
-      return &m;
-    }
-  }
-  return nullptr;
+  return findByName(this->dataPtr->models, this->dataPtr->modelIndex, _name);
 }
 
 /////////////////////////////////////////////////
@@ -545,27 +572,13 @@ const Frame *World::FrameByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool World::FrameNameExists(const std::string &_name) const
 {
-  for (auto const &f : this->dataPtr->frames)
-  {
-    if (f.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->frameIndex.count(_name) > 0;
 }
 
 /////////////////////////////////////////////////
 const Frame *World::FrameByName(const std::string &_name) const
 {
-  for (auto const &f : this->dataPtr->frames)
-  {
-    if (f.Name() == _name)
-    {
-      return &f;
-    }
-  }
-  return nullptr;
+  return findByName(this->dataPtr->frames, this->dataPtr->frameIndex, _name);
 }
 
 /////////////////////////////////////////////////
@@ -585,14 +598,7 @@ const Light *World::LightByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool World::LightNameExists(const std::string &_name) const
 {
-  for (auto const &l : this->dataPtr->lights)
-  {
-    if (l.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->lightIndex.count(_name) > 0;
 }
 
 /////////////////////////////////////////////////
@@ -612,14 +618,7 @@ const Actor *World::ActorByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool World::ActorNameExists(const std::string &_name) const
 {
-  for (auto const &a : this->dataPtr->actors)
-  {
-    if (a.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->actorIndex.count(_name) > 0;
 }
 
 //////////////////////////////////////////////////
@@ -666,3 +665,168 @@ bool World::PhysicsNameExists(const std::string &_name) const
 
   return false;
 }
+
+/////////////////////////////////////////////////
+PoseRelativeToGraph *World::PoseGraphForUpdate()
+{
+  auto &graph = this->dataPtr->poseRelativeToGraph;
+  if (!graph)
+  {
+    return nullptr;
+  }
+
+  // The copies of this world that share the graph must not see the update,
+  // so this world gets its own copy of the graph first.
+  if (graph.use_count() > 1)
+  {
+    graph = std::make_shared<PoseRelativeToGraph>(*graph);
+    for (auto &frame : this->dataPtr->frames)
+    {
+      frame.SetPoseRelativeToGraph(graph);
+    }
+    for (auto &model : this->dataPtr->models)
+    {
+      model.SetPoseRelativeToGraph(graph);
+    }
+    for (auto &light : this->dataPtr->lights)
+    {
+      light.SetPoseRelativeToGraph(graph);
+    }
+  }
+
+  return graph.get();
+}
+
+/////////////////////////////////////////////////
+Errors World::SetRawPoses(const FramePoses &_poses)
+{
+  Errors errors;
+
+  if (!this->dataPtr->poseRelativeToGraph)
+  {
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
+        "World with name [" + this->Name() + "] has no PoseRelativeToGraph."});
+    return errors;
+  }
+
+  FramePoses graphPoses;
+  graphPoses.reserve(_poses.size());
+  for (const auto &framePose : _poses)
+  {
+    const std::string &name = framePose.first;
+    ignition::math::Pose3d pose = framePose.second;
+    if (auto model = findByName(
+            this->dataPtr->models, this->dataPtr->modelIndex, name))
+    {
+      Errors placementErrors =
+          model->ModelPoseFromPlacementPose(framePose.second, pose);
+      errors.insert(errors.end(), placementErrors.begin(),
+                                  placementErrors.end());
+      model->SetRawPose(pose);
+    }
+    else if (auto frame = findByName(
+            this->dataPtr->frames, this->dataPtr->frameIndex, name))
+    {
+      frame->SetRawPose(pose);
+    }
+    else
+    {
+      errors.push_back({ErrorCode::POSE_RELATIVE_TO_INVALID,
+          "World with name [" + this->Name() + "] has no model or frame "
+          "with name [" + name + "]."});
+      continue;
+    }
+    graphPoses.emplace_back(name, pose);
+  }
+
+  if (!graphPoses.empty())
+  {
+    Errors graphErrors =
+        updateGraphPoses(*this->PoseGraphForUpdate(), graphPoses);
+    errors.insert(errors.end(), graphErrors.begin(), graphErrors.end());
+  }
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors World::ResolveAllPoses(FramePoses &_poses,
+                              const std::string &_resolveTo) const
+{
+  Errors errors;
+  _poses.clear();
+
+  auto graph = this->dataPtr->poseRelativeToGraph;
+  if (!graph)
+  {
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
+        "World with name [" + this->Name() + "] has no PoseRelativeToGraph."});
+    return errors;
+  }
+
+  errors = appendPosesRelativeToRoot(
+      _poses, *graph, "", ignition::math::Pose3d::Zero, true);
+
+  // The frames of models are in their own graphs
+  for (const Model &model : this->dataPtr->models)
+  {
+    ignition::math::Pose3d modelPose;
+    Errors modelErrors =
+        resolvePoseRelativeToRoot(modelPose, *graph, model.Name());
+    if (modelErrors.empty())
+    {
+      modelErrors = model.AppendPoses(
+          _poses, model.Name() + "::", modelPose, false);
+    }
+    errors.insert(errors.end(), modelErrors.begin(), modelErrors.end());
+  }
+
+  // Models are appended after the frames of the world
+  std::sort(_poses.begin(), _poses.end(),
+      [](const auto &_a, const auto &_b)
+      {
+        return _a.first < _b.first;
+      });
+
+  if (!_resolveTo.empty() && _resolveTo != "world")
+  {
+    Errors resolveErrors = resolvePosesTo(_poses, _resolveTo);
+    errors.insert(errors.end(), resolveErrors.begin(), resolveErrors.end());
+  }
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+bool World::FrameAttachedToGraphErrors(Errors &_buildErrors,
+                                       Errors &_validateErrors) const
+{
+  if (!this->dataPtr->frameAttachedToGraph)
+  {
+    return false;
+  }
+  _buildErrors.insert(_buildErrors.end(),
+      this->dataPtr->frameAttachedToGraphBuildErrors.begin(),
+      this->dataPtr->frameAttachedToGraphBuildErrors.end());
+  _validateErrors.insert(_validateErrors.end(),
+      this->dataPtr->frameAttachedToGraphValidateErrors.begin(),
+      this->dataPtr->frameAttachedToGraphValidateErrors.end());
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool World::PoseRelativeToGraphErrors(Errors &_buildErrors,
+                                      Errors &_validateErrors) const
+{
+  if (!this->dataPtr->poseRelativeToGraph)
+  {
+    return false;
+  }
+  _buildErrors.insert(_buildErrors.end(),
+      this->dataPtr->poseRelativeToGraphBuildErrors.begin(),
+      this->dataPtr->poseRelativeToGraphBuildErrors.end());
+  _validateErrors.insert(_validateErrors.end(),
+      this->dataPtr->poseRelativeToGraphValidateErrors.begin(),
+      this->dataPtr->poseRelativeToGraphValidateErrors.end());
+  return true;
+}
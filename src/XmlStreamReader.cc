@@ -0,0 +1,656 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "XmlStreamReader.hh"
+
+namespace sdf
+{
+inline namespace SDF_VERSION_NAMESPACE
+{
+/// \brief Number of characters read from a stream at a time.
+static const std::size_t kChunkSize = 64 * 1024;
+
+/// \brief Entities that are replaced in text and attribute values.
+static const struct
+{
+  /// \brief Name of the entity.
+  const char *name;
+
+  /// \brief Length of the name.
+  std::size_t length;
+
+  /// \brief Replacement.
+  char value;
+} kEntities[] = {
+  {"quot", 4, '"'},
+  {"amp", 3, '&'},
+  {"apos", 4, '\''},
+  {"lt", 2, '<'},
+  {"gt", 2, '>'}
+};
+
+/////////////////////////////////////////////////
+/// \brief Check whether a character is whitespace.
+/// \param[in] _c The character.
+/// \return True if it is.
+static bool isWhitespace(int _c)
+{
+  return _c == ' ' || _c == '\t' || _c == '\n' || _c == '\v' ||
+         _c == '\f' || _c == '\r';
+}
+
+/////////////////////////////////////////////////
+/// \brief Check whether a character can start a name.
+/// \param[in] _c The character.
+/// \return True if it can.
+static bool isNameStartChar(int _c)
+{
+  return _c >= 128 || (_c >= 'a' && _c <= 'z') || (_c >= 'A' && _c <= 'Z') ||
+         _c == ':' || _c == '_';
+}
+
+/////////////////////////////////////////////////
+/// \brief Check whether a character can be part of a name.
+/// \param[in] _c The character.
+/// \return True if it can.
+static bool isNameChar(int _c)
+{
+  return isNameStartChar(_c) || (_c >= '0' && _c <= '9') || _c == '.' ||
+         _c == '-';
+}
+
+/////////////////////////////////////////////////
+/// \brief Append a code point encoded as UTF-8.
+/// \param[in] _codePoint The code point.
+/// \param[out] _out String to append to.
+static void appendUtf8(unsigned long _codePoint, std::string &_out)
+{
+  if (_codePoint < 0x80)
+  {
+    _out += static_cast<char>(_codePoint);
+  }
+  else if (_codePoint < 0x800)
+  {
+    _out += static_cast<char>(0xC0 | (_codePoint >> 6));
+    _out += static_cast<char>(0x80 | (_codePoint & 0x3F));
+  }
+  else if (_codePoint < 0x10000)
+  {
+    _out += static_cast<char>(0xE0 | (_codePoint >> 12));
+    _out += static_cast<char>(0x80 | ((_codePoint >> 6) & 0x3F));
+    _out += static_cast<char>(0x80 | (_codePoint & 0x3F));
+  }
+  else if (_codePoint < 0x200000)
+  {
+    _out += static_cast<char>(0xF0 | (_codePoint >> 18));
+    _out += static_cast<char>(0x80 | ((_codePoint >> 12) & 0x3F));
+    _out += static_cast<char>(0x80 | ((_codePoint >> 6) & 0x3F));
+    _out += static_cast<char>(0x80 | (_codePoint & 0x3F));
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Replace the entity at a position of a string.
+/// \param[in] _raw The string.
+/// \param[in] _pos Position of the '&' that starts the entity.
+/// \param[out] _out String the replacement is appended to.
+/// \return Length of the entity, or 0 if there's no valid entity at the
+/// position.
+static std::size_t appendEntity(const std::string &_raw, std::size_t _pos,
+                                std::string &_out)
+{
+  if (_pos + 1 < _raw.size() && _raw[_pos + 1] == '#')
+  {
+    const bool hex = _pos + 2 < _raw.size() && _raw[_pos + 2] == 'x';
+    const std::size_t start = _pos + (hex ? 3 : 2);
+    const std::size_t end = _raw.find(';', start);
+    if (end == std::string::npos || end == start || end - start > 8)
+    {
+      return 0;
+    }
+
+    unsigned long codePoint = 0;
+    for (std::size_t i = start; i < end; ++i)
+    {
+      const char c = _raw[i];
+      unsigned long digit;
+      if (c >= '0' && c <= '9')
+        digit = static_cast<unsigned long>(c - '0');
+      else if (hex && c >= 'a' && c <= 'f')
+        digit = static_cast<unsigned long>(c - 'a' + 10);
+      else if (hex && c >= 'A' && c <= 'F')
+        digit = static_cast<unsigned long>(c - 'A' + 10);
+      else
+        return 0;
+      codePoint = codePoint * (hex ? 16 : 10) + digit;
+    }
+
+    appendUtf8(codePoint, _out);
+    return end + 1 - _pos;
+  }
+
+  for (const auto &entity : kEntities)
+  {
+    if (_raw.compare(_pos + 1, entity.length, entity.name) == 0 &&
+        _pos + entity.length + 1 < _raw.size() &&
+        _raw[_pos + entity.length + 1] == ';')
+    {
+      _out += entity.value;
+      return entity.length + 2;
+    }
+  }
+  return 0;
+}
+
+/////////////////////////////////////////////////
+/// \brief Check whether text has a character reference that isn't read
+/// the same way as by TinyXML2. TinyXML2 only decodes the hexadecimal
+/// references that start with "&#x", and keeps the others as they are.
+/// \param[in] _raw The text as it appears in the document.
+/// \return True if it has a reference that starts with "&#X".
+static bool hasUnsupportedReference(const std::string &_raw)
+{
+  return _raw.find("&#X") != std::string::npos;
+}
+
+/////////////////////////////////////////////////
+/// \brief Normalize the line endings of text, and optionally replace its
+/// entities.
+/// \param[in] _raw The text as it appears in the document.
+/// \param[in] _entities True to replace entities.
+/// \return The processed text.
+static std::string processText(std::string &&_raw, bool _entities)
+{
+  if (_raw.find_first_of(_entities ? "&\r" : "\r") == std::string::npos)
+  {
+    return std::move(_raw);
+  }
+
+  std::string out;
+  out.reserve(_raw.size());
+  for (std::size_t i = 0; i < _raw.size();)
+  {
+    const char c = _raw[i];
+    if (c == '\r' || c == '\n')
+    {
+      // CR LF, LF CR and CR alone all become LF
+      const char other = c == '\r' ? '\n' : '\r';
+      out += '\n';
+      i += (i + 1 < _raw.size() && _raw[i + 1] == other) ? 2 : 1;
+    }
+    else if (c == '&' && _entities)
+    {
+      const std::size_t length = appendEntity(_raw, i, out);
+      if (length == 0)
+      {
+        out += c;
+        ++i;
+      }
+      else
+      {
+        i += length;
+      }
+    }
+    else
+    {
+      out += c;
+      ++i;
+    }
+  }
+  return out;
+}
+
+/////////////////////////////////////////////////
+XmlStreamReader::XmlStreamReader(std::istream &_stream)
+  : stream(&_stream)
+{
+}
+
+/////////////////////////////////////////////////
+XmlStreamReader::XmlStreamReader(const char *_data, std::size_t _size)
+  : data(_data), size(_size)
+{
+}
+
+/////////////////////////////////////////////////
+XmlStreamReader::Token XmlStreamReader::Next()
+{
+  if (this->done)
+  {
+    return this->error.empty() ? Token::END_DOCUMENT : Token::ERROR;
+  }
+
+  this->text.clear();
+  this->cdata = false;
+
+  if (this->pendingEnd)
+  {
+    this->pendingEnd = false;
+    this->openElements.pop_back();
+    this->depth = this->openElements.size();
+    return Token::END_ELEMENT;
+  }
+
+  if (!this->started)
+  {
+    this->started = true;
+    if (this->LookingAt("\xEF\xBB\xBF"))
+    {
+      this->Advance(3);
+    }
+  }
+
+  // Whitespace before a tag is dropped, otherwise it's part of the text
+  std::string raw;
+  this->SkipWhitespace(&raw);
+  this->depth = this->openElements.size();
+  const bool topLevel = this->openElements.empty();
+  const int c = this->Peek();
+
+  if (c < 0)
+  {
+    if (this->stream && this->stream->bad())
+    {
+      return this->Fail("Unable to read the document");
+    }
+    if (!topLevel)
+    {
+      return this->Fail("Element <" + this->openElements.back() +
+          "> is not closed");
+    }
+    if (this->topLevelNodes == 0)
+    {
+      return this->Fail("Document is empty");
+    }
+    this->done = true;
+    return Token::END_DOCUMENT;
+  }
+
+  Token token;
+  bool declaration = false;
+  if (c == '<')
+  {
+    raw.clear();
+  }
+
+  if (c != '<')
+  {
+    if (!this->ReadUntil("<", raw, false))
+    {
+      return this->Fail("Text is not followed by a tag");
+    }
+    if (hasUnsupportedReference(raw))
+    {
+      return this->FailUnsupported("Character reference in text");
+    }
+    this->text = processText(std::move(raw), true);
+    token = Token::TEXT;
+  }
+  else if (this->LookingAt("<!--"))
+  {
+    this->Advance(4);
+    if (!this->ReadUntil("-->", this->text))
+    {
+      return this->Fail("Comment is not closed");
+    }
+    token = Token::OTHER;
+  }
+  else if (this->LookingAt("<![CDATA["))
+  {
+    this->Advance(9);
+    if (!this->ReadUntil("]]>", raw))
+    {
+      return this->Fail("CDATA section is not closed");
+    }
+    this->text = processText(std::move(raw), false);
+    this->cdata = true;
+    token = Token::TEXT;
+  }
+  else if (this->LookingAt("<!"))
+  {
+    this->Advance(2);
+    if (!this->ReadUntil(">", this->text))
+    {
+      return this->Fail("Declaration is not closed");
+    }
+    // The internal subset of a DOCTYPE can contain '>', which would end
+    // the declaration early.
+    if (this->text.find('[') != std::string::npos)
+    {
+      return this->FailUnsupported("Declaration with an internal subset");
+    }
+    token = Token::OTHER;
+  }
+  else if (this->LookingAt("<?"))
+  {
+    // Declarations are only allowed before any other node
+    if (!topLevel ||
+        (this->topLevelNodes > 0 && !this->firstNodeIsDeclaration))
+    {
+      return this->Fail("Declaration is not at the start of the document");
+    }
+    this->Advance(2);
+    if (!this->ReadUntil("?>", this->text))
+    {
+      return this->Fail("Declaration is not closed");
+    }
+    declaration = true;
+    token = Token::OTHER;
+  }
+  else if (this->LookingAt("</"))
+  {
+    this->Advance(2);
+    return this->ReadEndTag();
+  }
+  else
+  {
+    this->Advance(1);
+    token = this->ReadStartTag();
+  }
+
+  if (topLevel && token != Token::ERROR)
+  {
+    if (this->topLevelNodes == 0)
+    {
+      this->firstNodeIsDeclaration = declaration;
+    }
+    ++this->topLevelNodes;
+  }
+  return token;
+}
+
+/////////////////////////////////////////////////
+XmlStreamReader::Token XmlStreamReader::ReadStartTag()
+{
+  if (!this->ReadName(this->name))
+  {
+    return this->Fail("Invalid element name");
+  }
+
+  this->attributes.clear();
+  while (true)
+  {
+    this->SkipWhitespace();
+    const int c = this->Peek();
+    if (c == '>')
+    {
+      this->Advance(1);
+      break;
+    }
+    else if (c == '/' && this->Peek(1) == '>')
+    {
+      this->Advance(2);
+      this->pendingEnd = true;
+      break;
+    }
+
+    std::string attributeName;
+    if (!this->ReadName(attributeName))
+    {
+      return this->Fail("Invalid attribute in element <" + this->name + ">");
+    }
+
+    this->SkipWhitespace();
+    if (this->Peek() != '=')
+    {
+      return this->Fail("Attribute [" + attributeName + "] in element <" +
+          this->name + "> has no value");
+    }
+    this->Advance(1);
+    this->SkipWhitespace();
+
+    const int quote = this->Peek();
+    if (quote != '"' && quote != '\'')
+    {
+      return this->Fail("Value of attribute [" + attributeName +
+          "] in element <" + this->name + "> is not quoted");
+    }
+    this->Advance(1);
+
+    std::string raw;
+    if (!this->ReadUntil(std::string(1, static_cast<char>(quote)), raw))
+    {
+      return this->Fail("Value of attribute [" + attributeName +
+          "] in element <" + this->name + "> is not closed");
+    }
+    if (hasUnsupportedReference(raw))
+    {
+      return this->FailUnsupported("Character reference in attribute [" +
+          attributeName + "] of element <" + this->name + ">");
+    }
+
+    for (const auto &attribute : this->attributes)
+    {
+      if (attribute.first == attributeName)
+      {
+        return this->Fail("Attribute [" + attributeName +
+            "] is repeated in element <" + this->name + ">");
+      }
+    }
+    this->attributes.emplace_back(
+        std::move(attributeName), processText(std::move(raw), true));
+  }
+
+  this->openElements.push_back(this->name);
+  return Token::START_ELEMENT;
+}
+
+/////////////////////////////////////////////////
+XmlStreamReader::Token XmlStreamReader::ReadEndTag()
+{
+  if (!this->ReadName(this->name))
+  {
+    return this->Fail("Invalid end tag");
+  }
+
+  this->SkipWhitespace();
+  if (this->Peek() != '>')
+  {
+    return this->Fail("End tag of element <" + this->name +
+        "> is not closed");
+  }
+  this->Advance(1);
+
+  if (this->openElements.empty() || this->openElements.back() != this->name)
+  {
+    return this->Fail("End tag of element <" + this->name +
+        "> doesn't match a start tag");
+  }
+
+  this->openElements.pop_back();
+  this->depth = this->openElements.size();
+  return Token::END_ELEMENT;
+}
+
+/////////////////////////////////////////////////
+bool XmlStreamReader::ReadName(std::string &_name)
+{
+  if (!isNameStartChar(this->Peek()))
+  {
+    return false;
+  }
+
+  _name.clear();
+  for (int c = this->Peek(); c >= 0 && isNameChar(c); c = this->Peek())
+  {
+    _name += static_cast<char>(c);
+    this->Advance(1);
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool XmlStreamReader::ReadUntil(const std::string &_delimiter,
+    std::string &_text, bool _skipDelimiter)
+{
+  while (true)
+  {
+    const std::string_view window(this->data + this->pos,
+        this->size - this->pos);
+    const std::size_t found = window.find(_delimiter);
+    if (found != std::string_view::npos)
+    {
+      _text.append(window.data(), found);
+      this->Advance(found + (_skipDelimiter ? _delimiter.size() : 0));
+      return true;
+    }
+
+    // Keep the characters that could be the start of a delimiter that
+    // continues after the buffered data.
+    const std::size_t keep = std::min(_delimiter.size() - 1, window.size());
+    _text.append(window.data(), window.size() - keep);
+    this->Advance(window.size() - keep);
+    if (!this->Ensure(keep + 1))
+    {
+      return false;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void XmlStreamReader::SkipWhitespace(std::string *_skipped)
+{
+  for (int c = this->Peek(); isWhitespace(c); c = this->Peek())
+  {
+    if (_skipped)
+    {
+      *_skipped += static_cast<char>(c);
+    }
+    this->Advance(1);
+  }
+}
+
+/////////////////////////////////////////////////
+void XmlStreamReader::Advance(std::size_t _count)
+{
+  this->line += static_cast<int>(std::count(this->data + this->pos,
+      this->data + this->pos + _count, '\n'));
+  this->pos += _count;
+}
+
+/////////////////////////////////////////////////
+bool XmlStreamReader::LookingAt(const char *_prefix)
+{
+  const std::size_t length = std::strlen(_prefix);
+  return this->Ensure(length) &&
+      std::memcmp(this->data + this->pos, _prefix, length) == 0;
+}
+
+/////////////////////////////////////////////////
+bool XmlStreamReader::Ensure(std::size_t _count)
+{
+  if (this->pos + _count <= this->size)
+  {
+    return true;
+  }
+  if (!this->stream)
+  {
+    return false;
+  }
+
+  // Drop the characters that have been read, and read more
+  this->buffer.erase(0, this->pos);
+  this->pos = 0;
+  while (this->buffer.size() < _count && this->stream->good())
+  {
+    const std::size_t oldSize = this->buffer.size();
+    this->buffer.resize(oldSize + kChunkSize);
+    this->stream->read(&this->buffer[oldSize],
+        static_cast<std::streamsize>(kChunkSize));
+    this->buffer.resize(oldSize +
+        static_cast<std::size_t>(this->stream->gcount()));
+  }
+  this->data = this->buffer.data();
+  this->size = this->buffer.size();
+  return _count <= this->size;
+}
+
+/////////////////////////////////////////////////
+int XmlStreamReader::Peek(std::size_t _offset)
+{
+  if (!this->Ensure(_offset + 1))
+  {
+    return -1;
+  }
+  return static_cast<unsigned char>(this->data[this->pos + _offset]);
+}
+
+/////////////////////////////////////////////////
+XmlStreamReader::Token XmlStreamReader::Fail(const std::string &_message)
+{
+  this->error = _message + " (line " + std::to_string(this->line) + ")";
+  this->done = true;
+  return Token::ERROR;
+}
+
+/////////////////////////////////////////////////
+XmlStreamReader::Token XmlStreamReader::FailUnsupported(
+    const std::string &_message)
+{
+  this->unsupported = true;
+  return this->Fail(_message + " is not supported");
+}
+
+/////////////////////////////////////////////////
+const std::string &XmlStreamReader::Name() const
+{
+  return this->name;
+}
+
+/////////////////////////////////////////////////
+const std::vector<std::pair<std::string, std::string>> &
+    XmlStreamReader::Attributes() const
+{
+  return this->attributes;
+}
+
+/////////////////////////////////////////////////
+const std::string &XmlStreamReader::Text() const
+{
+  return this->text;
+}
+
+/////////////////////////////////////////////////
+bool XmlStreamReader::IsCData() const
+{
+  return this->cdata;
+}
+
+/////////////////////////////////////////////////
+std::size_t XmlStreamReader::Depth() const
+{
+  return this->depth;
+}
+
+/////////////////////////////////////////////////
+const std::string &XmlStreamReader::Error() const
+{
+  return this->error;
+}
+
+/////////////////////////////////////////////////
+bool XmlStreamReader::Unsupported() const
+{
+  return this->unsupported;
+}
+}
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDFORMAT_XMLSTREAMREADER_HH_
+#define SDFORMAT_XMLSTREAMREADER_HH_
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sdf/sdf_config.h"
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  /// \brief Pull parser for XML documents.
+  ///
+  /// The document is read one token at a time, without building a tree, so
+  /// only the current token is held in memory. Text and attribute values are
+  /// processed the same way as by TinyXML2 with its default settings:
+  /// entities are replaced, line endings are normalized, and text that only
+  /// contains whitespace between two tags is dropped.
+  ///
+  /// Errors are reported as an ERROR token, after which the reader stops.
+  /// Constructs that aren't read the same way as by TinyXML2, such as
+  /// DOCTYPE declarations with an internal subset and character references
+  /// that start with "&#X", are also reported as an ERROR token, for which
+  /// Unsupported() returns true, so that the document can be parsed by
+  /// TinyXML2 instead.
+  class XmlStreamReader
+  {
+    /// \brief Kinds of tokens.
+    public: enum class Token
+    {
+      /// \brief Start of an element. An empty element, such as <a/>, is
+      /// reported as a START_ELEMENT followed by an END_ELEMENT.
+      START_ELEMENT,
+
+      /// \brief End of an element.
+      END_ELEMENT,
+
+      /// \brief Text or CDATA section.
+      TEXT,
+
+      /// \brief Comment, declaration or processing instruction.
+      OTHER,
+
+      /// \brief End of the document.
+      END_DOCUMENT,
+
+      /// \brief The document isn't well formed, or couldn't be read.
+      ERROR
+    };
+
+    /// \brief Constructor that reads a document from a stream.
+    /// \param[in] _stream Stream to read from. It must outlive the reader.
+    public: explicit XmlStreamReader(std::istream &_stream);
+
+    /// \brief Constructor that reads a document from memory.
+    /// \param[in] _data Contents of the document. They aren't copied, so
+    /// they must outlive the reader.
+    /// \param[in] _size Size of the document in bytes.
+    public: XmlStreamReader(const char *_data, std::size_t _size);
+
+    /// \brief Read the next token.
+    /// \return The kind of the token.
+    public: Token Next();
+
+    /// \brief Get the name of the current element.
+    /// \return Name of the element of a START_ELEMENT or END_ELEMENT token.
+    public: const std::string &Name() const;
+
+    /// \brief Get the attributes of the current element.
+    /// \return Names and values of the attributes of a START_ELEMENT token,
+    /// in document order.
+    public: const std::vector<std::pair<std::string, std::string>> &
+        Attributes() const;
+
+    /// \brief Get the current text.
+    /// \return Contents of a TEXT or OTHER token.
+    public: const std::string &Text() const;
+
+    /// \brief Check whether the current text is a CDATA section.
+    /// \return True if the TEXT token is a CDATA section.
+    public: bool IsCData() const;
+
+    /// \brief Get the number of elements the current token is nested in.
+    /// \return Depth of the token. The root element has a depth of 0.
+    public: std::size_t Depth() const;
+
+    /// \brief Get a description of the error.
+    /// \return The error of an ERROR token, or an empty string.
+    public: const std::string &Error() const;
+
+    /// \brief Check whether the reader stopped at a construct that it
+    /// doesn't read the same way as TinyXML2.
+    /// \return True if the ERROR token is for such a construct.
+    public: bool Unsupported() const;
+
+    /// \brief Read a start tag, after the '<'.
+    /// \return START_ELEMENT or ERROR.
+    private: Token ReadStartTag();
+
+    /// \brief Read an end tag, after the "</".
+    /// \return END_ELEMENT or ERROR.
+    private: Token ReadEndTag();
+
+    /// \brief Read a name.
+    /// \param[out] _name The name.
+    /// \return False if there's no name at the current position.
+    private: bool ReadName(std::string &_name);
+
+    /// \brief Read up to a delimiter.
+    /// \param[in] _delimiter Delimiter to look for.
+    /// \param[out] _text The characters before the delimiter are appended
+    /// to this.
+    /// \param[in] _skipDelimiter True to also consume the delimiter.
+    /// \return False if the document ends before the delimiter.
+    private: bool ReadUntil(const std::string &_delimiter, std::string &_text,
+                            bool _skipDelimiter = true);
+
+    /// \brief Skip whitespace.
+    /// \param[out] _skipped If not null, the skipped characters are appended
+    /// to this.
+    private: void SkipWhitespace(std::string *_skipped = nullptr);
+
+    /// \brief Consume buffered characters.
+    /// \param[in] _count Number of characters.
+    private: void Advance(std::size_t _count);
+
+    /// \brief Check whether the input continues with the given string.
+    /// \param[in] _prefix The string to look for.
+    /// \return True if it does.
+    private: bool LookingAt(const char *_prefix);
+
+    /// \brief Make sure that a number of characters are buffered.
+    /// \param[in] _count Number of characters.
+    /// \return False if the document ends before that.
+    private: bool Ensure(std::size_t _count);
+
+    /// \brief Get a character without consuming it.
+    /// \param[in] _offset Offset from the current position.
+    /// \return The character, or -1 at the end of the document.
+    private: int Peek(std::size_t _offset = 0);
+
+    /// \brief Set an error.
+    /// \param[in] _message Description of the error.
+    /// \return ERROR.
+    private: Token Fail(const std::string &_message);
+
+    /// \brief Set an error for a construct that isn't supported.
+    /// \param[in] _message Description of the construct.
+    /// \return ERROR.
+    private: Token FailUnsupported(const std::string &_message);
+
+    /// \brief Stream to read from, or nullptr when reading from memory.
+    private: std::istream *stream = nullptr;
+
+    /// \brief Buffered part of a stream.
+    private: std::string buffer;
+
+    /// \brief Start of the unread characters.
+    private: const char *data = nullptr;
+
+    /// \brief Number of characters available at data.
+    private: std::size_t size = 0;
+
+    /// \brief Position of the next character to read in data.
+    private: std::size_t pos = 0;
+
+    /// \brief Current line, counted from 1.
+    private: int line = 1;
+
+    /// \brief Names of the open elements.
+    private: std::vector<std::string> openElements;
+
+    /// \brief Depth of the current token.
+    private: std::size_t depth = 0;
+
+    /// \brief True if the current element was empty, so that an
+    /// END_ELEMENT is reported next.
+    private: bool pendingEnd = false;
+
+    /// \brief True once the byte order mark has been checked.
+    private: bool started = false;
+
+    /// \brief Number of nodes read outside of any element.
+    private: std::size_t topLevelNodes = 0;
+
+    /// \brief True if the first node outside of any element was a
+    /// declaration.
+    private: bool firstNodeIsDeclaration = false;
+
+    /// \brief Name of the current element.
+    private: std::string name;
+
+    /// \brief Attributes of the current element.
+    private: std::vector<std::pair<std::string, std::string>> attributes;
+
+    /// \brief Current text.
+    private: std::string text;
+
+    /// \brief True if the current text is a CDATA section.
+    private: bool cdata = false;
+
+    /// \brief Description of the error.
+    private: std::string error;
+
+    /// \brief True if the error is for a construct that isn't supported.
+    private: bool unsupported = false;
+
+    /// \brief True after the end of the document or an error.
+    private: bool done = false;
+  };
+  }
+}
+#endif
@@ -0,0 +1,279 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <tinyxml2.h>
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "sdf/Filesystem.hh"
+
+#include "XmlStreamReader.hh"
+#include "test_config.h"
+
+using Token = sdf::XmlStreamReader::Token;
+
+/////////////////////////////////////////////////
+/// \brief Read a whole document and describe its tokens.
+std::string tokens(sdf::XmlStreamReader &_reader)
+{
+  std::string result;
+  while (true)
+  {
+    switch (_reader.Next())
+    {
+      case Token::START_ELEMENT:
+        result += "<" + _reader.Name();
+        for (const auto &attribute : _reader.Attributes())
+        {
+          result += " " + attribute.first + "=" + attribute.second;
+        }
+        result += ">";
+        break;
+      case Token::END_ELEMENT:
+        result += "</" + _reader.Name() + ">";
+        break;
+      case Token::TEXT:
+        result += (_reader.IsCData() ? "C[" : "T[") + _reader.Text() + "]";
+        break;
+      case Token::OTHER:
+        result += "O";
+        break;
+      case Token::END_DOCUMENT:
+        return result;
+      case Token::ERROR:
+        return result + "!";
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Read a whole document from a string and describe its tokens.
+std::string tokens(const std::string &_document)
+{
+  sdf::XmlStreamReader reader(_document.data(), _document.size());
+  return tokens(reader);
+}
+
+/////////////////////////////////////////////////
+TEST(XmlStreamReader, Elements)
+{
+  EXPECT_EQ("O<sdf version=1.8><a x=1></a><b><c></c></b></sdf>",
+      tokens("<?xml version='1.0'?>\n"
+             "<sdf version=\"1.8\">\n"
+             "  <a x='1'/>\n"
+             "  <b><c /></b>\n"
+             "</sdf>\n"));
+
+  // Comments and declarations
+  EXPECT_EQ("OO<a>O</a>", tokens("<!--c--><!DOCTYPE a><a><!-- c --></a>"));
+}
+
+/////////////////////////////////////////////////
+TEST(XmlStreamReader, Text)
+{
+  // Whitespace between tags is dropped, but kept around other text
+  EXPECT_EQ("<a>T[ x  y ]<b></b></a>", tokens("<a> x  y <b/>\n</a>"));
+
+  // Entities and line endings
+  EXPECT_EQ("<a v=<&>\"'>T[<&AB\xE2\x82\xAC&foo;\n\n]</a>",
+      tokens("<a v='&lt;&amp;&gt;&quot;&apos;'>"
+             "&lt;&amp;&#65;&#x42;&#x20AC;&foo;\r\n\r</a>"));
+
+  // CDATA is kept as is
+  EXPECT_EQ("<a>C[ <b>&amp; ]</a>", tokens("<a> <![CDATA[ <b>&amp; ]]></a>"));
+
+  // Text after a comment
+  EXPECT_EQ("<a>OT[x]</a>", tokens("<a><!--c-->x</a>"));
+}
+
+/////////////////////////////////////////////////
+TEST(XmlStreamReader, Depth)
+{
+  const std::string document = "<a><b>x</b></a>";
+  sdf::XmlStreamReader reader(document.data(), document.size());
+  EXPECT_EQ(Token::START_ELEMENT, reader.Next());
+  EXPECT_EQ(0u, reader.Depth());
+  EXPECT_EQ(Token::START_ELEMENT, reader.Next());
+  EXPECT_EQ(1u, reader.Depth());
+  EXPECT_EQ(Token::TEXT, reader.Next());
+  EXPECT_EQ(2u, reader.Depth());
+  EXPECT_EQ(Token::END_ELEMENT, reader.Next());
+  EXPECT_EQ(1u, reader.Depth());
+  EXPECT_EQ(Token::END_ELEMENT, reader.Next());
+  EXPECT_EQ(0u, reader.Depth());
+  EXPECT_EQ(Token::END_DOCUMENT, reader.Next());
+  EXPECT_EQ(Token::END_DOCUMENT, reader.Next());
+  EXPECT_TRUE(reader.Error().empty());
+}
+
+/////////////////////////////////////////////////
+TEST(XmlStreamReader, Errors)
+{
+  for (const std::string document : {
+      "", "  ", "<a>", "<a></b>", "</a>", "<a x=1/>", "<a x='1' x='2'/>",
+      "<a x='1/>", "<a/>text", "<a/><?xml?>", "<a><?xml?></a>", "< a/>",
+      "<a><!-- c</a>", "<a><![CDATA[x</a>"})
+  {
+    sdf::XmlStreamReader reader(document.data(), document.size());
+    const std::string result = tokens(reader);
+    EXPECT_EQ('!', result.back()) << document;
+    EXPECT_FALSE(reader.Error().empty()) << document;
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(XmlStreamReader, Unsupported)
+{
+  for (const std::string document : {
+      "<!DOCTYPE a [<!ENTITY e 'x'>]><a/>", "<a>&#X41;</a>",
+      "<a x='&#X41;'/>"})
+  {
+    sdf::XmlStreamReader reader(document.data(), document.size());
+    const std::string result = tokens(reader);
+    EXPECT_EQ('!', result.back()) << document;
+    EXPECT_TRUE(reader.Unsupported()) << document;
+    EXPECT_FALSE(reader.Error().empty()) << document;
+  }
+
+  // Other errors aren't reported as unsupported
+  const std::string document = "<a></b>";
+  sdf::XmlStreamReader reader(document.data(), document.size());
+  EXPECT_EQ("<a>!", tokens(reader));
+  EXPECT_FALSE(reader.Unsupported());
+}
+
+/////////////////////////////////////////////////
+/// \brief Describe the children of a TinyXML2 node the same way as tokens
+/// describes the tokens of a reader.
+std::string tinyxmlTokens(const tinyxml2::XMLNode *_node)
+{
+  std::string result;
+  for (const tinyxml2::XMLNode *child = _node->FirstChild(); child;
+       child = child->NextSibling())
+  {
+    if (const tinyxml2::XMLElement *element = child->ToElement())
+    {
+      result += "<" + std::string(element->Name());
+      for (const tinyxml2::XMLAttribute *attribute =
+           element->FirstAttribute(); attribute; attribute = attribute->Next())
+      {
+        result += " " + std::string(attribute->Name()) + "=" +
+            attribute->Value();
+      }
+      result += ">" + tinyxmlTokens(element) + "</" + element->Name() + ">";
+    }
+    else if (const tinyxml2::XMLText *text = child->ToText())
+    {
+      result += (text->CData() ? "C[" : "T[") + std::string(text->Value()) +
+          "]";
+    }
+    else
+    {
+      result += "O";
+    }
+  }
+  return result;
+}
+
+/////////////////////////////////////////////////
+/// \brief Find the XML files in a directory and its subdirectories.
+/// \param[in] _dir The directory.
+/// \param[out] _files The paths of the files are appended to this.
+void findXmlFiles(const std::string &_dir, std::vector<std::string> &_files)
+{
+  sdf::filesystem::DirIter endIter;
+  for (sdf::filesystem::DirIter dirIter(_dir); dirIter != endIter; ++dirIter)
+  {
+    const std::string path = *dirIter;
+    if (sdf::filesystem::is_directory(path))
+    {
+      findXmlFiles(path, _files);
+      continue;
+    }
+
+    for (const std::string extension : {".sdf", ".urdf", ".world", ".config"})
+    {
+      if (path.size() > extension.size() &&
+          path.compare(path.size() - extension.size(), extension.size(),
+                       extension) == 0)
+      {
+        _files.push_back(path);
+      }
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(XmlStreamReader, TinyXml2Parity)
+{
+  // Every XML file of the tests is read the same way as by TinyXML2, or
+  // reported as unsupported.
+  std::vector<std::string> files;
+  findXmlFiles(sdf::filesystem::append(PROJECT_SOURCE_PATH, "test"), files);
+  ASSERT_FALSE(files.empty());
+
+  for (const std::string &file : files)
+  {
+    SCOPED_TRACE(file);
+    std::ifstream stream(file, std::ios::in | std::ios::binary);
+    const std::string content((std::istreambuf_iterator<char>(stream)),
+                              std::istreambuf_iterator<char>());
+
+    sdf::XmlStreamReader reader(content.data(), content.size());
+    const std::string streamTokens = tokens(reader);
+    if (reader.Unsupported())
+    {
+      continue;
+    }
+
+    tinyxml2::XMLDocument doc;
+    if (doc.Parse(content.c_str(), content.size()) != tinyxml2::XML_SUCCESS)
+    {
+      EXPECT_FALSE(reader.Error().empty());
+      continue;
+    }
+    EXPECT_TRUE(reader.Error().empty()) << reader.Error();
+    EXPECT_EQ(tinyxmlTokens(&doc), streamTokens);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(XmlStreamReader, Stream)
+{
+  // A document that is larger than the chunks read from a stream, so that
+  // tokens cross the chunk boundaries.
+  std::string document = "\xEF\xBB\xBF<r>";
+  for (int i = 0; i < 20000; ++i)
+  {
+    document += "<e n='" + std::to_string(i) + "'><!-- comment -->"
+        "<![CDATA[x]]>t&amp;" + std::to_string(i) + "</e>\r\n";
+  }
+  document += "</r>";
+
+  std::istringstream stream(document);
+  sdf::XmlStreamReader streamReader(stream);
+  const std::string streamTokens = tokens(streamReader);
+  EXPECT_TRUE(streamReader.Error().empty());
+  EXPECT_EQ(tokens(document), streamTokens);
+  EXPECT_EQ("<e n=19999>OC[x]T[t&19999]</e></r>",
+      streamTokens.substr(streamTokens.size() - 34));
+}
@@ -15,8 +15,21 @@
  *
 */
 
+#include <tinyxml2.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <sstream>
 #include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "sdf/sdf_config.h"
 #include "sdf/Filesystem.hh"
@@ -157,3 +170,260 @@ extern "C" SDFORMAT_VISIBLE int cmdPrint(const char *_path)
 
   return 0;
 }
+
+//////////////////////////////////////////////////
+/// \brief Name of the file in the output directory of cmdConvertUrdf that
+/// records the hash of the input of each output file.
+static const char kUrdfCacheFileName[] = ".urdf_to_sdf_cache";
+
+//////////////////////////////////////////////////
+/// \brief Hash the contents of a URDF file, with the library version so
+/// that a new version converts the files again.
+/// \param[in] _content Contents of the file.
+/// \return 64 bit FNV-1a hash, as 16 hexadecimal digits.
+static std::string hashUrdf(const std::string &_content)
+{
+  std::uint64_t hash = 14695981039346656037ULL;
+  auto add = [&hash](const std::string &_str)
+  {
+    for (const char c : _str)
+    {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 1099511628211ULL;
+    }
+  };
+  add(SDF_VERSION_FULL);
+  add("\n");
+  add(_content);
+
+  std::ostringstream stream;
+  stream << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return stream.str();
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the name of the SDF file a URDF file is converted to.
+/// \param[in] _path Path to the URDF file.
+/// \return The base name of _path with its extension replaced by ".sdf".
+static std::string sdfFileName(const std::string &_path)
+{
+  std::string name = sdf::filesystem::basename(_path);
+  const std::size_t dot = name.rfind('.');
+  if (dot != std::string::npos && dot > 0)
+  {
+    name.erase(dot);
+  }
+  return name + ".sdf";
+}
+
+//////////////////////////////////////////////////
+/// \brief Convert many URDF files to SDF files in a directory, on several
+/// threads. Each output file is named after its input file, with the
+/// ".sdf" extension, and holds what 'ign sdf -p' prints for the input.
+/// The hash of each input is kept in the output directory, so inputs that
+/// didn't change since they were last converted are skipped.
+/// \param[in] _outputDir Directory of the SDF files. It's created if it
+/// doesn't exist.
+/// \param[in] _paths Paths to the URDF files, separated by new lines.
+/// \param[in] _threadCount Number of threads, or 0 to use one thread per
+/// core.
+/// \return 0 if all files were converted or skipped, -1 otherwise.
+// cppcheck-suppress unusedFunction
+extern "C" SDFORMAT_VISIBLE int cmdConvertUrdf(const char *_outputDir,
+    const char *_paths, int _threadCount)
+{
+  const std::string outputDir = _outputDir;
+  if (!sdf::filesystem::is_directory(outputDir) &&
+      !sdf::filesystem::create_directory(outputDir))
+  {
+    std::cerr << "Error: Unable to create directory [" << outputDir
+              << "].\n";
+    return -1;
+  }
+
+  std::vector<std::string> paths;
+  {
+    std::istringstream stream(_paths);
+    std::string path;
+    while (std::getline(stream, path))
+    {
+      if (!path.empty())
+      {
+        paths.push_back(path);
+      }
+    }
+  }
+
+  // Read the hashes of the last conversion, by output file name
+  const std::string cachePath =
+      sdf::filesystem::append(outputDir, kUrdfCacheFileName);
+  std::map<std::string, std::string> cache;
+  {
+    // Each line is a hash and a file name, which may contain spaces
+    std::ifstream cacheFile(cachePath);
+    std::string line;
+    while (std::getline(cacheFile, line))
+    {
+      const std::size_t space = line.find(' ');
+      if (space != std::string::npos)
+      {
+        cache[line.substr(space + 1)] = line.substr(0, space);
+      }
+    }
+  }
+
+  enum class Status { CONVERTED, UNCHANGED, FAILED };
+  struct Conversion
+  {
+    std::string output;
+    std::string hash;
+    Status status = Status::FAILED;
+    std::string message;
+  };
+  std::vector<Conversion> conversions(paths.size());
+
+  // Two inputs with the same name would overwrite each other's output
+  std::map<std::string, std::size_t> outputs;
+  for (std::size_t i = 0; i < paths.size(); ++i)
+  {
+    conversions[i].output = sdfFileName(paths[i]);
+    if (!outputs.emplace(conversions[i].output, i).second)
+    {
+      conversions[i].message = "Output [" + conversions[i].output +
+          "] is also the output of [" +
+          paths[outputs[conversions[i].output]] + "].";
+      conversions[i].output.clear();
+    }
+  }
+
+  auto convert = [&](const std::size_t _index)
+  {
+    Conversion &conversion = conversions[_index];
+    if (conversion.output.empty())
+    {
+      return;
+    }
+
+    std::ifstream input(paths[_index], std::ios::in | std::ios::binary);
+    if (!input)
+    {
+      conversion.message = "Unable to read file.";
+      return;
+    }
+    const std::string content{std::istreambuf_iterator<char>(input),
+                              std::istreambuf_iterator<char>()};
+
+    const std::string outputPath =
+        sdf::filesystem::append(outputDir, conversion.output);
+    conversion.hash = hashUrdf(content);
+    auto cached = cache.find(conversion.output);
+    if (cached != cache.end() && cached->second == conversion.hash &&
+        sdf::filesystem::exists(outputPath))
+    {
+      conversion.status = Status::UNCHANGED;
+      return;
+    }
+
+    tinyxml2::XMLDocument xmlDoc;
+    if (xmlDoc.Parse(content.c_str()) != tinyxml2::XML_SUCCESS ||
+        !xmlDoc.FirstChildElement("robot"))
+    {
+      conversion.message = "Not a URDF file.";
+      return;
+    }
+
+    sdf::SDFPtr sdf(new sdf::SDF());
+    sdf::Errors errors;
+    if (!sdf::init(sdf) || !sdf::readString(content, sdf, errors))
+    {
+      conversion.message = "Conversion failed.";
+      for (const auto &error : errors)
+      {
+        conversion.message += "\n  " + error.Message();
+      }
+      return;
+    }
+
+    std::ofstream output(outputPath, std::ios::out | std::ios::trunc);
+    output << sdf->Root()->ToString("");
+    output.close();
+    if (!output)
+    {
+      conversion.message = "Unable to write [" + outputPath + "].";
+      return;
+    }
+    conversion.status = Status::CONVERTED;
+  };
+
+  // Each thread takes the next file until there are none left
+  std::size_t threadCount = _threadCount > 0 ?
+      static_cast<std::size_t>(_threadCount) :
+      std::max(std::thread::hardware_concurrency(), 1u);
+  threadCount = std::max<std::size_t>(
+      std::min(threadCount, paths.size()), 1u);
+  std::atomic<std::size_t> next{0};
+  auto worker = [&]()
+  {
+    for (std::size_t i = next++; i < paths.size(); i = next++)
+    {
+      convert(i);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < threadCount; ++i)
+  {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  // Report in the order of the inputs, and record the hashes of the
+  // outputs that are up to date. Entries of other outputs are kept, so
+  // that converting part of the files doesn't invalidate the others.
+  std::size_t converted = 0;
+  std::size_t unchanged = 0;
+  std::size_t failed = 0;
+  for (std::size_t i = 0; i < paths.size(); ++i)
+  {
+    const Conversion &conversion = conversions[i];
+    switch (conversion.status)
+    {
+      case Status::CONVERTED:
+        ++converted;
+        cache[conversion.output] = conversion.hash;
+        break;
+      case Status::UNCHANGED:
+        ++unchanged;
+        break;
+      case Status::FAILED:
+      default:
+        ++failed;
+        if (!conversion.output.empty())
+        {
+          cache.erase(conversion.output);
+        }
+        std::cerr << "Error: [" << paths[i] << "]: " << conversion.message
+                  << "\n";
+        break;
+    }
+  }
+
+  std::ofstream cacheFile(cachePath, std::ios::out | std::ios::trunc);
+  for (const auto &entry : cache)
+  {
+    cacheFile << entry.second << " " << entry.first << "\n";
+  }
+  cacheFile.close();
+  if (!cacheFile)
+  {
+    std::cerr << "Error: Unable to write [" << cachePath << "].\n";
+    return -1;
+  }
+
+  std::cout << "Converted " << converted << ", unchanged " << unchanged
+            << ", failed " << failed << ".\n";
+  return failed == 0 ? 0 : -1;
+}
@@ -18,8 +18,11 @@
 #include <gtest/gtest.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <fstream>
+#include <iterator>
 #include <string>
 
+#include "sdf/Filesystem.hh"
 #include "sdf/parser.hh"
 #include "sdf/SDFImpl.hh"
 #include "sdf/sdf_config.h"
@@ -784,6 +787,71 @@ TEST(print, SDF)
   }
 }
 
+/////////////////////////////////////////////////
+TEST(urdf_to_sdf, SDF)
+{
+  std::string pathBase = PROJECT_SOURCE_PATH;
+  pathBase += "/test/integration";
+  const std::string path1 = pathBase + "/fixed_joint_reduction.urdf";
+  const std::string path2 = pathBase + "/force_torque_sensor.urdf";
+
+  std::string outputDir = PROJECT_BINARY_DIR;
+  outputDir += "/test/urdf_to_sdf";
+  const std::string outputPath1 =
+    sdf::filesystem::append(outputDir, "fixed_joint_reduction.sdf");
+  const std::string outputPath2 =
+    sdf::filesystem::append(outputDir, "force_torque_sensor.sdf");
+
+  // Start without outputs of a previous run
+  std::remove(sdf::filesystem::append(outputDir,
+        ".urdf_to_sdf_cache").c_str());
+  std::remove(outputPath1.c_str());
+  std::remove(outputPath2.c_str());
+
+  const std::string command = g_ignCommand + " sdf -u " + outputDir + " " +
+    path1 + " " + path2 + g_sdfVersion;
+
+  // Convert both files
+  {
+    std::string output = custom_exec_str(command);
+    EXPECT_EQ("Converted 2, unchanged 0, failed 0.\n", output);
+
+    sdf::SDFPtr sdf(new sdf::SDF());
+    EXPECT_TRUE(sdf::init(sdf));
+    EXPECT_TRUE(sdf::readFile(path1, sdf));
+
+    std::ifstream outputFile(outputPath1);
+    const std::string content{std::istreambuf_iterator<char>(outputFile),
+                              std::istreambuf_iterator<char>()};
+    EXPECT_EQ(sdf->Root()->ToString(""), content);
+  }
+
+  // Files that didn't change are skipped
+  {
+    std::string output = custom_exec_str(command);
+    EXPECT_EQ("Converted 0, unchanged 2, failed 0.\n", output);
+  }
+
+  // Outputs that were removed are written again
+  {
+    std::remove(outputPath2.c_str());
+    std::string output = custom_exec_str(command + " -j 1");
+    EXPECT_EQ("Converted 1, unchanged 1, failed 0.\n", output);
+    EXPECT_TRUE(sdf::filesystem::exists(outputPath2));
+  }
+
+  // A file that isn't URDF fails
+  {
+    std::string path = PROJECT_SOURCE_PATH;
+    path += "/test/sdf/box_plane_low_friction_test.world";
+    std::string output = custom_exec_str(g_ignCommand + " sdf -u " +
+        outputDir + " " + path + g_sdfVersion);
+    EXPECT_NE(std::string::npos, output.find("Not a URDF file.")) << output;
+    EXPECT_NE(std::string::npos,
+        output.find("Converted 0, unchanged 0, failed 1.")) << output;
+  }
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
@@ -15,10 +15,18 @@
  *
  */
 
+#include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <cstdlib>
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <ignition/math/SemanticVersion.hh>
 
@@ -36,9 +44,12 @@
 #include "sdf/sdf_config.h"
 
 #include "Converter.hh"
-#include "FrameSemantics.hh"
+#include "EmbeddedSdf.hh"
+#include "IncludeCache.hh"
+#include "InstrumentationPrivate.hh"
 #include "parser_private.hh"
 #include "parser_urdf.hh"
+#include "XmlStreamReader.hh"
 
 namespace sdf
 {
@@ -94,23 +105,171 @@ static inline bool _initFile(const std::string &_filename, TPtr _sdf)
 }
 
 //////////////////////////////////////////////////
-bool init(SDFPtr _sdf)
+/// \brief Populate an element description from the generated spec tables.
+/// This reads the same information that initXml reads from a spec file.
+/// \param[in] _schema The generated spec tables.
+/// \param[in] _index Index of the element in _schema.elements.
+/// \param[in] _sdf Element to populate.
+static void initSchemaElement(const EmbeddedSdfSchema &_schema,
+    const std::size_t _index, ElementPtr _sdf)
 {
-  std::string xmldata = SDF::EmbeddedSpec("root.sdf", false);
-  tinyxml2::XMLDocument xmlDoc;
-  xmlDoc.Parse(xmldata.c_str());
-  return initDoc(&xmlDoc, _sdf);
+  const EmbeddedSdfElement &elem = _schema.elements[_index];
+
+  if (elem.ref)
+  {
+    _sdf->SetReferenceSDF(elem.ref);
+  }
+  _sdf->SetName(elem.name);
+  _sdf->SetRequired(elem.required);
+
+  if (elem.type)
+  {
+    bool required = std::string(elem.required) == "1";
+    _sdf->AddValue(elem.type, elem.defaultValue, required,
+        elem.minValue ? elem.minValue : "",
+        elem.maxValue ? elem.maxValue : "", elem.description);
+  }
+
+  for (std::size_t i = 0; i < elem.attributeCount; ++i)
+  {
+    const EmbeddedSdfAttribute &attr =
+        _schema.attributes[elem.firstAttribute + i];
+    bool required = sdf::trim(attr.required) == "1";
+    _sdf->AddAttribute(attr.name, attr.type, attr.defaultValue, required,
+        attr.description);
+  }
+
+  _sdf->SetDescription(elem.description);
+
+  if (elem.copyData)
+  {
+    _sdf->SetCopyChildren(true);
+  }
+
+  for (std::size_t i = 0; i < elem.childCount; ++i)
+  {
+    ElementPtr element(new Element);
+    initSchemaElement(_schema, _schema.children[elem.firstChild + i], element);
+    _sdf->AddElementDescription(element);
+  }
+
+  for (std::size_t i = 0; i < elem.includeCount; ++i)
+  {
+    const EmbeddedSdfInclude &include =
+        _schema.includes[elem.firstInclude + i];
+    ElementPtr element(new Element);
+    initFile(include.filename, element);
+
+    // override description for include elements
+    if (include.description)
+    {
+      element->SetDescription(include.description);
+    }
+
+    _sdf->AddElementDescription(element);
+  }
 }
 
 //////////////////////////////////////////////////
-bool initFile(const std::string &_filename, SDFPtr _sdf)
+/// \brief Find a spec file in the generated spec tables.
+/// \param[in] _pathname Source-relative pathname, such as "1.8/root.sdf".
+/// \return The spec, or nullptr if it is not in the tables.
+static const EmbeddedSdfSpec *findSchemaSpec(const std::string &_pathname)
 {
-  std::string xmldata = SDF::EmbeddedSpec(_filename, true);
-  if (!xmldata.empty())
+  const EmbeddedSdfSchema &schema = GetEmbeddedSdfSchema();
+  const EmbeddedSdfSpec *end = schema.specs + schema.specCount;
+  const EmbeddedSdfSpec *spec = std::lower_bound(schema.specs, end,
+      _pathname, [](const EmbeddedSdfSpec &_spec, const std::string &_name)
+      {
+        return _name.compare(_spec.pathname) > 0;
+      });
+
+  if (spec != end && _pathname == spec->pathname)
+  {
+    return spec;
+  }
+  return nullptr;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the description built from an embedded spec file of the
+/// current SDFormat version.
+///
+/// Descriptions are built from the spec tables generated at build time,
+/// falling back to parsing the embedded spec file if it is not in the
+/// tables. They are built once per spec version and file, and kept in a
+/// process-wide cache. The returned element is shared, so it must be copied
+/// into another element rather than modified.
+/// \param[in] _filename Name of the spec file, e.g. root.sdf.
+/// \param[in] _quiet True to suppress an error if the file is not embedded.
+/// \return The description, or nullptr if the spec file is not embedded or
+/// could not be parsed.
+static ElementPtr embeddedSpecDescription(
+    const std::string &_filename, const bool _quiet)
+{
+  static std::mutex cacheMutex;
+  static std::map<std::string, ElementPtr> cache;
+
+  const std::string key = SDF::Version() + "/" + _filename;
+  {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto iter = cache.find(key);
+    if (iter != cache.end())
+    {
+      return iter->second;
+    }
+  }
+
+  // The lock is not held while building, since included spec files are
+  // built by recursing into this function. If two threads race to build the
+  // same description, the first one to finish is kept.
+  ElementPtr description(new Element);
+  const EmbeddedSdfSpec *spec = findSchemaSpec(key);
+  if (spec)
+  {
+    initSchemaElement(GetEmbeddedSdfSchema(), spec->element, description);
+  }
+  else
   {
+    const std::string &xmldata = SDF::EmbeddedSpec(_filename, _quiet);
+    if (xmldata.empty())
+    {
+      return nullptr;
+    }
+
     tinyxml2::XMLDocument xmlDoc;
     xmlDoc.Parse(xmldata.c_str());
-    return initDoc(&xmlDoc, _sdf);
+    if (!initDoc(&xmlDoc, description))
+    {
+      return nullptr;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  return cache.emplace(key, description).first->second;
+}
+
+//////////////////////////////////////////////////
+bool init(SDFPtr _sdf)
+{
+  ElementPtr description = embeddedSpecDescription("root.sdf", false);
+  if (!description)
+  {
+    return false;
+  }
+
+  _sdf->Root()->Copy(description);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool initFile(const std::string &_filename, SDFPtr _sdf)
+{
+  ElementPtr description = embeddedSpecDescription(_filename, true);
+  if (description)
+  {
+    _sdf->Root()->Copy(description);
+    return true;
   }
   return _initFile(sdf::findFile(_filename), _sdf);
 }
@@ -118,16 +277,95 @@ bool initFile(const std::string &_filename, SDFPtr _sdf)
 //////////////////////////////////////////////////
 bool initFile(const std::string &_filename, ElementPtr _sdf)
 {
-  std::string xmldata = SDF::EmbeddedSpec(_filename, true);
-  if (!xmldata.empty())
+  ElementPtr description = embeddedSpecDescription(_filename, true);
+  if (description)
   {
-    tinyxml2::XMLDocument xmlDoc;
-    xmlDoc.Parse(xmldata.c_str());
-    return initDoc(&xmlDoc, _sdf);
+    _sdf->Copy(description);
+    return true;
   }
   return _initFile(sdf::findFile(_filename), _sdf);
 }
 
+//////////////////////////////////////////////////
+bool warmSchemaCache()
+{
+  return embeddedSpecDescription("root.sdf", false) != nullptr;
+}
+
+/// \brief Number of threads used to load the files of <include> elements.
+static std::atomic<unsigned int> g_includeThreadCount{1};
+
+/// \brief True to read documents with an XmlStreamReader when possible.
+static std::atomic<bool> g_xmlStreaming{false};
+
+/// \brief True on threads that load included files. Includes nested in
+/// those files are loaded serially, so that the number of threads stays
+/// bounded.
+static thread_local bool t_loadingIncludes = false;
+
+/// \brief Marks the current thread as loading an included file while it is
+/// in scope.
+class LoadingIncludesGuard
+{
+  /// \brief Constructor.
+  public: LoadingIncludesGuard()
+    : previous(t_loadingIncludes)
+  {
+    t_loadingIncludes = true;
+  }
+
+  /// \brief Destructor. Restores the previous state.
+  public: ~LoadingIncludesGuard()
+  {
+    t_loadingIncludes = this->previous;
+  }
+
+  /// \brief Whether the thread was loading an included file before.
+  private: bool previous;
+};
+
+//////////////////////////////////////////////////
+void setIncludeThreadCount(unsigned int _threadCount)
+{
+  g_includeThreadCount = std::max(_threadCount, 1u);
+}
+
+//////////////////////////////////////////////////
+unsigned int includeThreadCount()
+{
+  return g_includeThreadCount;
+}
+
+//////////////////////////////////////////////////
+void setIncludeCacheSize(std::size_t _maxEntries)
+{
+  IncludeCache::Instance().SetMaxSize(_maxEntries);
+}
+
+//////////////////////////////////////////////////
+std::size_t includeCacheSize()
+{
+  return IncludeCache::Instance().MaxSize();
+}
+
+//////////////////////////////////////////////////
+void clearIncludeCache()
+{
+  IncludeCache::Instance().Clear();
+}
+
+//////////////////////////////////////////////////
+void setXmlStreaming(bool _enabled)
+{
+  g_xmlStreaming = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool xmlStreaming()
+{
+  return g_xmlStreaming;
+}
+
 //////////////////////////////////////////////////
 bool initString(const std::string &_xmlString, SDFPtr _sdf)
 {
@@ -386,10 +624,25 @@ bool readFileWithoutConversion(
   return readFileInternal(_filename, _sdf, false, _errors);
 }
 
+//////////////////////////////////////////////////
+/// \brief Count an element and its descendants.
+/// \param[in] _elem The element.
+/// \return The number of elements.
+static std::size_t countElements(const ElementPtr &_elem)
+{
+  std::size_t count = 1;
+  for (const ElementPtr &child : _elem->Children())
+  {
+    count += countElements(child);
+  }
+  return count;
+}
+
 //////////////////////////////////////////////////
 bool readFileInternal(const std::string &_filename, SDFPtr _sdf,
       const bool _convert, Errors &_errors)
 {
+  std::string content;
   tinyxml2::XMLDocument xmlDoc;
   std::string filename = sdf::findFile(_filename, true, true);
 
@@ -410,24 +663,69 @@ bool readFileInternal(const std::string &_filename, SDFPtr _sdf,
     return false;
   }
 
-  auto error_code = xmlDoc.LoadFile(filename.c_str());
-  if (error_code)
+  StreamReadResult streamResult = StreamReadResult::UNSUPPORTED;
+  if (g_xmlStreaming)
   {
-    sdferr << "Error parsing XML in file [" << filename << "]: "
-           << xmlDoc.ErrorStr() << '\n';
-    return false;
+    ScopedLoadTimer timer(LoadPhase::READ_XML, filename);
+    std::ifstream stream(filename, std::ios::in | std::ios::binary);
+    XmlStreamReader reader(stream);
+    streamResult = readStream(reader, _sdf, filename, _convert, _errors);
+    if (timer.Active())
+    {
+      timer.SetCount(countElements(_sdf->Root()));
+    }
+    if (streamResult == StreamReadResult::XML_ERROR)
+    {
+      sdferr << "Error parsing XML in file [" << filename << "]: "
+             << reader.Error() << '\n';
+      return false;
+    }
   }
 
-  // Suppress deprecation for sdf::URDF2SDF
-  if (readDoc(&xmlDoc, _sdf, filename, _convert, _errors))
+  if (streamResult == StreamReadResult::SUCCESS)
   {
     return true;
   }
-  else if (URDF2SDF::IsURDF(filename))
+  else if (streamResult == StreamReadResult::UNSUPPORTED)
+  {
+    ScopedLoadTimer timer(LoadPhase::XML_PARSE, filename);
+    {
+      std::ifstream stream(filename, std::ios::in | std::ios::binary);
+      content.assign(std::istreambuf_iterator<char>(stream),
+                     std::istreambuf_iterator<char>());
+    }
+    auto error_code = xmlDoc.Parse(content.c_str(), content.size());
+    timer.Stop();
+    if (error_code)
+    {
+      sdferr << "Error parsing XML in file [" << filename << "]: "
+             << xmlDoc.ErrorStr() << '\n';
+      return false;
+    }
+
+    if (readDoc(&xmlDoc, _sdf, filename, _convert, _errors))
+    {
+      return true;
+    }
+  }
+
+  // A URDF file is converted from the content and document read above, so
+  // it's only read and parsed once. A streamed document has an <sdf> root
+  // element, and xmlDoc is empty then.
+  if (xmlDoc.FirstChildElement("robot") != nullptr)
   {
     URDF2SDF u2g;
     tinyxml2::XMLDocument doc;
-    u2g.InitModelFile(filename, &doc);
+    bool converted = false;
+    {
+      ScopedLoadTimer timer(LoadPhase::CONVERT, filename);
+      converted = u2g.InitModelParsed(content, xmlDoc, &doc);
+    }
+    if (!converted)
+    {
+      return false;
+    }
+
     if (sdf::readDoc(&doc, _sdf, "urdf file", _convert, _errors))
     {
       sdfdbg << "parse from urdf file [" << _filename << "].\n";
@@ -473,14 +771,40 @@ bool readStringWithoutConversion(
 bool readStringInternal(const std::string &_xmlString, SDFPtr _sdf,
     const bool _convert, Errors &_errors)
 {
+  StreamReadResult streamResult = StreamReadResult::UNSUPPORTED;
+  if (g_xmlStreaming)
+  {
+    ScopedLoadTimer timer(LoadPhase::READ_XML, "data-string");
+    XmlStreamReader reader(_xmlString.data(), _xmlString.size());
+    streamResult = readStream(reader, _sdf, "data-string", _convert, _errors);
+    if (timer.Active())
+    {
+      timer.SetCount(countElements(_sdf->Root()));
+    }
+    if (streamResult == StreamReadResult::XML_ERROR)
+    {
+      sdferr << "Error parsing XML from string: " << reader.Error() << '\n';
+      return false;
+    }
+  }
+
   tinyxml2::XMLDocument xmlDoc;
-  xmlDoc.Parse(_xmlString.c_str());
-  if (xmlDoc.Error())
+  if (streamResult == StreamReadResult::UNSUPPORTED)
   {
-    sdferr << "Error parsing XML from string: " << xmlDoc.ErrorStr() << '\n';
-    return false;
+    ScopedLoadTimer timer(LoadPhase::XML_PARSE, "data-string");
+    xmlDoc.Parse(_xmlString.c_str());
+    timer.Stop();
+    if (xmlDoc.Error())
+    {
+      sdferr << "Error parsing XML from string: " << xmlDoc.ErrorStr()
+             << '\n';
+      return false;
+    }
   }
-  if (readDoc(&xmlDoc, _sdf, "data-string", _convert, _errors))
+
+  if (streamResult == StreamReadResult::SUCCESS ||
+      (streamResult == StreamReadResult::UNSUPPORTED &&
+       readDoc(&xmlDoc, _sdf, "data-string", _convert, _errors)))
   {
     return true;
   }
@@ -488,7 +812,18 @@ bool readStringInternal(const std::string &_xmlString, SDFPtr _sdf,
   {
     URDF2SDF u2g;
     tinyxml2::XMLDocument doc;
-    u2g.InitModelString(_xmlString, &doc);
+    {
+      ScopedLoadTimer timer(LoadPhase::CONVERT, "urdf string");
+      // Reuse the document parsed above, unless the string was streamed.
+      if (streamResult == StreamReadResult::UNSUPPORTED)
+      {
+        u2g.InitModelParsed(_xmlString, xmlDoc, &doc);
+      }
+      else
+      {
+        u2g.InitModelString(_xmlString, &doc);
+      }
+    }
 
     if (sdf::readDoc(&doc, _sdf, "urdf string", _convert, _errors))
     {
@@ -522,7 +857,9 @@ bool readString(const std::string &_xmlString, ElementPtr _sdf)
 bool readString(const std::string &_xmlString, ElementPtr _sdf, Errors &_errors)
 {
   tinyxml2::XMLDocument xmlDoc;
+  ScopedLoadTimer timer(LoadPhase::XML_PARSE, "data-string");
   xmlDoc.Parse(_xmlString.c_str());
+  timer.Stop();
   if (xmlDoc.Error())
   {
     sdferr << "Error parsing XML from string: " << xmlDoc.ErrorStr() << '\n';
@@ -584,12 +921,19 @@ bool readDoc(tinyxml2::XMLDocument *_xmlDoc, SDFPtr _sdf,
         && strcmp(sdfNode->Attribute("version"), SDF::Version().c_str()) != 0)
     {
       sdfdbg << "Converting a deprecated source[" << _source << "].\n";
+      ScopedLoadTimer timer(LoadPhase::CONVERT, _source);
       Converter::Convert(_xmlDoc, SDF::Version());
     }
 
     // parse new sdf xml
+    ScopedLoadTimer timer(LoadPhase::READ_XML, _source);
     auto *elemXml = _xmlDoc->FirstChildElement(_sdf->Root()->GetName().c_str());
-    if (!readXml(elemXml, _sdf->Root(), _errors))
+    const bool readResult = readXml(elemXml, _sdf->Root(), _errors);
+    if (timer.Active())
+    {
+      timer.SetCount(countElements(_sdf->Root()));
+    }
+    if (!readResult)
     {
       _errors.push_back({ErrorCode::ELEMENT_INVALID,
           "Error reading element <" + _sdf->Root()->GetName() + ">"});
@@ -646,6 +990,7 @@ bool readDoc(tinyxml2::XMLDocument *_xmlDoc, ElementPtr _sdf,
         && strcmp(sdfNode->Attribute("version"), SDF::Version().c_str()) != 0)
     {
       sdfwarn << "Converting a deprecated SDF source[" << _source << "].\n";
+      ScopedLoadTimer timer(LoadPhase::CONVERT, _source);
       Converter::Convert(_xmlDoc, SDF::Version());
     }
 
@@ -657,7 +1002,13 @@ bool readDoc(tinyxml2::XMLDocument *_xmlDoc, ElementPtr _sdf,
     }
 
     // parse new sdf xml
-    if (!readXml(elemXml, _sdf, _errors))
+    ScopedLoadTimer timer(LoadPhase::READ_XML, _source);
+    const bool readResult = readXml(elemXml, _sdf, _errors);
+    if (timer.Active())
+    {
+      timer.SetCount(countElements(_sdf));
+    }
+    if (!readResult)
     {
       _errors.push_back({ErrorCode::ELEMENT_INVALID,
           "Unable to parse sdf element["+ _sdf->GetName() + "]"});
@@ -797,31 +1148,196 @@ std::string getModelFilePath(const std::string &_modelDirPath)
 }
 
 //////////////////////////////////////////////////
-bool readXml(tinyxml2::XMLElement *_xml, ElementPtr _sdf, Errors &_errors)
+/// \brief Result of loading the file referenced by an <include> element.
+struct IncludeLoadResult
 {
-  // Check if the element pointer is deprecated.
-  if (_sdf->GetRequired() == "-1")
-  {
-    sdfwarn << "SDF Element[" + _sdf->GetName() + "] is deprecated\n";
-  }
+  /// \brief The loaded file, or null if it couldn't be loaded.
+  SDFPtr sdf;
 
-  if (!_xml)
+  /// \brief Errors found while loading the file.
+  Errors errors;
+
+  /// \brief True if the errors should stop parsing of the parent element.
+  bool fatal = false;
+};
+
+//////////////////////////////////////////////////
+/// \brief Find and read the file referenced by an <include> element.
+/// This doesn't modify any shared state, so several includes can be loaded
+/// at once.
+/// \param[in] _includeXml The <include> element.
+/// \return The loaded file and the errors found.
+static IncludeLoadResult loadInclude(tinyxml2::XMLElement *_includeXml)
+{
+  const tinyxml2::XMLElement *uriXml = _includeXml->FirstChildElement("uri");
+  ScopedLoadTimer timer(LoadPhase::INCLUDE,
+      uriXml && uriXml->GetText() ? uriXml->GetText() : "");
+
+  IncludeLoadResult result;
+  std::string filename;
+  std::string modelPath;
+
+  if (_includeXml->FirstChildElement("uri"))
   {
-    if (_sdf->GetRequired() == "1" || _sdf->GetRequired() =="+")
+    std::string uri = _includeXml->FirstChildElement("uri")->GetText();
+    modelPath = sdf::findFile(uri, true, true);
+
+    // Test the model path
+    if (modelPath.empty())
     {
-      _errors.push_back({ErrorCode::ELEMENT_MISSING,
-          "SDF Element<" + _sdf->GetName() + "> is missing"});
-      return false;
+      result.errors.push_back({ErrorCode::URI_LOOKUP,
+          "Unable to find uri[" + uri + "]"});
+
+      size_t modelFound = uri.find("model://");
+      if (modelFound != 0u)
+      {
+        result.errors.push_back({ErrorCode::URI_INVALID,
+            "Invalid uri[" + uri + "]. Should be model://" + uri});
+      }
+      return result;
     }
     else
     {
-      return true;
+      if (!sdf::filesystem::is_directory(modelPath))
+      {
+        result.errors.push_back({ErrorCode::DIRECTORY_NONEXISTANT,
+            "Directory doesn't exist[" + modelPath + "]"});
+        return result;
+      }
+    }
+  }
+  else
+  {
+    result.errors.push_back({ErrorCode::ATTRIBUTE_MISSING,
+        "<include> element missing 'uri' attribute"});
+    return result;
+  }
+
+  // Includes nested in the included file are loaded on this thread
+  LoadingIncludesGuard loadingIncludes;
+
+  // sdf::init copies the cached spec description, so this is cheap.
+  SDFPtr includeSDF(new SDF);
+  init(includeSDF);
+
+  // Reuse the file if it has been loaded before and hasn't changed
+  IncludeCache &cache = IncludeCache::Instance();
+  const bool cacheEnabled = cache.MaxSize() > 0;
+  ElementPtr cachedRoot =
+    cacheEnabled ? cache.Find(modelPath, filename) : nullptr;
+  if (cachedRoot)
+  {
+    includeSDF->Root(cachedRoot);
+    includeSDF->SetFilePath(filename);
+    includeSDF->SetOriginalVersion(cachedRoot->OriginalVersion());
+    result.sdf = includeSDF;
+    return result;
+  }
+
+  // Record the files the result depends on. Their stamps are taken before
+  // they are read, so that a change while reading invalidates the entry.
+  IncludeCache::DependencyScope dependencies;
+  if (cacheEnabled)
+  {
+    IncludeCache::AddDependencies({
+        FileStamp::Of(sdf::filesystem::append(modelPath, "model.config")),
+        FileStamp::Of(sdf::filesystem::append(modelPath, "manifest.xml"))});
+  }
+
+  // Get the config.xml filename
+  filename = getModelFilePath(modelPath);
+  if (cacheEnabled)
+  {
+    IncludeCache::AddDependencies({FileStamp::Of(filename)});
+  }
+
+  Errors readErrors;
+  bool readResult = readFile(filename, includeSDF, readErrors);
+
+  // Output errors
+  for (auto const &e : readErrors)
+    std::cerr << e << std::endl;
+
+  if (!readResult)
+  {
+    result.errors.push_back({ErrorCode::FILE_READ,
+        "Unable to read file[" + filename + "]"});
+    result.fatal = true;
+    return result;
+  }
+
+  // Files read with errors aren't cached, so the errors are reported again
+  // the next time they are included.
+  if (cacheEnabled && readErrors.empty())
+  {
+    cache.Insert(modelPath, filename, includeSDF->Root(),
+        dependencies.Files());
+  }
+
+  result.sdf = includeSDF;
+  return result;
+}
+
+//////////////////////////////////////////////////
+/// \brief Load the files of all the <include> children of an element on
+/// a pool of threads.
+/// \param[in] _xml The parent element.
+/// \param[in] _threadCount Maximum number of threads to use.
+/// \return The results in document order.
+static std::vector<IncludeLoadResult> loadIncludes(
+    tinyxml2::XMLElement *_xml, unsigned int _threadCount)
+{
+  std::vector<tinyxml2::XMLElement *> includes;
+  for (auto *elemXml = _xml->FirstChildElement("include"); elemXml;
+       elemXml = elemXml->NextSiblingElement("include"))
+  {
+    includes.push_back(elemXml);
+  }
+
+  std::vector<IncludeLoadResult> results(includes.size());
+  std::atomic<std::size_t> next{0};
+  auto worker = [&]()
+  {
+    for (std::size_t i = next++; i < includes.size(); i = next++)
+    {
+      results[i] = loadInclude(includes[i]);
     }
+  };
+
+  std::vector<std::thread> threads;
+  const std::size_t threadCount =
+      std::min<std::size_t>(_threadCount, includes.size());
+  for (std::size_t i = 1; i < threadCount; ++i)
+  {
+    threads.emplace_back(worker);
+  }
+  worker();
+
+  for (auto &thread : threads)
+  {
+    thread.join();
   }
+  return results;
+}
 
-  if (_xml->GetText() != nullptr && _sdf->GetValue())
+/// \brief Names and values of the attributes of an XML element.
+using XmlAttributes = std::vector<std::pair<const char *, const char *>>;
+
+//////////////////////////////////////////////////
+/// \brief Set the value and the attributes of an SDF element from an XML
+/// element, and check that the required attributes are set.
+/// \param[in] _xmlName Name of the XML element.
+/// \param[in] _text Text of the XML element, or nullptr if it has none.
+/// \param[in] _attributes Names and values of the XML attributes.
+/// \param[in,out] _sdf SDF element to parse data into.
+/// \param[out] _errors Captures errors found during parsing.
+/// \return True on success, false on error.
+static bool readElementHead(const char *_xmlName, const char *_text,
+    const XmlAttributes &_attributes, ElementPtr _sdf, Errors &_errors)
+{
+  if (_text != nullptr && _sdf->GetValue())
   {
-    if (!_sdf->GetValue()->SetFromString(_xml->GetText()))
+    if (!_sdf->GetValue()->SetFromString(_text))
       return false;
   }
 
@@ -837,31 +1353,27 @@ bool readXml(tinyxml2::XMLElement *_xml, ElementPtr _sdf, Errors &_errors)
     _sdf->Copy(refSDF);
   }
 
-  const tinyxml2::XMLAttribute *attribute = _xml->FirstAttribute();
-
   unsigned int i = 0;
 
   // Iterate over all the attributes defined in the give XML element
-  while (attribute)
+  for (const auto &attribute : _attributes)
   {
     // Avoid printing a warning message for missing attributes if a namespaced
     // attribute is found
-    if (std::strchr(attribute->Name(), ':') != NULL)
+    if (std::strchr(attribute.first, ':') != NULL)
     {
-      _sdf->AddAttribute(attribute->Name(), "string", "", 1, "");
-      _sdf->GetAttribute(attribute->Name())->SetFromString(
-          attribute->Value());
-      attribute = attribute->Next();
+      _sdf->AddAttribute(attribute.first, "string", "", 1, "");
+      _sdf->GetAttribute(attribute.first)->SetFromString(attribute.second);
       continue;
     }
     // Find the matching attribute in SDF
     for (i = 0; i < _sdf->GetAttributeCount(); ++i)
     {
       ParamPtr p = _sdf->GetAttribute(i);
-      if (p->GetKey() == attribute->Name())
+      if (p->GetKey() == attribute.first)
       {
         // Set the value of the SDF attribute
-        if (!p->SetFromString(attribute->Value()))
+        if (!p->SetFromString(attribute.second))
         {
           _errors.push_back({ErrorCode::ATTRIBUTE_INVALID,
               "Unable to read attribute[" + p->GetKey() + "]"});
@@ -873,12 +1385,10 @@ bool readXml(tinyxml2::XMLElement *_xml, ElementPtr _sdf, Errors &_errors)
 
     if (i == _sdf->GetAttributeCount())
     {
-      sdfwarn << "XML Attribute[" << attribute->Name()
-              << "] in element[" << _xml->Value()
+      sdfwarn << "XML Attribute[" << attribute.first
+              << "] in element[" << _xmlName
               << "] not defined in SDF, ignoring.\n";
     }
-
-    attribute = attribute->Next();
   }
 
   // Check that all required attributes have been set
@@ -888,229 +1398,274 @@ bool readXml(tinyxml2::XMLElement *_xml, ElementPtr _sdf, Errors &_errors)
     if (p->GetRequired() && !p->GetSet())
     {
       _errors.push_back({ErrorCode::ATTRIBUTE_MISSING,
-          "Required attribute[" + p->GetKey() + "] in element[" + _xml->Value()
+          "Required attribute[" + p->GetKey() + "] in element[" + _xmlName
           + "] is not specified in SDF."});
       return false;
     }
   }
 
-  if (_sdf->GetCopyChildren())
-  {
-    copyChildren(_sdf, _xml, false);
-  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Merge the file loaded for an <include> element into its parent.
+/// \param[in] _includeXml The <include> element.
+/// \param[in] _includeSDF The loaded file.
+/// \param[in,out] _sdf The parent of the <include> element.
+/// \param[out] _errors Captures errors found during parsing.
+/// \return False on an error that stops the parsing of the parent.
+static bool mergeInclude(tinyxml2::XMLElement *_includeXml,
+    SDFPtr _includeSDF, ElementPtr _sdf, Errors &_errors)
+{
+  sdf::ElementPtr topLevelElem;
+  bool isModel{false};
+  bool isActor{false};
+  if (_includeSDF->Root()->HasElement("model"))
+  {
+    topLevelElem = _includeSDF->Root()->GetElement("model");
+    isModel = true;
+  }
+  else if (_includeSDF->Root()->HasElement("actor"))
+  {
+    topLevelElem = _includeSDF->Root()->GetElement("actor");
+    isActor = true;
+  }
+  else if (_includeSDF->Root()->HasElement("light"))
+  {
+    topLevelElem = _includeSDF->Root()->GetElement("light");
+  }
   else
   {
-    std::string filename;
+    _errors.push_back({ErrorCode::ELEMENT_MISSING,
+        "Failed to find top level <model> / <actor> / <light> for "
+        "<include>\n"});
+    return true;
+  }
 
-    // Iterate over all the child elements
-    tinyxml2::XMLElement *elemXml = nullptr;
-    for (elemXml = _xml->FirstChildElement(); elemXml;
-         elemXml = elemXml->NextSiblingElement())
+  if (_includeXml->FirstChildElement("name"))
+  {
+    topLevelElem->GetAttribute("name")->SetFromString(
+          _includeXml->FirstChildElement("name")->GetText());
+  }
+
+  tinyxml2::XMLElement *poseElemXml = _includeXml->FirstChildElement("pose");
+  if (poseElemXml)
+  {
+    sdf::ElementPtr poseElem = topLevelElem->GetElement("pose");
+
+    if (poseElemXml->GetText())
     {
-      if (std::string("include") == elemXml->Value())
-      {
-        std::string modelPath;
+      poseElem->GetValue()->SetFromString(poseElemXml->GetText());
+    }
+    else
+    {
+      poseElem->GetValue()->Reset();
+    }
 
-        if (elemXml->FirstChildElement("uri"))
-        {
-          std::string uri = elemXml->FirstChildElement("uri")->GetText();
-          modelPath = sdf::findFile(uri, true, true);
-
-          // Test the model path
-          if (modelPath.empty())
-          {
-            _errors.push_back({ErrorCode::URI_LOOKUP,
-                "Unable to find uri[" + uri + "]"});
-
-            size_t modelFound = uri.find("model://");
-            if (modelFound != 0u)
-            {
-              _errors.push_back({ErrorCode::URI_INVALID,
-                  "Invalid uri[" + uri + "]. Should be model://" + uri});
-            }
-            continue;
-          }
-          else
-          {
-            if (!sdf::filesystem::is_directory(modelPath))
-            {
-              _errors.push_back({ErrorCode::DIRECTORY_NONEXISTANT,
-                  "Directory doesn't exist[" + modelPath + "]"});
-              continue;
-            }
-          }
-
-          // Get the config.xml filename
-          filename = getModelFilePath(modelPath);
-        }
-        else
-        {
-          _errors.push_back({ErrorCode::ATTRIBUTE_MISSING,
-              "<include> element missing 'uri' attribute"});
-          continue;
-        }
+    const char *relativeTo = poseElemXml->Attribute("relative_to");
+    if (relativeTo)
+    {
+      poseElem->GetAttribute("relative_to")->SetFromString(relativeTo);
+    }
+    else
+    {
+      poseElem->GetAttribute("relative_to")->Reset();
+    }
+  }
 
-        // NOTE: sdf::init is an expensive call. For performance reason,
-        // a new sdf pointer is created here by cloning a fresh sdf template
-        // pointer instead of calling init every iteration.
-        // SDFPtr includeSDF(new SDF);
-        // init(includeSDF);
-        static SDFPtr includeSDFTemplate;
-        if (!includeSDFTemplate)
-        {
-          includeSDFTemplate.reset(new SDF);
-          init(includeSDFTemplate);
-        }
-        SDFPtr includeSDF(new SDF);
-        includeSDF->Root(includeSDFTemplate->Root()->Clone());
+  if (isModel && _includeXml->FirstChildElement("static"))
+  {
+    topLevelElem->GetElement("static")->GetValue()->SetFromString(
+          _includeXml->FirstChildElement("static")->GetText());
+  }
+
+  if (isModel && _includeXml->FirstChildElement("placement_frame"))
+  {
+    if (nullptr == _includeXml->FirstChildElement("pose"))
+    {
+      _errors.push_back({ErrorCode::MODEL_PLACEMENT_FRAME_INVALID,
+          "<pose> is required when specifying the placement_frame "
+          "element"});
+      return false;
+    }
+    topLevelElem->GetAttribute("placement_frame")->SetFromString(
+          _includeXml->FirstChildElement("placement_frame")->GetText());
+  }
 
-        if (!readFile(filename, includeSDF))
+  if (isModel || isActor)
+  {
+    for (auto *childElemXml = _includeXml->FirstChildElement();
+         childElemXml; childElemXml = childElemXml->NextSiblingElement())
+    {
+      if (std::string("plugin") == childElemXml->Value())
+      {
+        sdf::ElementPtr pluginElem;
+        pluginElem = topLevelElem->AddElement("plugin");
+
+        if (!readXml(childElemXml, pluginElem, _errors))
         {
-          _errors.push_back({ErrorCode::FILE_READ,
-              "Unable to read file[" + filename + "]"});
+          _errors.push_back({ErrorCode::ELEMENT_INVALID,
+                             "Error reading plugin element"});
           return false;
         }
+      }
+    }
+  }
 
-        sdf::ElementPtr topLevelElem;
-        bool isModel{false};
-        bool isActor{false};
-        if (includeSDF->Root()->HasElement("model"))
-        {
-          topLevelElem = includeSDF->Root()->GetElement("model");
-          isModel = true;
-        }
-        else if (includeSDF->Root()->HasElement("actor"))
-        {
-          topLevelElem = includeSDF->Root()->GetElement("actor");
-          isActor = true;
-        }
-        else if (includeSDF->Root()->HasElement("light"))
+  if (_sdf->GetName() == "model")
+  {
+    addNestedModel(_sdf, _includeSDF->Root(), _errors);
+  }
+  else
+  {
+    _includeSDF->Root()->GetFirstElement()->SetParent(_sdf);
+    _sdf->InsertElement(_includeSDF->Root()->GetFirstElement());
+    // TODO: This was used to store the included filename so that when
+    // a world is saved, the included model's SDF is not stored in the
+    // world file. This highlights the need to make model inclusion
+    // a core feature of SDF, and not a hack that that parser handles
+    // _includeSDF->Root()->GetFirstElement()->SetInclude(
+    // _includeXml->Attribute("filename"));
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that an SDF element has all of its required children, and
+/// add the ones that have a default value.
+/// \param[in,out] _sdf The SDF element.
+/// \param[out] _errors Captures errors found during parsing.
+/// \return False if a required element is missing.
+static bool checkRequiredElements(ElementPtr _sdf, Errors &_errors)
+{
+  // Check that all required elements have been set
+  for (unsigned int descCounter = 0;
+       descCounter != _sdf->GetElementDescriptionCount(); ++descCounter)
+  {
+    ElementPtr elemDesc = _sdf->GetElementDescription(descCounter);
+
+    if (elemDesc->GetRequired() == "1" || elemDesc->GetRequired() == "+")
+    {
+      if (!_sdf->HasElement(elemDesc->GetName()))
+      {
+        if (_sdf->GetName() == "joint" &&
+            _sdf->Get<std::string>("type") != "ball")
         {
-          topLevelElem = includeSDF->Root()->GetElement("light");
+          _errors.push_back({ErrorCode::ELEMENT_MISSING,
+              "XML Missing required element[" + elemDesc->GetName() +
+              "], child of element[" + _sdf->GetName() + "]"});
+          return false;
         }
         else
         {
-          _errors.push_back({ErrorCode::ELEMENT_MISSING,
-              "Failed to find top level <model> / <actor> / <light> for "
-              "<include>\n"});
-          continue;
+          // Add default element
+          _sdf->AddElement(elemDesc->GetName());
         }
+      }
+    }
+  }
 
-        if (elemXml->FirstChildElement("name"))
-        {
-          topLevelElem->GetAttribute("name")->SetFromString(
-                elemXml->FirstChildElement("name")->GetText());
-        }
+  return true;
+}
 
-        tinyxml2::XMLElement *poseElemXml = elemXml->FirstChildElement("pose");
-        if (poseElemXml)
-        {
-          sdf::ElementPtr poseElem = topLevelElem->GetElement("pose");
-
-          if (poseElemXml->GetText())
-          {
-            poseElem->GetValue()->SetFromString(poseElemXml->GetText());
-          }
-          else
-          {
-            poseElem->GetValue()->Reset();
-          }
-
-          const char *relativeTo = poseElemXml->Attribute("relative_to");
-          if (relativeTo)
-          {
-            poseElem->GetAttribute("relative_to")->SetFromString(relativeTo);
-          }
-          else
-          {
-            poseElem->GetAttribute("relative_to")->Reset();
-          }
-        }
+//////////////////////////////////////////////////
+bool readXml(tinyxml2::XMLElement *_xml, ElementPtr _sdf, Errors &_errors)
+{
+  // Check if the element pointer is deprecated.
+  if (_sdf->GetRequired() == "-1")
+  {
+    sdfwarn << "SDF Element[" + _sdf->GetName() + "] is deprecated\n";
+  }
 
-        if (isModel && elemXml->FirstChildElement("static"))
-        {
-          topLevelElem->GetElement("static")->GetValue()->SetFromString(
-                elemXml->FirstChildElement("static")->GetText());
-        }
+  if (!_xml)
+  {
+    if (_sdf->GetRequired() == "1" || _sdf->GetRequired() =="+")
+    {
+      _errors.push_back({ErrorCode::ELEMENT_MISSING,
+          "SDF Element<" + _sdf->GetName() + "> is missing"});
+      return false;
+    }
+    else
+    {
+      return true;
+    }
+  }
 
-        if (isModel && elemXml->FirstChildElement("placement_frame"))
-        {
-          if (nullptr == elemXml->FirstChildElement("pose"))
-          {
-            _errors.push_back({ErrorCode::MODEL_PLACEMENT_FRAME_INVALID,
-                "<pose> is required when specifying the placement_frame "
-                "element"});
-            return false;
-          }
-          topLevelElem->GetAttribute("placement_frame")->SetFromString(
-                elemXml->FirstChildElement("placement_frame")->GetText());
-        }
+  XmlAttributes attributes;
+  for (const auto *attribute = _xml->FirstAttribute(); attribute;
+       attribute = attribute->Next())
+  {
+    attributes.emplace_back(attribute->Name(), attribute->Value());
+  }
 
-        if (isModel || isActor)
-        {
-          for (auto *childElemXml = elemXml->FirstChildElement();
-               childElemXml; childElemXml = childElemXml->NextSiblingElement())
-          {
-            if (std::string("plugin") == childElemXml->Value())
-            {
-              sdf::ElementPtr pluginElem;
-              pluginElem = topLevelElem->AddElement("plugin");
-
-              if (!readXml(childElemXml, pluginElem, _errors))
-              {
-                _errors.push_back({ErrorCode::ELEMENT_INVALID,
-                                   "Error reading plugin element"});
-                return false;
-              }
-            }
-          }
-        }
+  if (!readElementHead(_xml->Value(), _xml->GetText(), attributes, _sdf,
+      _errors))
+  {
+    return false;
+  }
+
+  if (_sdf->GetCopyChildren())
+  {
+    copyChildren(_sdf, _xml, false);
+  }
+  else
+  {
+    // Load the files of all includes at once when there are several, and
+    // merge them below in document order.
+    std::vector<IncludeLoadResult> loadedIncludes;
+    std::size_t includeIndex = 0;
+    const unsigned int threadCount = g_includeThreadCount;
+    if (threadCount > 1 && !t_loadingIncludes)
+    {
+      auto *firstInclude = _xml->FirstChildElement("include");
+      if (firstInclude && firstInclude->NextSiblingElement("include"))
+      {
+        loadedIncludes = loadIncludes(_xml, threadCount);
+      }
+    }
 
-        if (_sdf->GetName() == "model")
+    // Iterate over all the child elements
+    tinyxml2::XMLElement *elemXml = nullptr;
+    for (elemXml = _xml->FirstChildElement(); elemXml;
+         elemXml = elemXml->NextSiblingElement())
+    {
+      if (std::string("include") == elemXml->Value())
+      {
+        IncludeLoadResult loaded = loadedIncludes.empty() ?
+            loadInclude(elemXml) : std::move(loadedIncludes[includeIndex++]);
+        _errors.insert(_errors.end(), loaded.errors.begin(),
+            loaded.errors.end());
+        if (loaded.fatal)
         {
-          addNestedModel(_sdf, includeSDF->Root(), _errors);
+          return false;
         }
-        else
+        if (loaded.sdf && !mergeInclude(elemXml, loaded.sdf, _sdf, _errors))
         {
-          includeSDF->Root()->GetFirstElement()->SetParent(_sdf);
-          _sdf->InsertElement(includeSDF->Root()->GetFirstElement());
-          // TODO: This was used to store the included filename so that when
-          // a world is saved, the included model's SDF is not stored in the
-          // world file. This highlights the need to make model inclusion
-          // a core feature of SDF, and not a hack that that parser handles
-          // includeSDF->Root()->GetFirstElement()->SetInclude(
-          // elemXml->Attribute("filename"));
+          return false;
         }
-
         continue;
       }
 
       // Find the matching element in SDF
-      unsigned int descCounter = 0;
-      for (descCounter = 0;
-           descCounter != _sdf->GetElementDescriptionCount(); ++descCounter)
+      ElementPtr elemDesc = _sdf->GetElementDescription(elemXml->Value());
+      if (elemDesc)
       {
-        ElementPtr elemDesc = _sdf->GetElementDescription(descCounter);
-        if (elemDesc->GetName() == elemXml->Value())
+        ElementPtr element = elemDesc->Clone();
+        element->SetParent(_sdf);
+        if (readXml(elemXml, element, _errors))
+        {
+          _sdf->InsertElement(element);
+        }
+        else
         {
-          ElementPtr element = elemDesc->Clone();
-          element->SetParent(_sdf);
-          if (readXml(elemXml, element, _errors))
-          {
-            _sdf->InsertElement(element);
-          }
-          else
-          {
-            _errors.push_back({ErrorCode::ELEMENT_INVALID,
-                std::string("Error reading element <") +
-                elemXml->Value() + ">"});
-            return false;
-          }
-          break;
+          _errors.push_back({ErrorCode::ELEMENT_INVALID,
+              std::string("Error reading element <") +
+              elemXml->Value() + ">"});
+          return false;
         }
       }
-
-      if (descCounter == _sdf->GetElementDescriptionCount())
+      else
       {
         sdfdbg << "XML Element[" << elemXml->Value()
                << "], child of element[" << _xml->Value()
@@ -1123,35 +1678,333 @@ bool readXml(tinyxml2::XMLElement *_xml, ElementPtr _sdf, Errors &_errors)
     // Copy unknown elements outside the loop so it only happens one time
     copyChildren(_sdf, _xml, true);
 
-    // Check that all required elements have been set
-    for (unsigned int descCounter = 0;
-         descCounter != _sdf->GetElementDescriptionCount(); ++descCounter)
+    return checkRequiredElements(_sdf, _errors);
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Create an XML element from the start tag a reader is on.
+/// \param[in] _reader The reader.
+/// \param[in] _doc Document that owns the element.
+/// \return The element.
+static tinyxml2::XMLElement *newXmlElement(const XmlStreamReader &_reader,
+    tinyxml2::XMLDocument &_doc)
+{
+  tinyxml2::XMLElement *xml = _doc.NewElement(_reader.Name().c_str());
+  for (const auto &attribute : _reader.Attributes())
+  {
+    xml->SetAttribute(attribute.first.c_str(), attribute.second.c_str());
+  }
+  return xml;
+}
+
+//////////////////////////////////////////////////
+/// \brief Copy the rest of the current element of a reader into an XML
+/// element, up to and including its end tag.
+/// \param[in] _reader The reader.
+/// \param[in] _token The token the reader is on.
+/// \param[in] _doc Document that owns the XML element.
+/// \param[in] _xml XML element the children are added to.
+/// \return False if the reader failed.
+static bool readXmlChildren(XmlStreamReader &_reader,
+    XmlStreamReader::Token _token, tinyxml2::XMLDocument &_doc,
+    tinyxml2::XMLElement *_xml)
+{
+  for (;; _token = _reader.Next())
+  {
+    switch (_token)
+    {
+      case XmlStreamReader::Token::START_ELEMENT:
+      {
+        tinyxml2::XMLElement *child = newXmlElement(_reader, _doc);
+        _xml->InsertEndChild(child);
+        if (!readXmlChildren(_reader, _reader.Next(), _doc, child))
+        {
+          return false;
+        }
+        break;
+      }
+      case XmlStreamReader::Token::TEXT:
+      {
+        tinyxml2::XMLText *text = _doc.NewText(_reader.Text().c_str());
+        text->SetCData(_reader.IsCData());
+        _xml->InsertEndChild(text);
+        break;
+      }
+      case XmlStreamReader::Token::OTHER:
+        // Only kept so that a comment before the text of an element hides
+        // the text, as it does when the whole document is parsed.
+        _xml->InsertEndChild(_doc.NewComment(""));
+        break;
+      case XmlStreamReader::Token::END_ELEMENT:
+        return true;
+      default:
+        return false;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+bool readXmlStream(XmlStreamReader &_reader, ElementPtr _sdf,
+    Errors &_errors)
+{
+  // Check if the element pointer is deprecated.
+  if (_sdf->GetRequired() == "-1")
+  {
+    sdfwarn << "SDF Element[" + _sdf->GetName() + "] is deprecated\n";
+  }
+
+  // The reader only holds the current token, so keep the start tag
+  const std::string xmlName = _reader.Name();
+  const std::vector<std::pair<std::string, std::string>> xmlAttributes =
+      _reader.Attributes();
+
+  // The text of an element is its first child
+  XmlStreamReader::Token token = _reader.Next();
+  const bool hasText = token == XmlStreamReader::Token::TEXT;
+  const std::string text = hasText ? _reader.Text() : std::string();
+
+  XmlAttributes attributes;
+  for (const auto &attribute : xmlAttributes)
+  {
+    attributes.emplace_back(attribute.first.c_str(),
+        attribute.second.c_str());
+  }
+
+  if (!readElementHead(xmlName.c_str(), hasText ? text.c_str() : nullptr,
+      attributes, _sdf, _errors))
+  {
+    return false;
+  }
+
+  // Elements that aren't parsed directly are read into a small document.
+  // This includes the contents of elements whose children are copied,
+  // <include> elements and elements that aren't in the spec.
+  tinyxml2::XMLDocument xmlDoc;
+  auto newParentXml = [&]()
+  {
+    tinyxml2::XMLElement *xml = xmlDoc.NewElement(xmlName.c_str());
+    for (const auto &attribute : xmlAttributes)
+    {
+      xml->SetAttribute(attribute.first.c_str(), attribute.second.c_str());
+    }
+    xmlDoc.InsertEndChild(xml);
+    return xml;
+  };
+
+  if (_sdf->GetCopyChildren())
+  {
+    tinyxml2::XMLElement *xml = newParentXml();
+    if (!readXmlChildren(_reader, token, xmlDoc, xml))
     {
-      ElementPtr elemDesc = _sdf->GetElementDescription(descCounter);
+      return false;
+    }
+    copyChildren(_sdf, xml, false);
+    return true;
+  }
+
+  // Parent of the children that aren't in the spec
+  tinyxml2::XMLElement *unknownXml = nullptr;
 
-      if (elemDesc->GetRequired() == "1" || elemDesc->GetRequired() == "+")
+  // Iterate over all the child elements
+  for (;; token = _reader.Next())
+  {
+    if (token == XmlStreamReader::Token::END_ELEMENT)
+    {
+      break;
+    }
+    else if (token == XmlStreamReader::Token::TEXT ||
+             token == XmlStreamReader::Token::OTHER)
+    {
+      continue;
+    }
+    else if (token != XmlStreamReader::Token::START_ELEMENT)
+    {
+      return false;
+    }
+
+    if (_reader.Name() == "include")
+    {
+      tinyxml2::XMLElement *includeXml = newXmlElement(_reader, xmlDoc);
+      xmlDoc.InsertEndChild(includeXml);
+      if (!readXmlChildren(_reader, _reader.Next(), xmlDoc, includeXml))
       {
-        if (!_sdf->HasElement(elemDesc->GetName()))
+        return false;
+      }
+
+      IncludeLoadResult loaded = loadInclude(includeXml);
+      _errors.insert(_errors.end(), loaded.errors.begin(),
+          loaded.errors.end());
+      if (loaded.fatal)
+      {
+        return false;
+      }
+      if (loaded.sdf && !mergeInclude(includeXml, loaded.sdf, _sdf, _errors))
+      {
+        return false;
+      }
+
+      // An <include> that isn't in the spec is also copied
+      if (!_sdf->HasElementDescription("include"))
+      {
+        if (!unknownXml)
         {
-          if (_sdf->GetName() == "joint" &&
-              _sdf->Get<std::string>("type") != "ball")
-          {
-            _errors.push_back({ErrorCode::ELEMENT_MISSING,
-                "XML Missing required element[" + elemDesc->GetName() +
-                "], child of element[" + _sdf->GetName() + "]"});
-            return false;
-          }
-          else
-          {
-            // Add default element
-            _sdf->AddElement(elemDesc->GetName());
-          }
+          unknownXml = newParentXml();
         }
+        unknownXml->InsertEndChild(includeXml);
+      }
+      continue;
+    }
+
+    // Find the matching element in SDF
+    ElementPtr elemDesc = _sdf->GetElementDescription(_reader.Name());
+    if (elemDesc)
+    {
+      ElementPtr element = elemDesc->Clone();
+      element->SetParent(_sdf);
+      if (readXmlStream(_reader, element, _errors))
+      {
+        _sdf->InsertElement(element);
+      }
+      else
+      {
+        _errors.push_back({ErrorCode::ELEMENT_INVALID,
+            "Error reading element <" + elemDesc->GetName() + ">"});
+        return false;
+      }
+    }
+    else
+    {
+      sdfdbg << "XML Element[" << _reader.Name()
+             << "], child of element[" << xmlName
+             << "], not defined in SDF. Copying[" << _reader.Name() << "] "
+             << "as children of [" << xmlName << "].\n";
+
+      if (!unknownXml)
+      {
+        unknownXml = newParentXml();
+      }
+      tinyxml2::XMLElement *xml = newXmlElement(_reader, xmlDoc);
+      unknownXml->InsertEndChild(xml);
+      if (!readXmlChildren(_reader, _reader.Next(), xmlDoc, xml))
+      {
+        return false;
       }
     }
   }
 
-  return true;
+  // Copy unknown elements outside the loop so it only happens one time
+  if (unknownXml)
+  {
+    copyChildren(_sdf, unknownXml, true);
+  }
+
+  return checkRequiredElements(_sdf, _errors);
+}
+
+//////////////////////////////////////////////////
+StreamReadResult readStream(XmlStreamReader &_reader, SDFPtr _sdf,
+    const std::string &_source, bool _convert, Errors &_errors)
+{
+  // Included files are merged as they are read, so all of them can't be
+  // loaded up front.
+  if (g_includeThreadCount > 1 && !t_loadingIncludes)
+  {
+    return StreamReadResult::UNSUPPORTED;
+  }
+
+  if (nullptr == _sdf || nullptr == _sdf->Root() ||
+      _sdf->Root()->GetName() != "sdf")
+  {
+    return StreamReadResult::UNSUPPORTED;
+  }
+
+  // Skip the prolog
+  XmlStreamReader::Token token = _reader.Next();
+  while (token == XmlStreamReader::Token::OTHER)
+  {
+    token = _reader.Next();
+  }
+  if (token == XmlStreamReader::Token::ERROR)
+  {
+    return _reader.Unsupported() ?
+        StreamReadResult::UNSUPPORTED : StreamReadResult::XML_ERROR;
+  }
+
+  // Anything else than an <sdf> root element with the current version is
+  // left to the DOM parser, which handles conversion and URDF files.
+  if (token != XmlStreamReader::Token::START_ELEMENT ||
+      _reader.Name() != "sdf")
+  {
+    return StreamReadResult::UNSUPPORTED;
+  }
+  const std::string *versionAttribute = nullptr;
+  for (const auto &attribute : _reader.Attributes())
+  {
+    if (attribute.first == "version")
+    {
+      versionAttribute = &attribute.second;
+    }
+  }
+  if (!versionAttribute ||
+      (_convert && SDF::Version() != *versionAttribute))
+  {
+    return StreamReadResult::UNSUPPORTED;
+  }
+  const std::string version = *versionAttribute;
+
+  // The document is read into a copy of the root element, which replaces
+  // the root of _sdf once the end of the document has been reached, so
+  // that _sdf is left unchanged if the document turns out to be invalid.
+  ElementPtr root = _sdf->Root()->Clone();
+  if (_source != "data-string")
+  {
+    root->SetFilePath(_source);
+  }
+  if (_sdf->OriginalVersion().empty() || root->OriginalVersion().empty())
+  {
+    root->SetOriginalVersion(version);
+  }
+
+  // Errors are discarded if the document turns out not to be well formed,
+  // since nothing is parsed from such a document by the DOM parser.
+  const std::size_t errorCount = _errors.size();
+  const bool result = readXmlStream(_reader, root, _errors);
+
+  // The rest of the document must also be well formed
+  while (token != XmlStreamReader::Token::END_DOCUMENT &&
+         token != XmlStreamReader::Token::ERROR)
+  {
+    token = _reader.Next();
+  }
+
+  // Constructs that the reader doesn't support are left to the DOM parser
+  if (!_reader.Error().empty())
+  {
+    _errors.resize(errorCount);
+    return _reader.Unsupported() ?
+        StreamReadResult::UNSUPPORTED : StreamReadResult::XML_ERROR;
+  }
+
+  if (!result)
+  {
+    _errors.push_back({ErrorCode::ELEMENT_INVALID,
+        "Error reading element <" + root->GetName() + ">"});
+    return StreamReadResult::FAILURE;
+  }
+
+  _sdf->Root(root);
+  if (_source != "data-string")
+  {
+    _sdf->SetFilePath(_source);
+  }
+  if (_sdf->OriginalVersion().empty())
+  {
+    _sdf->SetOriginalVersion(version);
+  }
+  return StreamReadResult::SUCCESS;
 }
 
 /////////////////////////////////////////////////
@@ -1705,163 +2558,41 @@ bool recursiveSiblingUniqueNames(sdf::ElementPtr _elem)
 //////////////////////////////////////////////////
 bool checkFrameAttachedToGraph(const sdf::Root *_root)
 {
-  bool result = true;
-
-  auto checkModelFrameAttachedToGraph = [](
-      const sdf::Model *_model) -> bool
-  {
-    bool modelResult = true;
-    sdf::FrameAttachedToGraph graph;
-    auto errors = sdf::buildFrameAttachedToGraph(graph, _model);
-    if (!errors.empty())
-    {
-      for (auto &error : errors)
-      {
-        std::cerr << "Error: " << error.Message() << std::endl;
-      }
-      modelResult = false;
-    }
-    errors = sdf::validateFrameAttachedToGraph(graph);
-    if (!errors.empty())
-    {
-      for (auto &error : errors)
-      {
-        std::cerr << "Error in validateFrameAttachedToGraph: "
-                  << error.Message()
-                  << std::endl;
-      }
-      modelResult = false;
-    }
-    return modelResult;
-  };
-
-  auto checkWorldFrameAttachedToGraph = [](
-      const sdf::World *_world) -> bool
+  // The graphs were already built and validated while loading the root
+  Errors buildErrors;
+  Errors validateErrors;
+  _root->FrameAttachedToGraphErrors(buildErrors, validateErrors);
+  for (auto &error : buildErrors)
   {
-    bool worldResult = true;
-    sdf::FrameAttachedToGraph graph;
-    auto errors = sdf::buildFrameAttachedToGraph(graph, _world);
-    if (!errors.empty())
-    {
-      for (auto &error : errors)
-      {
-        std::cerr << "Error: " << error.Message() << std::endl;
-      }
-      worldResult = false;
-    }
-    errors = sdf::validateFrameAttachedToGraph(graph);
-    if (!errors.empty())
-    {
-      for (auto &error : errors)
-      {
-        std::cerr << "Error in validateFrameAttachedToGraph: "
-                  << error.Message()
-                  << std::endl;
-      }
-      worldResult = false;
-    }
-    return worldResult;
-  };
-
-  for (uint64_t m = 0; m < _root->ModelCount(); ++m)
-  {
-    auto model = _root->ModelByIndex(m);
-    result = checkModelFrameAttachedToGraph(model) && result;
+    std::cerr << "Error: " << error.Message() << std::endl;
   }
-
-  for (uint64_t w = 0; w < _root->WorldCount(); ++w)
+  for (auto &error : validateErrors)
   {
-    auto world = _root->WorldByIndex(w);
-    result = checkWorldFrameAttachedToGraph(world) && result;
-    for (uint64_t m = 0; m < world->ModelCount(); ++m)
-    {
-      auto model = world->ModelByIndex(m);
-      result = checkModelFrameAttachedToGraph(model) && result;
-    }
+    std::cerr << "Error in validateFrameAttachedToGraph: "
+              << error.Message()
+              << std::endl;
   }
-
-  return result;
+  return buildErrors.empty() && validateErrors.empty();
 }
 
 //////////////////////////////////////////////////
 bool checkPoseRelativeToGraph(const sdf::Root *_root)
 {
-  bool result = true;
-
-  auto checkModelPoseRelativeToGraph = [](
-      const sdf::Model *_model) -> bool
-  {
-    bool modelResult = true;
-    sdf::PoseRelativeToGraph graph;
-    auto errors = sdf::buildPoseRelativeToGraph(graph, _model);
-    if (!errors.empty())
-    {
-      for (auto &error : errors)
-      {
-        std::cerr << "Error: " << error.Message() << std::endl;
-      }
-      modelResult = false;
-    }
-    errors = sdf::validatePoseRelativeToGraph(graph);
-    if (!errors.empty())
-    {
-      for (auto &error : errors)
-      {
-        std::cerr << "Error in validatePoseRelativeToGraph: "
-                  << error.Message()
-                  << std::endl;
-      }
-      modelResult = false;
-    }
-    return modelResult;
-  };
-
-  auto checkWorldPoseRelativeToGraph = [](
-      const sdf::World *_world) -> bool
-  {
-    bool worldResult = true;
-    sdf::PoseRelativeToGraph graph;
-    auto errors = sdf::buildPoseRelativeToGraph(graph, _world);
-    if (!errors.empty())
-    {
-      for (auto &error : errors)
-      {
-        std::cerr << "Error: " << error.Message() << std::endl;
-      }
-      worldResult = false;
-    }
-    errors = sdf::validatePoseRelativeToGraph(graph);
-    if (!errors.empty())
-    {
-      for (auto &error : errors)
-      {
-        std::cerr << "Error in validatePoseRelativeToGraph: "
-                  << error.Message()
-                  << std::endl;
-      }
-      worldResult = false;
-    }
-    return worldResult;
-  };
-
-  for (uint64_t m = 0; m < _root->ModelCount(); ++m)
+  // The graphs were already built and validated while loading the root
+  Errors buildErrors;
+  Errors validateErrors;
+  _root->PoseRelativeToGraphErrors(buildErrors, validateErrors);
+  for (auto &error : buildErrors)
   {
-    auto model = _root->ModelByIndex(m);
-    result = checkModelPoseRelativeToGraph(model) && result;
+    std::cerr << "Error: " << error.Message() << std::endl;
   }
-
-  for (uint64_t w = 0; w < _root->WorldCount(); ++w)
+  for (auto &error : validateErrors)
   {
-    auto world = _root->WorldByIndex(w);
-    result = checkWorldPoseRelativeToGraph(world) && result;
-    for (uint64_t m = 0; m < world->ModelCount(); ++m)
-    {
-      auto model = world->ModelByIndex(m);
-      result = checkModelPoseRelativeToGraph(model) && result;
-    }
+    std::cerr << "Error in validatePoseRelativeToGraph: "
+              << error.Message()
+              << std::endl;
   }
-
-  return result;
+  return buildErrors.empty() && validateErrors.empty();
 }
 
 //////////////////////////////////////////////////
@@ -83,6 +83,136 @@ TEST(Parser, ReusedSDFVersion)
   EXPECT_EQ("1.6", sdf->Root()->OriginalVersion());
 }
 
+/////////////////////////////////////////////////
+TEST(Parser, SchemaCache)
+{
+  EXPECT_TRUE(sdf::warmSchemaCache());
+
+  sdf::SDFPtr first(new sdf::SDF());
+  ASSERT_TRUE(sdf::init(first));
+  sdf::SDFPtr second(new sdf::SDF());
+  ASSERT_TRUE(sdf::init(second));
+
+  // Both SDF objects are initialized from the same cached description
+  EXPECT_EQ("sdf", first->Root()->GetName());
+  EXPECT_EQ(first->Root()->GetElementDescriptionCount(),
+            second->Root()->GetElementDescriptionCount());
+  EXPECT_TRUE(first->Root()->HasElementDescription("world"));
+  EXPECT_TRUE(first->Root()->HasElementDescription("model"));
+
+  // but they do not share values
+  first->Root()->GetAttribute("version")->Set<std::string>("1.0");
+  EXPECT_EQ("1.0", first->Root()->Get<std::string>("version"));
+  EXPECT_EQ(SDF_PROTOCOL_VERSION, second->Root()->Get<std::string>("version"));
+
+  const std::string sdfString =
+    "<sdf version='" SDF_PROTOCOL_VERSION "'>"
+    "  <model name='a'><link name='link'/></model>"
+    "</sdf>";
+  EXPECT_TRUE(sdf::readString(sdfString, second));
+  ASSERT_TRUE(second->Root()->HasElement("model"));
+  EXPECT_FALSE(first->Root()->HasElement("model"));
+
+  sdf::SDFPtr third(new sdf::SDF());
+  ASSERT_TRUE(sdf::init(third));
+  EXPECT_FALSE(third->Root()->HasElement("model"));
+  EXPECT_EQ(SDF_PROTOCOL_VERSION, third->Root()->Get<std::string>("version"));
+
+  // Spec files other than root.sdf are cached as well
+  sdf::ElementPtr link(new sdf::Element());
+  ASSERT_TRUE(sdf::initFile("link.sdf", link));
+  EXPECT_EQ("link", link->GetName());
+  EXPECT_TRUE(link->HasElementDescription("visual"));
+}
+
+/////////////////////////////////////////////////
+/// \brief Check that two element descriptions contain the same information
+/// \param[in] _expected Expected description
+/// \param[in] _actual Description to check
+void ExpectSameDescription(sdf::ElementPtr _expected, sdf::ElementPtr _actual)
+{
+  ASSERT_NE(nullptr, _expected);
+  ASSERT_NE(nullptr, _actual);
+  EXPECT_EQ(_expected->GetName(), _actual->GetName());
+  EXPECT_EQ(_expected->GetRequired(), _actual->GetRequired());
+  EXPECT_EQ(_expected->GetDescription(), _actual->GetDescription());
+  EXPECT_EQ(_expected->GetCopyChildren(), _actual->GetCopyChildren());
+  EXPECT_EQ(_expected->ReferenceSDF(), _actual->ReferenceSDF());
+
+  sdf::ParamPtr expectedValue = _expected->GetValue();
+  sdf::ParamPtr actualValue = _actual->GetValue();
+  ASSERT_EQ(nullptr == expectedValue, nullptr == actualValue)
+    << _expected->GetName();
+  if (expectedValue)
+  {
+    EXPECT_EQ(expectedValue->GetTypeName(), actualValue->GetTypeName());
+    EXPECT_EQ(expectedValue->GetDefaultAsString(),
+              actualValue->GetDefaultAsString());
+    EXPECT_EQ(expectedValue->GetMinValueAsString(),
+              actualValue->GetMinValueAsString());
+    EXPECT_EQ(expectedValue->GetMaxValueAsString(),
+              actualValue->GetMaxValueAsString());
+    EXPECT_EQ(expectedValue->GetRequired(), actualValue->GetRequired());
+    EXPECT_EQ(expectedValue->GetDescription(), actualValue->GetDescription());
+  }
+
+  ASSERT_EQ(_expected->GetAttributeCount(), _actual->GetAttributeCount())
+    << _expected->GetName();
+  for (unsigned int i = 0; i < _expected->GetAttributeCount(); ++i)
+  {
+    sdf::ParamPtr expectedAttr = _expected->GetAttribute(i);
+    sdf::ParamPtr actualAttr = _actual->GetAttribute(i);
+    EXPECT_EQ(expectedAttr->GetKey(), actualAttr->GetKey());
+    EXPECT_EQ(expectedAttr->GetTypeName(), actualAttr->GetTypeName());
+    EXPECT_EQ(expectedAttr->GetDefaultAsString(),
+              actualAttr->GetDefaultAsString());
+    EXPECT_EQ(expectedAttr->GetRequired(), actualAttr->GetRequired());
+    EXPECT_EQ(expectedAttr->GetDescription(), actualAttr->GetDescription());
+  }
+
+  ASSERT_EQ(_expected->GetElementDescriptionCount(),
+            _actual->GetElementDescriptionCount()) << _expected->GetName();
+  for (unsigned int i = 0; i < _expected->GetElementDescriptionCount(); ++i)
+  {
+    ExpectSameDescription(_expected->GetElementDescription(i),
+                          _actual->GetElementDescription(i));
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(Parser, GeneratedSchemaMatchesSpecFiles)
+{
+  const std::string specDir = sdf::filesystem::append(
+      PROJECT_SOURCE_PATH, "sdf", SDF_PROTOCOL_VERSION);
+
+  int specCount = 0;
+  sdf::filesystem::DirIter endIter;
+  for (sdf::filesystem::DirIter dirIter(specDir);
+       dirIter != endIter; ++dirIter)
+  {
+    const std::string filename = sdf::filesystem::basename(*dirIter);
+    if (filename.size() < 4 ||
+        filename.compare(filename.size() - 4, 4, ".sdf") != 0)
+    {
+      continue;
+    }
+    SCOPED_TRACE(filename);
+    ++specCount;
+
+    // Parse the spec file as XML
+    sdf::SDFPtr fromXml(new sdf::SDF());
+    ASSERT_TRUE(sdf::initString(
+          sdf::SDF::EmbeddedSpec(filename, false), fromXml));
+
+    // Build the description from the generated tables
+    sdf::ElementPtr fromTables(new sdf::Element());
+    ASSERT_TRUE(sdf::initFile(filename, fromTables));
+
+    ExpectSameDescription(fromXml->Root(), fromTables);
+  }
+  EXPECT_GT(specCount, 0);
+}
+
 /////////////////////////////////////////////////
 TEST(Parser, readFileConversions)
 {
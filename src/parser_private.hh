@@ -24,6 +24,7 @@
 #include "sdf/SDFImpl.hh"
 #include "sdf/sdf_config.h"
 #include "sdf/system_util.hh"
+#include "XmlStreamReader.hh"
 
 /// \ingroup sdf_parser
 /// \brief namespace for Simulation Description Format parser
@@ -87,6 +88,50 @@ namespace sdf
                       ElementPtr _sdf,
                       Errors &_errors);
 
+  /// \brief Result of reading a document with readStream.
+  enum class StreamReadResult
+  {
+    /// \brief The document was read.
+    SUCCESS,
+
+    /// \brief The document is well formed XML, but isn't valid SDFormat.
+    FAILURE,
+
+    /// \brief The document isn't well formed XML. Errors found while
+    /// reading it are discarded.
+    XML_ERROR,
+
+    /// \brief The document must be read with readDoc instead, because it
+    /// needs to be converted, it isn't an SDFormat document, or it has XML
+    /// constructs that XmlStreamReader doesn't support.
+    UNSUPPORTED
+  };
+
+  /// \brief Populate the SDF values from an XML document, without building
+  /// a TinyXML document. Elements are read from the stream and parsed as
+  /// they arrive, so only the SDF elements are held in memory.
+  /// \remark For internal use only. Do not use this function.
+  /// \param[in] _reader Reader of the document.
+  /// \param[in,out] _sdf SDF pointer to parse data into.
+  /// \param[in] _source Source of the document, used as its file path.
+  /// \param[in] _convert True if a document of an older version would be
+  /// converted.
+  /// \param[out] _errors Captures errors found during parsing.
+  /// \return The result. _sdf is only changed if it's SUCCESS.
+  static StreamReadResult readStream(XmlStreamReader &_reader, SDFPtr _sdf,
+      const std::string &_source, bool _convert, Errors &_errors);
+
+  /// \brief Populate an SDF Element from an XML element that is read from
+  /// a stream. This is the streaming counterpart of readXml.
+  /// \remark For internal use only. Do not use this function.
+  /// \param[in] _reader Reader positioned on the start tag of the element.
+  /// It is left after the end tag of the element on success.
+  /// \param[in,out] _sdf SDF pointer to parse data into.
+  /// \param[out] _errors Captures errors found during parsing.
+  /// \return True on success, false on error.
+  static bool readXmlStream(XmlStreamReader &_reader, ElementPtr _sdf,
+      Errors &_errors);
+
   /// \brief Copy child XML elements into the _sdf element.
   /// \param[in] _sdf Parent Element.
   /// \param[in] _xml Pointer to element from which child elements should be
@@ -16,12 +16,16 @@
  */
 
 #include <algorithm>
+#include <cctype>
 #include <fstream>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <set>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -29,6 +33,7 @@
 
 #include <urdf_model/model.h>
 #include <urdf_model/link.h>
+#include <urdf_model/utils.h>
 #include <urdf_parser/urdf_parser.h>
 
 #include "sdf/sdf.hh"
@@ -49,19 +54,75 @@ typedef std::shared_ptr<SDFExtension> SDFExtensionPtr;
 typedef std::map<std::string, std::vector<SDFExtensionPtr> >
   StringSDFExtensionPtrMap;
 
-/// create SDF geometry block based on URDF
-StringSDFExtensionPtrMap g_extensions;
-bool g_reduceFixedJoints;
-bool g_enforceLimits;
-std::string g_collisionExt = "_collision";
-std::string g_visualExt = "_visual";
-std::string g_lumpPrefix = "_fixed_joint_lump__";
-urdf::Pose g_initialRobotPose;
-bool g_initialRobotPoseValid = false;
-std::set<std::string> g_fixedJointsTransformedInRevoluteJoints;
-std::set<std::string> g_fixedJointsTransformedInFixedJoints;
+/// \brief Where fixed joint reduction lumps the elements of a link.
+struct LumpTarget
+{
+  /// \brief The closest ancestor of the link that isn't reduced.
+  urdf::LinkSharedPtr link;
+
+  /// \brief Pose of the reduced link in the frame of the target link.
+  urdf::Pose transform;
+};
+
+/// \brief Targets of the reduced links, by link.
+typedef std::unordered_map<const urdf::Link *, LumpTarget> LumpTargetMap;
+
+/// \brief Reduced links whose extensions are lumped together, by the
+/// reduced link closest to their target. Each list is in depth first order.
+typedef std::unordered_map<const urdf::Link *,
+                           std::vector<urdf::LinkSharedPtr>> LumpBranchMap;
+
+/// \brief An extension blob, with the extension that holds it.
+typedef std::pair<SDFExtensionPtr, std::vector<XMLDocumentPtr>::iterator>
+  SDFExtensionBlob;
+
+/// \brief Extension blobs that reference links, by link name.
+typedef std::unordered_map<std::string, std::vector<SDFExtensionBlob>>
+  SDFExtensionBlobMap;
+
 const int g_outputDecimalPrecision = 16;
 
+/// \brief Conversion state of a URDF2SDF instance. Each instance owns its
+/// state, so instances can convert on different threads at the same time.
+/// The helper functions of the conversion get it as their first argument.
+class URDF2SDFPrivate
+{
+  /// \brief SDF extensions read from the <gazebo> elements, by reference.
+  public: StringSDFExtensionPtrMap extensions;
+
+  /// \brief True to lump links attached by fixed joints into their parent.
+  public: bool reduceFixedJoints = true;
+
+  /// \brief True to enforce the joint limits.
+  public: bool enforceLimits = true;
+
+  /// \brief Suffix of the names of collisions.
+  public: std::string collisionExt = "_collision";
+
+  /// \brief Suffix of the names of visuals.
+  public: std::string visualExt = "_visual";
+
+  /// \brief Prefix of the names of lumped collisions and visuals.
+  public: std::string lumpPrefix = "_fixed_joint_lump__";
+
+  /// \brief Pose of the robot, from its <origin> element.
+  public: urdf::Pose initialRobotPose;
+
+  /// \brief True if the robot has an <origin> element.
+  public: bool initialRobotPoseValid = false;
+
+  /// \brief Fixed joints that are converted to revolute joints.
+  public: std::set<std::string> fixedJointsTransformedInRevoluteJoints;
+
+  /// \brief Fixed joints that are preserved.
+  public: std::set<std::string> fixedJointsTransformedInFixedJoints;
+};
+
+/// \brief Parse a double independently of the C locale, which may use a
+/// decimal comma.
+/// \param[in] _str String that starts with a number.
+/// \return The parsed number.
+double StrToDouble(const std::string &_str);
 
 /// \brief parser xml string into urdf::Vector3
 /// \param[in] _key XML key where vector3 value might be
@@ -71,25 +132,30 @@ urdf::Vector3 ParseVector3(tinyxml2::XMLNode *_key, double _scale = 1.0);
 urdf::Vector3 ParseVector3(const std::string &_str, double _scale = 1.0);
 
 /// insert extensions into collision geoms
-void InsertSDFExtensionCollision(tinyxml2::XMLElement *_elem,
+void InsertSDFExtensionCollision(URDF2SDFPrivate &_conversion,
+                                 tinyxml2::XMLElement *_elem,
                                  const std::string &_linkName);
 
 /// insert extensions into model
-void InsertSDFExtensionRobot(tinyxml2::XMLElement *_elem);
+void InsertSDFExtensionRobot(URDF2SDFPrivate &_conversion,
+                             tinyxml2::XMLElement *_elem);
 
 /// insert extensions into visuals
-void InsertSDFExtensionVisual(tinyxml2::XMLElement *_elem,
+void InsertSDFExtensionVisual(URDF2SDFPrivate &_conversion,
+                              tinyxml2::XMLElement *_elem,
                               const std::string &_linkName);
 
 
 /// insert extensions into joints
-void InsertSDFExtensionJoint(tinyxml2::XMLElement *_elem,
+void InsertSDFExtensionJoint(URDF2SDFPrivate &_conversion,
+                             tinyxml2::XMLElement *_elem,
                              const std::string &_jointName);
 
 /// reduced fixed joints:  check if a fixed joint should be lumped
 ///   checking both the joint type and if disabledFixedJointLumping
 ///   option is set
-bool FixedJointShouldBeReduced(urdf::JointSharedPtr _jnt);
+bool FixedJointShouldBeReduced(URDF2SDFPrivate &_conversion,
+                               urdf::JointSharedPtr _jnt);
 
 /// reduced fixed joints:  apply transform reduction for ray sensors
 ///   in extensions when doing fixed joint reduction
@@ -109,41 +175,51 @@ void ReduceSDFExtensionProjectorTransformReduction(
 void ReduceSDFExtensionsTransform(SDFExtensionPtr _ge);
 
 /// reduce fixed joints:  lump joints to parent link
-void ReduceJointsToParent(urdf::LinkSharedPtr _link);
+void ReduceJointsToParent(URDF2SDFPrivate &_conversion,
+                          urdf::LinkSharedPtr _link,
+                          const LumpTargetMap &_targets);
 
 /// reduce fixed joints:  lump collisions to parent link
-void ReduceCollisionsToParent(urdf::LinkSharedPtr _link);
+void ReduceCollisionsToParent(URDF2SDFPrivate &_conversion,
+                              urdf::LinkSharedPtr _link,
+                              const LumpTarget &_target);
 
 /// reduce fixed joints:  lump visuals to parent link
-void ReduceVisualsToParent(urdf::LinkSharedPtr _link);
+void ReduceVisualsToParent(URDF2SDFPrivate &_conversion,
+                           urdf::LinkSharedPtr _link,
+                           const LumpTarget &_target);
 
 /// reduce fixed joints:  lump inertial to parent link
 void ReduceInertialToParent(urdf::LinkSharedPtr /*_link*/);
 
 /// create SDF Collision block based on URDF
-void CreateCollision(tinyxml2::XMLElement* _elem,
+void CreateCollision(URDF2SDFPrivate &_conversion, tinyxml2::XMLElement* _elem,
                      urdf::LinkConstSharedPtr _link,
                      urdf::CollisionSharedPtr _collision,
                      const std::string &_oldLinkName = std::string(""));
 
 /// create SDF Visual block based on URDF
-void CreateVisual(tinyxml2::XMLElement *_elem, urdf::LinkConstSharedPtr _link,
+void CreateVisual(URDF2SDFPrivate &_conversion,
+                  tinyxml2::XMLElement *_elem, urdf::LinkConstSharedPtr _link,
                   urdf::VisualSharedPtr _visual,
                   const std::string &_oldLinkName = std::string(""));
 
 /// create SDF Joint block based on URDF
-void CreateJoint(tinyxml2::XMLElement *_root, urdf::LinkConstSharedPtr _link,
+void CreateJoint(URDF2SDFPrivate &_conversion,
+                 tinyxml2::XMLElement *_root, urdf::LinkConstSharedPtr _link,
                  ignition::math::Pose3d &_currentTransform);
 
 /// insert extensions into links
-void InsertSDFExtensionLink(tinyxml2::XMLElement *_elem,
+void InsertSDFExtensionLink(URDF2SDFPrivate &_conversion,
+                            tinyxml2::XMLElement *_elem,
                             const std::string &_linkName);
 
 /// create visual blocks from urdf visuals
-void CreateVisuals(tinyxml2::XMLElement* _elem, urdf::LinkConstSharedPtr _link);
+void CreateVisuals(URDF2SDFPrivate &_conversion,
+                   tinyxml2::XMLElement* _elem, urdf::LinkConstSharedPtr _link);
 
 /// create collision blocks from urdf collisions
-void CreateCollisions(tinyxml2::XMLElement* _elem,
+void CreateCollisions(URDF2SDFPrivate &_conversion, tinyxml2::XMLElement* _elem,
                       urdf::LinkConstSharedPtr _link);
 
 /// create SDF Inertial block based on URDF
@@ -155,61 +231,80 @@ void AddTransform(tinyxml2::XMLElement *_elem,
     const ignition::math::Pose3d &_transform);
 
 /// create SDF from URDF link
-void CreateSDF(tinyxml2::XMLElement *_root, urdf::LinkConstSharedPtr _link,
+void CreateSDF(URDF2SDFPrivate &_conversion,
+               tinyxml2::XMLElement *_root, urdf::LinkConstSharedPtr _link,
                const ignition::math::Pose3d &_transform);
 
 /// create SDF Link block based on URDF
-void CreateLink(tinyxml2::XMLElement *_root, urdf::LinkConstSharedPtr _link,
+void CreateLink(URDF2SDFPrivate &_conversion,
+                tinyxml2::XMLElement *_root, urdf::LinkConstSharedPtr _link,
                 ignition::math::Pose3d &_currentTransform);
 
 /// reduced fixed joints:  apply appropriate frame updates in joint
 ///   inside urdf extensions when doing fixed joint reduction
 void ReduceSDFExtensionJointFrameReplace(
     std::vector<XMLDocumentPtr>::iterator _blobIt,
-    urdf::LinkSharedPtr _link);
+    urdf::LinkSharedPtr _link, urdf::LinkSharedPtr _target);
 
 /// reduced fixed joints:  apply appropriate frame updates in gripper
 ///   inside urdf extensions when doing fixed joint reduction
 void ReduceSDFExtensionGripperFrameReplace(
     std::vector<XMLDocumentPtr>::iterator _blobIt,
-    urdf::LinkSharedPtr _link);
+    urdf::LinkSharedPtr _link, urdf::LinkSharedPtr _target);
 
 /// reduced fixed joints:  apply appropriate frame updates in projector
 /// inside urdf extensions when doing fixed joint reduction
 void ReduceSDFExtensionProjectorFrameReplace(
     std::vector<XMLDocumentPtr>::iterator _blobIt,
-    urdf::LinkSharedPtr _link);
+    urdf::LinkSharedPtr _link, urdf::LinkSharedPtr _target);
 
 /// reduced fixed joints:  apply appropriate frame updates in plugins
 ///   inside urdf extensions when doing fixed joint reduction
 void ReduceSDFExtensionPluginFrameReplace(
       std::vector<XMLDocumentPtr>::iterator _blobIt,
-      urdf::LinkSharedPtr _link, const std::string &_pluginName,
-      const std::string &_elementName,
+      urdf::LinkSharedPtr _link, urdf::LinkSharedPtr _target,
+      const std::string &_pluginName, const std::string &_elementName,
       ignition::math::Pose3d _reductionTransform);
 
 /// reduced fixed joints:  apply appropriate frame updates in urdf
 ///   extensions when doing fixed joint reduction
 void ReduceSDFExtensionContactSensorFrameReplace(
+    URDF2SDFPrivate &_conversion,
     std::vector<XMLDocumentPtr>::iterator _blobIt,
     urdf::LinkSharedPtr _link);
 
 /// \brief reduced fixed joints:  apply appropriate updates to urdf
 ///   extensions when doing fixed joint reduction
 ///
-/// Take the link's existing list of gazebo extensions, transfer them
-/// into parent link.  Along the way, update local transforms by adding
-/// the additional transform to parent.  Also, look through all
-/// referenced link names with plugins and update references to current
-/// link to the parent link. (ReduceSDFExtensionFrameReplace())
+/// When _link is the reduced link closest to its target, take the gazebo
+/// extensions of the links of its branch, and transfer them into the
+/// target link.  Along the way, update local transforms by adding the
+/// transform to the target.  Also, update the references to _link in the
+/// blobs that reference it to the target link.
+/// (ReduceSDFExtensionFrameReplace())
 ///
+/// \param[in,out] _conversion State of the conversion.
 /// \param[in] _link pointer to urdf link, its extensions will be reduced
-void ReduceSDFExtensionToParent(urdf::LinkSharedPtr _link);
+/// \param[in] _targets Targets of the reduced links.
+/// \param[in] _branches Reduced links, by the reduced link closest to
+/// their target.
+/// \param[in] _frameBlobs Blobs that reference links, by link name.
+void ReduceSDFExtensionToParent(URDF2SDFPrivate &_conversion,
+                                urdf::LinkSharedPtr _link,
+    const LumpTargetMap &_targets, const LumpBranchMap &_branches,
+    const SDFExtensionBlobMap &_frameBlobs);
 
 /// reduced fixed joints:  apply appropriate frame updates
-///   in urdf extensions when doing fixed joint reduction
-void ReduceSDFExtensionFrameReplace(SDFExtensionPtr _ge,
-    urdf::LinkSharedPtr _link);
+///   in an urdf extension blob when doing fixed joint reduction
+void ReduceSDFExtensionFrameReplace(URDF2SDFPrivate &_conversion,
+                                    SDFExtensionPtr _ge,
+    std::vector<XMLDocumentPtr>::iterator _blobIt,
+    urdf::LinkSharedPtr _link, urdf::LinkSharedPtr _target);
+
+/// reduced fixed joints:  get the names of the links that
+///   ReduceSDFExtensionFrameReplace may replace in an extension blob
+std::vector<std::string> SDFExtensionBlobLinkNames(
+    URDF2SDFPrivate &_conversion, const XMLDocumentPtr &_blob);
 
 /// get value from <key value="..."/> pair and return it as string
 std::string GetKeyValueAsString(tinyxml2::XMLElement* _elem);
@@ -256,16 +351,31 @@ ignition::math::Pose3d CopyPose(urdf::Pose _pose);
 ///   math::Pose
 urdf::Pose CopyPose(ignition::math::Pose3d _pose);
 
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Read the content of a file.
+/// \param[in] _filename Path of the file.
+/// \param[out] _str The content of the file.
+/// \return True if the file was read.
+bool ReadFileToString(const std::string &_filename, std::string &_str)
+{
+  std::ifstream stream(_filename, std::ios::in | std::ios::binary);
+  if (!stream)
+  {
+    return false;
+  }
+  _str.assign(std::istreambuf_iterator<char>(stream),
+              std::istreambuf_iterator<char>());
+  return !stream.bad();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool URDF2SDF::IsURDF(const std::string &_filename)
 {
+  std::string urdfStr;
   tinyxml2::XMLDocument xmlDoc;
-
-  if (tinyxml2::XML_SUCCESS == xmlDoc.LoadFile(_filename.c_str()))
+  if (ReadFileToString(_filename, urdfStr) &&
+      tinyxml2::XML_SUCCESS == xmlDoc.Parse(urdfStr.c_str(), urdfStr.size()))
   {
-    tinyxml2::XMLPrinter printer;
-    xmlDoc.Print(&printer);
-    std::string urdfStr = printer.CStr();
     urdf::ModelInterfaceSharedPtr robotModel = urdf::parseURDF(urdfStr);
     return robotModel != nullptr;
   }
@@ -273,6 +383,13 @@ bool URDF2SDF::IsURDF(const std::string &_filename)
   return false;
 }
 
+/////////////////////////////////////////////////
+double StrToDouble(const std::string &_str)
+{
+  // The helper of an external urdfdom takes a C string
+  return urdf::strToDouble(_str.c_str());
+}
+
 /////////////////////////////////////////////////
 urdf::Vector3 ParseVector3(const std::string &_str, double _scale)
 {
@@ -285,7 +402,7 @@ urdf::Vector3 ParseVector3(const std::string &_str, double _scale)
     {
       try
       {
-        vals.push_back(_scale * std::stod(pieces[i]));
+        vals.push_back(_scale * StrToDouble(pieces[i]));
       }
       catch(std::invalid_argument &)
       {
@@ -333,13 +450,8 @@ urdf::Vector3 ParseVector3(tinyxml2::XMLNode *_key, double _scale)
 /// \return a string
 std::string Vector32Str(const urdf::Vector3 _vector)
 {
-  std::stringstream ss;
-  ss << _vector.x;
-  ss << " ";
-  ss << _vector.y;
-  ss << " ";
-  ss << _vector.z;
-  return ss.str();
+  const double values[3] = {_vector.x, _vector.y, _vector.z};
+  return Values2str(3, values);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -349,30 +461,14 @@ std::string Vector32Str(const urdf::Vector3 _vector)
 ///            collision info (see ReduceCollisionsToParent).
 ///            urdfdom 0.2: collision name with lumped
 ///            collision info (see ReduceCollisionsToParent).
-/// \param[in] _collision move this collision to _parentLink
+/// \param[in] _collision move this collision to _parentLink. Each
+///            collision is moved once, from the link that declares it.
 void ReduceCollisionToParent(urdf::LinkSharedPtr _parentLink,
                              const std::string &_name,
                              urdf::CollisionSharedPtr _collision)
 {
-  // added a check to see if _collision already exist in
-  // _parentLink::collision_array if not, add it.
   _collision->name = _name;
-  std::vector<urdf::CollisionSharedPtr>::iterator collisionIt =
-    find(_parentLink->collision_array.begin(),
-         _parentLink->collision_array.end(),
-         _collision);
-  if (collisionIt != _parentLink->collision_array.end())
-  {
-    sdfwarn << "attempted to add collision [" << _collision->name
-            << "] to link ["
-            << _parentLink->name
-            << "], but it already exists in collision_array under name ["
-            << (*collisionIt)->name << "]\n";
-  }
-  else
-  {
-    _parentLink->collision_array.push_back(_collision);
-  }
+  _parentLink->collision_array.push_back(_collision);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -382,75 +478,176 @@ void ReduceCollisionToParent(urdf::LinkSharedPtr _parentLink,
 ///            visual info (see ReduceVisualsToParent).
 ///            urdfdom 0.2: visual name with lumped
 ///            visual info (see ReduceVisualsToParent).
-/// \param[in] _visual move this visual to _parentLink
+/// \param[in] _visual move this visual to _parentLink. Each visual is
+///            moved once, from the link that declares it.
 void ReduceVisualToParent(urdf::LinkSharedPtr _parentLink,
                           const std::string &_name,
                           urdf::VisualSharedPtr _visual)
 {
-  // added a check to see if _visual already exist in
-  // _parentLink::visual_array if not, add it.
   _visual->name = _name;
-  std::vector<urdf::VisualSharedPtr>::iterator visualIt =
-    find(_parentLink->visual_array.begin(),
-         _parentLink->visual_array.end(),
-         _visual);
-  if (visualIt != _parentLink->visual_array.end())
-  {
-    sdfwarn << "attempted to add visual [" << _visual->name
-            << "] to link ["
-            << _parentLink->name
-            << "], but it already exists in visual_array under name ["
-            << (*visualIt)->name << "]\n";
-  }
-  else
-  {
-    _parentLink->visual_array.push_back(_visual);
-  }
+  _parentLink->visual_array.push_back(_visual);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// reduce fixed joints by lumping inertial, visual and
-// collision elements of the child link into the parent link
-void ReduceFixedJoints(tinyxml2::XMLElement *_root, urdf::LinkSharedPtr _link)
+/// \brief Check if fixed joint reduction lumps a link into its parent. The
+/// first joint is skipped if it's attached to the world.
+/// \param[in,out] _conversion State of the conversion.
+/// \param[in] _link The link.
+/// \return True if the link is reduced.
+bool LinkShouldBeReduced(URDF2SDFPrivate &_conversion,
+                         urdf::LinkConstSharedPtr _link)
+{
+  return _link->getParent() && _link->getParent()->name != "world" &&
+    _link->parent_joint &&
+    FixedJointShouldBeReduced(_conversion, _link->parent_joint);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Lump the inertial of each reduced link into its parent, and
+/// move its extensions and child joints, bottom up. Inertials are
+/// accumulated, so each link is visited once.
+/// \param[in,out] _conversion State of the conversion.
+/// \param[in] _link Root of the tree to reduce.
+/// \param[in] _targets Targets of the reduced links.
+/// \param[in] _branches Reduced links, by the reduced link closest to
+/// their target.
+/// \param[in] _frameBlobs Blobs that reference links, by link name.
+void ReduceFixedJointsRecursive(URDF2SDFPrivate &_conversion,
+                                urdf::LinkSharedPtr _link,
+    const LumpTargetMap &_targets, const LumpBranchMap &_branches,
+    const SDFExtensionBlobMap &_frameBlobs)
 {
   // if child is attached to self by fixed _link first go up the tree,
   //   check it's children recursively
   for (unsigned int i = 0 ; i < _link->child_links.size() ; ++i)
   {
-    if (FixedJointShouldBeReduced(_link->child_links[i]->parent_joint))
+    if (FixedJointShouldBeReduced(_conversion,
+                                  _link->child_links[i]->parent_joint))
     {
-      ReduceFixedJoints(_root, _link->child_links[i]);
+      ReduceFixedJointsRecursive(_conversion, _link->child_links[i], _targets,
+                                 _branches, _frameBlobs);
     }
   }
 
   // reduce this _link's stuff up the tree to parent but skip first joint
   //   if it's the world
-  if (_link->getParent() && _link->getParent()->name != "world" &&
-      _link->parent_joint && FixedJointShouldBeReduced(_link->parent_joint) )
+  if (LinkShouldBeReduced(_conversion, _link))
   {
     sdfdbg << "Fixed Joint Reduction: extension lumping from ["
            << _link->name << "] to [" << _link->getParent()->name << "]\n";
 
     // lump sdf extensions to parent, (give them new reference _link names)
-    ReduceSDFExtensionToParent(_link);
+    ReduceSDFExtensionToParent(_conversion, _link, _targets, _branches,
+                               _frameBlobs);
 
     // reduce _link elements to parent
     ReduceInertialToParent(_link);
-    ReduceVisualsToParent(_link);
-    ReduceCollisionsToParent(_link);
-    ReduceJointsToParent(_link);
+    ReduceJointsToParent(_conversion, _link, _targets);
   }
 
   // continue down the tree for non-fixed joints
   for (unsigned int i = 0 ; i < _link->child_links.size() ; ++i)
   {
-    if (!FixedJointShouldBeReduced(_link->child_links[i]->parent_joint))
+    if (!FixedJointShouldBeReduced(_conversion,
+                                   _link->child_links[i]->parent_joint))
     {
-      ReduceFixedJoints(_root, _link->child_links[i]);
+      ReduceFixedJointsRecursive(_conversion, _link->child_links[i], _targets,
+                                 _branches, _frameBlobs);
     }
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// reduce fixed joints by lumping inertial, visual and
+// collision elements of the child link into the parent link
+void ReduceFixedJoints(URDF2SDFPrivate &_conversion,
+                       tinyxml2::XMLElement * /*_root*/,
+                       urdf::LinkSharedPtr _link)
+{
+  // Find the target of each reduced link top down, composing the fixed
+  // joint transforms along the way, so that visuals, collisions, joints
+  // and extensions are moved and transformed once instead of once per
+  // fixed joint.
+  std::vector<urdf::LinkSharedPtr> links;
+  LumpTargetMap targets;
+  LumpBranchMap branches;
+  std::unordered_map<const urdf::Link *, const urdf::Link *> branchOf;
+  std::vector<urdf::LinkSharedPtr> stack = {_link};
+  while (!stack.empty())
+  {
+    urdf::LinkSharedPtr link = stack.back();
+    stack.pop_back();
+    links.push_back(link);
+
+    if (LinkShouldBeReduced(_conversion, link))
+    {
+      urdf::LinkSharedPtr parent = link->getParent();
+      const urdf::Pose &jointTransform =
+        link->parent_joint->parent_to_joint_origin_transform;
+      auto parentTarget = targets.find(parent.get());
+      if (parentTarget == targets.end())
+      {
+        targets[link.get()] = {parent, jointTransform};
+        branchOf[link.get()] = link.get();
+        branches[link.get()].push_back(link);
+      }
+      else
+      {
+        targets[link.get()] = {parentTarget->second.link,
+          TransformToParentFrame(jointTransform,
+                                 parentTarget->second.transform)};
+        const urdf::Link *branch = branchOf.at(parent.get());
+        branchOf[link.get()] = branch;
+        branches[branch].push_back(link);
+      }
+    }
+
+    // Visit the children in order
+    for (auto child = link->child_links.rbegin();
+         child != link->child_links.rend(); ++child)
+    {
+      stack.push_back(*child);
+    }
+  }
+
+  // Visuals and collisions are moved in depth first order, which keeps the
+  // order in which lumping them link by link would add them to the target.
+  for (const urdf::LinkSharedPtr &link : links)
+  {
+    auto target = targets.find(link.get());
+    if (target != targets.end())
+    {
+      ReduceVisualsToParent(_conversion, link, target->second);
+      ReduceCollisionsToParent(_conversion, link, target->second);
+    }
+  }
+
+  // Only some extension blobs reference links, so they are indexed by the
+  // names of those links rather than searched for every reduced link.
+  SDFExtensionBlobMap frameBlobs;
+  if (!targets.empty())
+  {
+    for (auto &ext : _conversion.extensions)
+    {
+      for (const SDFExtensionPtr &ge : ext.second)
+      {
+        for (auto blobIt = ge->blobs.begin(); blobIt != ge->blobs.end();
+             ++blobIt)
+        {
+          for (const std::string &name :
+               SDFExtensionBlobLinkNames(_conversion, *blobIt))
+          {
+            frameBlobs[name].push_back(std::make_pair(ge, blobIt));
+          }
+        }
+      }
+    }
+  }
+
+  ReduceFixedJointsRecursive(_conversion, _link, targets, branches,
+                             frameBlobs);
+}
+
 // ODE dMatrix
 typedef double dMatrix3[4*3];
 typedef double dVector3[4];
@@ -914,9 +1111,13 @@ void ReduceInertialToParent(urdf::LinkSharedPtr _link)
 
 /////////////////////////////////////////////////
 /// \brief reduce fixed joints:  lump visuals to parent link
+/// \param[in,out] _conversion State of the conversion.
 /// \param[in] _link take all visuals from _link and lump/move them
-///            to the parent link (_link->getParentLink()).
-void ReduceVisualsToParent(urdf::LinkSharedPtr _link)
+///            to the closest ancestor that isn't reduced.
+/// \param[in] _target the ancestor and the pose of _link in its frame.
+void ReduceVisualsToParent(URDF2SDFPrivate &_conversion,
+                           urdf::LinkSharedPtr _link,
+                           const LumpTarget &_target)
 {
   // lump all visuals of _link to _link->getParent().
   // modify visual name (urdf 0.3.x) or
@@ -925,8 +1126,8 @@ void ReduceVisualsToParent(urdf::LinkSharedPtr _link)
   // from another descendant link connected by a fixed joint.
   //
   // Algorithm for generating new name (or group name) is:
-  //   original name + g_lumpPrefix+original link name (urdf 0.3.x)
-  //   original group name + g_lumpPrefix+original link name (urdf 0.2.x)
+  //   original name + lumpPrefix+original link name (urdf 0.3.x)
+  //   original group name + lumpPrefix+original link name (urdf 0.2.x)
   // The purpose is to track where this visual came from
   // (original parent link name before lumping/reducing).
   for (std::vector<urdf::VisualSharedPtr>::iterator
@@ -935,13 +1136,13 @@ void ReduceVisualsToParent(urdf::LinkSharedPtr _link)
   {
     // 20151116: changelog for pull request #235
     std::string newVisualName;
-    std::size_t lumpIndex = (*visualIt)->name.find(g_lumpPrefix);
+    std::size_t lumpIndex = (*visualIt)->name.find(_conversion.lumpPrefix);
     if (lumpIndex != std::string::npos)
     {
       newVisualName = (*visualIt)->name;
       sdfdbg << "re-lumping visual [" << (*visualIt)->name
              << "] for link [" << _link->name
-             << "] to parent [" << _link->getParent()->name
+             << "] to parent [" << _target.link->name
              << "] with name [" << newVisualName << "]\n";
     }
     else
@@ -956,27 +1157,29 @@ void ReduceVisualsToParent(urdf::LinkSharedPtr _link)
       }
       sdfdbg << "lumping visual [" << (*visualIt)->name
              << "] for link [" << _link->name
-             << "] to parent [" << _link->getParent()->name
+             << "] to parent [" << _target.link->name
              << "] with name [" << newVisualName << "]\n";
     }
 
     // transform visual origin from _link frame to
-    // parent link frame before adding to parent
+    // target link frame before adding to target
     (*visualIt)->origin = TransformToParentFrame(
-        (*visualIt)->origin,
-        _link->parent_joint->parent_to_joint_origin_transform);
+        (*visualIt)->origin, _target.transform);
 
-    // add the modified visual to parent
-    ReduceVisualToParent(_link->getParent(), newVisualName,
-                         *visualIt);
+    // add the modified visual to target
+    ReduceVisualToParent(_target.link, newVisualName, *visualIt);
   }
 }
 
 /////////////////////////////////////////////////
 /// \brief reduce fixed joints:  lump collisions to parent link
+/// \param[in,out] _conversion State of the conversion.
 /// \param[in] _link take all collisions from _link and lump/move them
-///            to the parent link (_link->getParentLink()).
-void ReduceCollisionsToParent(urdf::LinkSharedPtr _link)
+///            to the closest ancestor that isn't reduced.
+/// \param[in] _target the ancestor and the pose of _link in its frame.
+void ReduceCollisionsToParent(URDF2SDFPrivate &_conversion,
+                              urdf::LinkSharedPtr _link,
+                              const LumpTarget &_target)
 {
   // lump all collisions of _link to _link->getParent().
   // modify collision name (urdf 0.3.x) or
@@ -985,8 +1188,8 @@ void ReduceCollisionsToParent(urdf::LinkSharedPtr _link)
   // from another descendant link connected by a fixed joint.
   //
   // Algorithm for generating new name (or group name) is:
-  //   original name + g_lumpPrefix+original link name (urdf 0.3.x)
-  //   original group name + g_lumpPrefix+original link name (urdf 0.2.x)
+  //   original name + lumpPrefix+original link name (urdf 0.3.x)
+  //   original group name + lumpPrefix+original link name (urdf 0.2.x)
   // The purpose is to track where this collision came from
   // (original parent link name before lumping/reducing).
   for (std::vector<urdf::CollisionSharedPtr>::iterator
@@ -994,13 +1197,13 @@ void ReduceCollisionsToParent(urdf::LinkSharedPtr _link)
       collisionIt != _link->collision_array.end(); ++collisionIt)
   {
     std::string newCollisionName;
-    std::size_t lumpIndex = (*collisionIt)->name.find(g_lumpPrefix);
+    std::size_t lumpIndex = (*collisionIt)->name.find(_conversion.lumpPrefix);
     if (lumpIndex != std::string::npos)
     {
       newCollisionName = (*collisionIt)->name;
       sdfdbg << "re-lumping collision [" << (*collisionIt)->name
              << "] for link [" << _link->name
-             << "] to parent [" << _link->getParent()->name
+             << "] to parent [" << _target.link->name
              << "] with name [" << newCollisionName << "]\n";
     }
     else
@@ -1015,52 +1218,41 @@ void ReduceCollisionsToParent(urdf::LinkSharedPtr _link)
       }
       sdfdbg << "lumping collision [" << (*collisionIt)->name
              << "] for link [" << _link->name
-             << "] to parent [" << _link->getParent()->name
+             << "] to parent [" << _target.link->name
              << "] with name [" << newCollisionName << "]\n";
     }
     // transform collision origin from _link frame to
-    // parent link frame before adding to parent
+    // target link frame before adding to target
     (*collisionIt)->origin = TransformToParentFrame(
-        (*collisionIt)->origin,
-        _link->parent_joint->parent_to_joint_origin_transform);
+        (*collisionIt)->origin, _target.transform);
 
-    // add the modified collision to parent
-    ReduceCollisionToParent(_link->getParent(), newCollisionName,
-                            *collisionIt);
+    // add the modified collision to target
+    ReduceCollisionToParent(_target.link, newCollisionName, *collisionIt);
   }
 }
 
 /////////////////////////////////////////////////
 /// reduce fixed joints:  lump joints to parent link
-void ReduceJointsToParent(urdf::LinkSharedPtr _link)
+void ReduceJointsToParent(URDF2SDFPrivate &_conversion,
+                          urdf::LinkSharedPtr _link,
+                          const LumpTargetMap &_targets)
 {
   // set child link's parentJoint's parent link to
   // a parent link up stream that does not have a fixed parentJoint
+  const LumpTarget &target = _targets.at(_link.get());
   for (unsigned int i = 0 ; i < _link->child_links.size() ; ++i)
   {
     urdf::JointSharedPtr parentJoint = _link->child_links[i]->parent_joint;
-    if (!FixedJointShouldBeReduced(parentJoint))
-    {
-      // go down the tree until we hit a parent joint that is not fixed
-      urdf::LinkSharedPtr newParentLink = _link;
-      ignition::math::Pose3d jointAnchorTransform;
-      while (newParentLink->parent_joint &&
-             newParentLink->getParent()->name != "world" &&
-             FixedJointShouldBeReduced(newParentLink->parent_joint) )
-      {
-        jointAnchorTransform = jointAnchorTransform * jointAnchorTransform;
-        parentJoint->parent_to_joint_origin_transform =
-          TransformToParentFrame(
-              parentJoint->parent_to_joint_origin_transform,
-              newParentLink->parent_joint->parent_to_joint_origin_transform);
-        newParentLink = newParentLink->getParent();
-      }
-      // now set the _link->child_links[i]->parent_joint's parent link to
-      // the newParentLink
-      _link->child_links[i]->setParent(newParentLink);
-      parentJoint->parent_link_name = newParentLink->name;
-      // and set the _link->child_links[i]->parent_joint's
-      // parent_to_joint_origin_transform as the aggregated anchor transform?
+    if (!FixedJointShouldBeReduced(_conversion, parentJoint))
+    {
+      // the target is the first link up the tree whose parent joint is not
+      // reduced, and its transform aggregates the fixed joints in between
+      parentJoint->parent_to_joint_origin_transform =
+        TransformToParentFrame(
+            parentJoint->parent_to_joint_origin_transform,
+            target.transform);
+      _link->child_links[i]->setParent(target.link);
+      parentJoint->parent_link_name = target.link->name;
     }
   }
 }
@@ -1079,17 +1271,8 @@ std::string lowerStr(const std::string &_str)
 
 ////////////////////////////////////////////////////////////////////////////////
 URDF2SDF::URDF2SDF()
+  : dataPtr(new URDF2SDFPrivate)
 {
-  // default options
-  g_enforceLimits = true;
-  g_reduceFixedJoints = true;
-  g_extensions.clear();
-  g_collisionExt = "_collision";
-  g_visualExt = "_visual";
-  g_lumpPrefix = "_fixed_joint_lump__";
-  g_initialRobotPoseValid = false;
-  g_fixedJointsTransformedInRevoluteJoints.clear();
-  g_fixedJointsTransformedInFixedJoints.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1200,7 +1383,8 @@ std::string GetKeyValueAsString(tinyxml2::XMLElement* _elem)
 }
 
 /////////////////////////////////////////////////
-void ParseRobotOrigin(tinyxml2::XMLDocument &_urdfXml)
+void ParseRobotOrigin(URDF2SDFPrivate &_conversion,
+                      tinyxml2::XMLDocument &_urdfXml)
 {
   tinyxml2::XMLElement *robotXml = _urdfXml.FirstChildElement("robot");
   tinyxml2::XMLElement *originXml = robotXml->FirstChildElement("origin");
@@ -1209,11 +1393,12 @@ void ParseRobotOrigin(tinyxml2::XMLDocument &_urdfXml)
     const char *xyzstr = originXml->Attribute("xyz");
     if (xyzstr == nullptr)
     {
-      g_initialRobotPose.position = urdf::Vector3(0, 0, 0);
+      _conversion.initialRobotPose.position = urdf::Vector3(0, 0, 0);
     }
     else
     {
-      g_initialRobotPose.position = ParseVector3(std::string(xyzstr));
+      _conversion.initialRobotPose.position =
+          ParseVector3(std::string(xyzstr));
     }
     const char *rpystr = originXml->Attribute("rpy");
     urdf::Vector3 rpy;
@@ -1225,22 +1410,23 @@ void ParseRobotOrigin(tinyxml2::XMLDocument &_urdfXml)
     {
       rpy = ParseVector3(std::string(rpystr));
     }
-    g_initialRobotPose.rotation.setFromRPY(rpy.x, rpy.y, rpy.z);
-    g_initialRobotPoseValid = true;
+    _conversion.initialRobotPose.rotation.setFromRPY(rpy.x, rpy.y, rpy.z);
+    _conversion.initialRobotPoseValid = true;
   }
 }
 
 /////////////////////////////////////////////////
-void InsertRobotOrigin(tinyxml2::XMLElement *_elem)
+void InsertRobotOrigin(URDF2SDFPrivate &_conversion,
+                       tinyxml2::XMLElement *_elem)
 {
-  if (g_initialRobotPoseValid)
+  if (_conversion.initialRobotPoseValid)
   {
     // set transform
     double pose[6];
-    pose[0] = g_initialRobotPose.position.x;
-    pose[1] = g_initialRobotPose.position.y;
-    pose[2] = g_initialRobotPose.position.z;
-    g_initialRobotPose.rotation.getRPY(pose[3], pose[4], pose[5]);
+    pose[0] = _conversion.initialRobotPose.position.x;
+    pose[1] = _conversion.initialRobotPose.position.y;
+    pose[2] = _conversion.initialRobotPose.position.z;
+    _conversion.initialRobotPose.rotation.getRPY(pose[3], pose[4], pose[5]);
     AddKeyValue(_elem, "pose", Values2str(6, pose));
   }
 }
@@ -1251,7 +1437,7 @@ void URDF2SDF::ParseSDFExtension(tinyxml2::XMLDocument &_urdfXml)
   tinyxml2::XMLElement* robotXml = _urdfXml.FirstChildElement("robot");
 
   // Get all SDF extension elements, put everything in
-  //   g_extensions map, containing a key string
+  //   extensions map, containing a key string
   //   (link/joint name) and values
   for (tinyxml2::XMLElement* sdfXml = robotXml->FirstChildElement("gazebo");
        sdfXml; sdfXml = sdfXml->NextSiblingElement("gazebo"))
@@ -1269,11 +1455,12 @@ void URDF2SDF::ParseSDFExtension(tinyxml2::XMLDocument &_urdfXml)
       refStr = std::string(ref);
     }
 
-    if (g_extensions.find(refStr) == g_extensions.end())
+    if (this->dataPtr->extensions.find(refStr) ==
+        this->dataPtr->extensions.end())
     {
       // create extension map for reference
       std::vector<SDFExtensionPtr> ge;
-      g_extensions.insert(std::make_pair(refStr, ge));
+      this->dataPtr->extensions.insert(std::make_pair(refStr, ge));
     }
 
     // create and insert a new SDFExtension into the map
@@ -1372,27 +1559,27 @@ void URDF2SDF::ParseSDFExtension(tinyxml2::XMLDocument &_urdfXml)
       else if (strcmp(childElem->Name(), "dampingFactor") == 0)
       {
         sdf->isDampingFactor = true;
-        sdf->dampingFactor = std::stod(GetKeyValueAsString(childElem));
+        sdf->dampingFactor = StrToDouble(GetKeyValueAsString(childElem));
       }
       else if (strcmp(childElem->Name(), "maxVel") == 0)
       {
         sdf->isMaxVel = true;
-        sdf->maxVel = std::stod(GetKeyValueAsString(childElem));
+        sdf->maxVel = StrToDouble(GetKeyValueAsString(childElem));
       }
       else if (strcmp(childElem->Name(), "minDepth") == 0)
       {
         sdf->isMinDepth = true;
-        sdf->minDepth = std::stod(GetKeyValueAsString(childElem));
+        sdf->minDepth = StrToDouble(GetKeyValueAsString(childElem));
       }
       else if (strcmp(childElem->Name(), "mu1") == 0)
       {
         sdf->isMu1 = true;
-        sdf->mu1 = std::stod(GetKeyValueAsString(childElem));
+        sdf->mu1 = StrToDouble(GetKeyValueAsString(childElem));
       }
       else if (strcmp(childElem->Name(), "mu2") == 0)
       {
         sdf->isMu2 = true;
-        sdf->mu2 = std::stod(GetKeyValueAsString(childElem));
+        sdf->mu2 = StrToDouble(GetKeyValueAsString(childElem));
       }
       else if (strcmp(childElem->Name(), "fdir1") == 0)
       {
@@ -1401,12 +1588,12 @@ void URDF2SDF::ParseSDFExtension(tinyxml2::XMLDocument &_urdfXml)
       else if (strcmp(childElem->Name(), "kp") == 0)
       {
         sdf->isKp = true;
-        sdf->kp = std::stod(GetKeyValueAsString(childElem));
+        sdf->kp = StrToDouble(GetKeyValueAsString(childElem));
       }
       else if (strcmp(childElem->Name(), "kd") == 0)
       {
         sdf->isKd = true;
-        sdf->kd = std::stod(GetKeyValueAsString(childElem));
+        sdf->kd = StrToDouble(GetKeyValueAsString(childElem));
       }
       else if (strcmp(childElem->Name(), "selfCollide") == 0)
       {
@@ -1432,32 +1619,32 @@ void URDF2SDF::ParseSDFExtension(tinyxml2::XMLDocument &_urdfXml)
       else if (strcmp(childElem->Name(), "laserRetro") == 0)
       {
         sdf->isLaserRetro = true;
-        sdf->laserRetro = std::stod(GetKeyValueAsString(childElem));
+        sdf->laserRetro = StrToDouble(GetKeyValueAsString(childElem));
       }
       else if (strcmp(childElem->Name(), "springReference") == 0)
       {
         sdf->isSpringReference = true;
-        sdf->springReference = std::stod(GetKeyValueAsString(childElem));
+        sdf->springReference = StrToDouble(GetKeyValueAsString(childElem));
       }
       else if (strcmp(childElem->Name(), "springStiffness") == 0)
       {
         sdf->isSpringStiffness = true;
-        sdf->springStiffness = std::stod(GetKeyValueAsString(childElem));
+        sdf->springStiffness = StrToDouble(GetKeyValueAsString(childElem));
       }
       else if (strcmp(childElem->Name(), "stopCfm") == 0)
       {
         sdf->isStopCfm = true;
-        sdf->stopCfm = std::stod(GetKeyValueAsString(childElem));
+        sdf->stopCfm = StrToDouble(GetKeyValueAsString(childElem));
       }
       else if (strcmp(childElem->Name(), "stopErp") == 0)
       {
         sdf->isStopErp = true;
-        sdf->stopErp = std::stod(GetKeyValueAsString(childElem));
+        sdf->stopErp = StrToDouble(GetKeyValueAsString(childElem));
       }
       else if (strcmp(childElem->Name(), "fudgeFactor") == 0)
       {
         sdf->isFudgeFactor = true;
-        sdf->fudgeFactor = std::stod(GetKeyValueAsString(childElem));
+        sdf->fudgeFactor = StrToDouble(GetKeyValueAsString(childElem));
       }
       else if (strcmp(childElem->Name(), "provideFeedback") == 0)
       {
@@ -1508,7 +1695,7 @@ void URDF2SDF::ParseSDFExtension(tinyxml2::XMLDocument &_urdfXml)
         if (lowerStr(valueStr) == "true" || lowerStr(valueStr) == "yes" ||
             valueStr == "1")
         {
-          g_fixedJointsTransformedInRevoluteJoints.insert(refStr);
+          this->dataPtr->fixedJointsTransformedInRevoluteJoints.insert(refStr);
         }
       }
       else if (strcmp(childElem->Name(), "preserveFixedJoint") == 0)
@@ -1518,7 +1705,7 @@ void URDF2SDF::ParseSDFExtension(tinyxml2::XMLDocument &_urdfXml)
         if (lowerStr(valueStr) == "true" || lowerStr(valueStr) == "yes" ||
             valueStr == "1")
         {
-          g_fixedJointsTransformedInFixedJoints.insert(refStr);
+          this->dataPtr->fixedJointsTransformedInFixedJoints.insert(refStr);
         }
       }
       else
@@ -1538,20 +1725,21 @@ void URDF2SDF::ParseSDFExtension(tinyxml2::XMLDocument &_urdfXml)
     }
 
     // insert into my map
-    (g_extensions.find(refStr))->second.push_back(sdf);
+    (this->dataPtr->extensions.find(refStr))->second.push_back(sdf);
   }
 
   // Handle fixed joints for which both disableFixedJointLumping
   // and preserveFixedJoint options are present
   for (auto& fixedJointConvertedToFixed:
-             g_fixedJointsTransformedInFixedJoints)
+             this->dataPtr->fixedJointsTransformedInFixedJoints)
   {
     // If both options are present, the model creator is aware of the
     // existence of the preserveFixedJoint option and the
     // disableFixedJointLumping option is there only for backward compatibility
     // For this reason, if both options are present then the preserveFixedJoint
     // option has the precedence
-    g_fixedJointsTransformedInRevoluteJoints.erase(fixedJointConvertedToFixed);
+    this->dataPtr->fixedJointsTransformedInRevoluteJoints.erase(
+        fixedJointConvertedToFixed);
   }
 }
 
@@ -1575,7 +1763,8 @@ void CopyBlob(tinyxml2::XMLElement *_src, tinyxml2::XMLElement *_blob_parent)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void InsertSDFExtensionCollision(tinyxml2::XMLElement *_elem,
+void InsertSDFExtensionCollision(URDF2SDFPrivate &_conversion,
+                                 tinyxml2::XMLElement *_elem,
                                  const std::string &_linkName)
 {
   // loop through extensions for the whole model
@@ -1584,13 +1773,13 @@ void InsertSDFExtensionCollision(tinyxml2::XMLElement *_elem,
   //   - urdf collision name -> sdf collision name conversion
   //   - fixed joint reduction / lumping
   for (StringSDFExtensionPtrMap::iterator
-      sdfIt = g_extensions.begin();
-      sdfIt != g_extensions.end(); ++sdfIt)
+      sdfIt = _conversion.extensions.begin();
+      sdfIt != _conversion.extensions.end(); ++sdfIt)
   {
     if (sdfIt->first == _linkName)
     {
       // std::cerr << "============================\n";
-      // std::cerr << "working on g_extensions for link ["
+      // std::cerr << "working on extensions for link ["
       //           << sdfIt->first << "]\n";
       // if _elem already has a surface element, use it
       tinyxml2::XMLNode *surface = _elem->FirstChildElement("surface");
@@ -1623,8 +1812,8 @@ void InsertSDFExtensionCollision(tinyxml2::XMLElement *_elem,
         //           << "]\n";
         // std::cerr << "----------------------------\n";
 
-        std::string lumpCollisionName = g_lumpPrefix +
-          (*ge)->oldLinkName + g_collisionExt;
+        std::string lumpCollisionName = _conversion.lumpPrefix +
+          (*ge)->oldLinkName + _conversion.collisionExt;
 
         bool wasReduced = (_linkName == (*ge)->oldLinkName);
         bool collisionNameContainsLinkname =
@@ -1632,7 +1821,7 @@ void InsertSDFExtensionCollision(tinyxml2::XMLElement *_elem,
         bool collisionNameContainsLumpedLinkname =
           sdfCollisionName.find(lumpCollisionName) != std::string::npos;
         bool collisionNameContainsLumpedRef =
-          sdfCollisionName.find(g_lumpPrefix) != std::string::npos;
+          sdfCollisionName.find(_conversion.lumpPrefix) != std::string::npos;
 
         if (!collisionNameContainsLinkname)
         {
@@ -1641,9 +1830,9 @@ void InsertSDFExtensionCollision(tinyxml2::XMLElement *_elem,
         }
 
         // if the collision _elem was not reduced,
-        // its name should not have g_lumpPrefix in it.
+        // its name should not have lumpPrefix in it.
         // otherwise, its name should have
-        // "g_lumpPrefix+[original link name before reduction]".
+        // "lumpPrefix+[original link name before reduction]".
         if ((wasReduced && !collisionNameContainsLumpedRef) ||
             (!wasReduced && collisionNameContainsLumpedLinkname))
         {
@@ -1885,7 +2074,8 @@ void InsertSDFExtensionCollision(tinyxml2::XMLElement *_elem,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void InsertSDFExtensionVisual(tinyxml2::XMLElement *_elem,
+void InsertSDFExtensionVisual(URDF2SDFPrivate &_conversion,
+                              tinyxml2::XMLElement *_elem,
                               const std::string &_linkName)
 {
   // loop through extensions for the whole model
@@ -1894,13 +2084,13 @@ void InsertSDFExtensionVisual(tinyxml2::XMLElement *_elem,
   //   - urdf visual name -> sdf visual name conversion
   //   - fixed joint reduction / lumping
   for (StringSDFExtensionPtrMap::iterator
-      sdfIt = g_extensions.begin();
-      sdfIt != g_extensions.end(); ++sdfIt)
+      sdfIt = _conversion.extensions.begin();
+      sdfIt != _conversion.extensions.end(); ++sdfIt)
   {
     if (sdfIt->first == _linkName)
     {
       // std::cerr << "============================\n";
-      // std::cerr << "working on g_extensions for link ["
+      // std::cerr << "working on extensions for link ["
       //           << sdfIt->first << "]\n";
       // if _elem already has a material element, use it
       tinyxml2::XMLElement *material = _elem->FirstChildElement("material");
@@ -1930,8 +2120,8 @@ void InsertSDFExtensionVisual(tinyxml2::XMLElement *_elem,
         //           << "]\n";
         // std::cerr << "----------------------------\n";
 
-        std::string lumpVisualName = g_lumpPrefix +
-          (*ge)->oldLinkName + g_visualExt;
+        std::string lumpVisualName = _conversion.lumpPrefix +
+          (*ge)->oldLinkName + _conversion.visualExt;
 
         bool wasReduced = (_linkName == (*ge)->oldLinkName);
         bool visualNameContainsLinkname =
@@ -1939,7 +2129,7 @@ void InsertSDFExtensionVisual(tinyxml2::XMLElement *_elem,
         bool visualNameContainsLumpedLinkname =
           sdfVisualName.find(lumpVisualName) != std::string::npos;
         bool visualNameContainsLumpedRef =
-          sdfVisualName.find(g_lumpPrefix) != std::string::npos;
+          sdfVisualName.find(_conversion.lumpPrefix) != std::string::npos;
 
         if (!visualNameContainsLinkname)
         {
@@ -1948,9 +2138,9 @@ void InsertSDFExtensionVisual(tinyxml2::XMLElement *_elem,
         }
 
         // if the visual _elem was not reduced,
-        // its name should not have g_lumpPrefix in it.
+        // its name should not have lumpPrefix in it.
         // otherwise, its name should have
-        // "g_lumpPrefix+[original link name before reduction]".
+        // "lumpPrefix+[original link name before reduction]".
         if ((wasReduced && !visualNameContainsLumpedRef) ||
             (!wasReduced && visualNameContainsLumpedLinkname))
         {
@@ -2079,12 +2269,13 @@ void InsertSDFExtensionVisual(tinyxml2::XMLElement *_elem,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void InsertSDFExtensionLink(tinyxml2::XMLElement *_elem,
+void InsertSDFExtensionLink(URDF2SDFPrivate &_conversion,
+                            tinyxml2::XMLElement *_elem,
                             const std::string &_linkName)
 {
   for (StringSDFExtensionPtrMap::iterator
-       sdfIt = g_extensions.begin();
-       sdfIt != g_extensions.end(); ++sdfIt)
+       sdfIt = _conversion.extensions.begin();
+       sdfIt != _conversion.extensions.end(); ++sdfIt)
   {
     if (sdfIt->first == _linkName)
     {
@@ -2133,13 +2324,14 @@ void InsertSDFExtensionLink(tinyxml2::XMLElement *_elem,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void InsertSDFExtensionJoint(tinyxml2::XMLElement *_elem,
+void InsertSDFExtensionJoint(URDF2SDFPrivate &_conversion,
+                             tinyxml2::XMLElement *_elem,
                              const std::string &_jointName)
 {
   auto* doc = _elem->GetDocument();
   for (StringSDFExtensionPtrMap::iterator
-      sdfIt = g_extensions.begin();
-      sdfIt != g_extensions.end(); ++sdfIt)
+      sdfIt = _conversion.extensions.begin();
+      sdfIt != _conversion.extensions.end(); ++sdfIt)
   {
     if (sdfIt->first == _jointName)
     {
@@ -2280,11 +2472,12 @@ void InsertSDFExtensionJoint(tinyxml2::XMLElement *_elem,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void InsertSDFExtensionRobot(tinyxml2::XMLElement *_elem)
+void InsertSDFExtensionRobot(URDF2SDFPrivate &_conversion,
+                             tinyxml2::XMLElement *_elem)
 {
   for (StringSDFExtensionPtrMap::iterator
-      sdfIt = g_extensions.begin();
-      sdfIt != g_extensions.end(); ++sdfIt)
+      sdfIt = _conversion.extensions.begin();
+      sdfIt != _conversion.extensions.end(); ++sdfIt)
   {
     if (sdfIt->first.empty())
     {
@@ -2486,114 +2679,179 @@ ignition::math::Pose3d inverseTransformToParentFrame(
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void ReduceSDFExtensionToParent(urdf::LinkSharedPtr _link)
+void ReduceSDFExtensionToParent(URDF2SDFPrivate &_conversion,
+                                urdf::LinkSharedPtr _link,
+    const LumpTargetMap &_targets, const LumpBranchMap &_branches,
+    const SDFExtensionBlobMap &_frameBlobs)
 {
-  /// \todo: move to header
-  /// Take the link's existing list of gazebo extensions, transfer them
-  /// into parent link.  Along the way, update local transforms by adding
-  /// the additional transform to parent.  Also, look through all
-  /// referenced link names with plugins and update references to current
-  /// link to the parent link. (reduceGazeboExtensionFrameReplace())
-
   /// @todo: this is a very complicated module that updates the plugins
   /// based on fixed joint reduction really wish this could be a lot cleaner
 
   std::string linkName = _link->name;
 
-  // update extension map with references to linkName
-  // this->ListSDFExtensions();
-  StringSDFExtensionPtrMap::iterator ext = g_extensions.find(linkName);
-  if (ext != g_extensions.end())
+  // The extensions of a branch are moved straight to its target, with the
+  // transform composed from all of its fixed joints. This is done at the
+  // turn of the first link of the branch, which comes after the turns of
+  // the other links of the branch.
+  auto branch = _branches.find(_link.get());
+  if (branch != _branches.end())
   {
-    sdfdbg << "  REDUCE EXTENSION: moving reference from ["
-           << linkName << "] to [" << _link->getParent()->name << "]\n";
-
-    // update reduction transform (for rays, cameras for now).
-    //   FIXME: contact frames too?
-    for (std::vector<SDFExtensionPtr>::iterator ge = ext->second.begin();
-         ge != ext->second.end(); ++ge)
+    const urdf::LinkSharedPtr &targetLink = _targets.at(_link.get()).link;
+    for (const urdf::LinkSharedPtr &lumped : branch->second)
     {
-      (*ge)->reductionTransform = TransformToParentFrame(
-          (*ge)->reductionTransform,
-          _link->parent_joint->parent_to_joint_origin_transform);
-      // for sensor and projector blocks only
-      ReduceSDFExtensionsTransform((*ge));
-    }
+      StringSDFExtensionPtrMap::iterator ext =
+        _conversion.extensions.find(lumped->name);
+      if (ext == _conversion.extensions.end() || ext->second.empty())
+      {
+        continue;
+      }
 
-    // find pointer to the existing extension with the new _link reference
-    std::string parentLinkName = _link->getParent()->name;
-    StringSDFExtensionPtrMap::iterator parentExt =
-      g_extensions.find(parentLinkName);
+      sdfdbg << "  REDUCE EXTENSION: moving reference from ["
+             << lumped->name << "] to [" << targetLink->name << "]\n";
 
-    // if none exist, create new extension with parentLinkName
-    if (parentExt == g_extensions.end())
-    {
-      std::vector<SDFExtensionPtr> ge;
-      g_extensions.insert(std::make_pair(parentLinkName, ge));
-      parentExt = g_extensions.find(parentLinkName);
-    }
+      // update reduction transform (for rays, cameras for now).
+      //   FIXME: contact frames too?
+      const urdf::Pose &transform = _targets.at(lumped.get()).transform;
+      std::vector<SDFExtensionPtr> &targetExt =
+        _conversion.extensions[targetLink->name];
+      for (const SDFExtensionPtr &ge : ext->second)
+      {
+        ge->reductionTransform =
+          TransformToParentFrame(ge->reductionTransform, transform);
+        // for sensor and projector blocks only
+        ReduceSDFExtensionsTransform(ge);
 
-    // move sdf extensions from _link into the parent _link's extensions
-    for (std::vector<SDFExtensionPtr>::iterator ge = ext->second.begin();
-         ge != ext->second.end(); ++ge)
-    {
-      parentExt->second.push_back(*ge);
+        // move sdf extensions from the lumped link into the target's
+        targetExt.push_back(ge);
+      }
+      ext->second.clear();
     }
-    ext->second.clear();
   }
 
   // for extensions with empty reference, search and replace
   // _link name patterns within the plugin with new _link name
   // and assign the proper reduction transform for the _link name pattern
-  for (StringSDFExtensionPtrMap::iterator sdfIt = g_extensions.begin();
-       sdfIt != g_extensions.end(); ++sdfIt)
+  const urdf::LinkSharedPtr &target = _targets.at(_link.get()).link;
+  sdfdbg << "  STRING REPLACE: instances of _link name ["
+        << linkName << "] with [" << target->name << "]\n";
+  auto blobs = _frameBlobs.find(linkName);
+  if (blobs != _frameBlobs.end())
   {
-    // update reduction transform (for contacts, rays, cameras for now).
-    for (std::vector<SDFExtensionPtr>::iterator ge = sdfIt->second.begin();
-         ge != sdfIt->second.end(); ++ge)
+    for (const SDFExtensionBlob &blob : blobs->second)
     {
-      ReduceSDFExtensionFrameReplace(*ge, _link);
+      ReduceSDFExtensionFrameReplace(_conversion, blob.first, blob.second,
+                                     _link, target);
     }
   }
-
-  // this->ListSDFExtensions();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void ReduceSDFExtensionFrameReplace(SDFExtensionPtr _ge,
-                                    urdf::LinkSharedPtr _link)
+void ReduceSDFExtensionFrameReplace(URDF2SDFPrivate &_conversion,
+                                    SDFExtensionPtr _ge,
+                                    std::vector<XMLDocumentPtr>::iterator
+                                      _blobIt,
+                                    urdf::LinkSharedPtr _link,
+                                    urdf::LinkSharedPtr _target)
 {
-  std::string linkName = _link->name;
-  std::string parentLinkName = _link->getParent()->name;
-
   // HACK: need to do this more generally, but we also need to replace
   //       all instances of _link name with new link name
   //       e.g. contact sensor refers to
   //         <collision>base_link_collision</collision>
   //         and it needs to be reparented to
   //         <collision>base_footprint_collision</collision>
-  sdfdbg << "  STRING REPLACE: instances of _link name ["
-        << linkName << "] with [" << parentLinkName << "]\n";
-  for (auto blobIt = _ge->blobs.begin();
-         blobIt != _ge->blobs.end(); ++blobIt)
+  ReduceSDFExtensionContactSensorFrameReplace(_conversion, _blobIt, _link);
+  ReduceSDFExtensionPluginFrameReplace(_blobIt, _link, _target,
+                                       "plugin", "bodyName",
+                                       _ge->reductionTransform);
+  ReduceSDFExtensionPluginFrameReplace(_blobIt, _link, _target,
+                                       "plugin", "frameName",
+                                       _ge->reductionTransform);
+  ReduceSDFExtensionProjectorFrameReplace(_blobIt, _link, _target);
+  ReduceSDFExtensionGripperFrameReplace(_blobIt, _link, _target);
+  ReduceSDFExtensionJointFrameReplace(_blobIt, _link, _target);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<std::string> SDFExtensionBlobLinkNames(
+    URDF2SDFPrivate &_conversion, const XMLDocumentPtr &_blob)
+{
+  // These are the references that the Reduce*FrameReplace functions update
+  std::vector<std::string> names;
+  auto addName = [&names](tinyxml2::XMLElement *_elem)
+  {
+    if (_elem)
+    {
+      std::string name = GetKeyValueAsString(_elem);
+      if (std::find(names.begin(), names.end(), name) == names.end())
+      {
+        names.push_back(name);
+      }
+    }
+  };
+
+  tinyxml2::XMLElement *elem = _blob->FirstChildElement();
+  if (!elem)
+  {
+    return names;
+  }
+
+  if (strcmp(elem->Name(), "sensor") == 0)
+  {
+    tinyxml2::XMLElement *contact = _blob->FirstChildElement("contact");
+    tinyxml2::XMLElement *collision =
+      contact ? contact->FirstChildElement("collision") : nullptr;
+    if (collision)
+    {
+      // The collision is named after its link
+      std::string collisionName = GetKeyValueAsString(collision);
+      const std::string &ext = _conversion.collisionExt;
+      if (collisionName.size() > ext.size() &&
+          collisionName.compare(collisionName.size() - ext.size(),
+                                ext.size(), ext) == 0)
+      {
+        names.push_back(
+            collisionName.substr(0, collisionName.size() - ext.size()));
+      }
+    }
+  }
+  else if (strcmp(elem->Name(), "plugin") == 0)
+  {
+    addName(_blob->FirstChildElement("bodyName"));
+    addName(_blob->FirstChildElement("frameName"));
+  }
+  else if (strcmp(elem->Name(), "gripper") == 0)
   {
-    tinyxml2::XMLPrinter debugStreamIn;
-    (*blobIt)->Print(&debugStreamIn);
-    sdfdbg << "        INITIAL STRING link ["
-           << linkName << "]-->[" << parentLinkName << "]: ["
-           << debugStreamIn.CStr() << "]\n";
+    addName(_blob->FirstChildElement("gripper_link"));
+    addName(_blob->FirstChildElement("palm_link"));
+  }
+  else if (strcmp(elem->Name(), "joint") == 0)
+  {
+    addName(_blob->FirstChildElement("parent"));
+    addName(_blob->FirstChildElement("child"));
+  }
 
-    ReduceSDFExtensionContactSensorFrameReplace(blobIt, _link);
-    ReduceSDFExtensionPluginFrameReplace(blobIt, _link,
-                                         "plugin", "bodyName",
-                                         _ge->reductionTransform);
-    ReduceSDFExtensionPluginFrameReplace(blobIt, _link,
-                                         "plugin", "frameName",
-                                         _ge->reductionTransform);
-    ReduceSDFExtensionProjectorFrameReplace(blobIt, _link);
-    ReduceSDFExtensionGripperFrameReplace(blobIt, _link);
-    ReduceSDFExtensionJointFrameReplace(blobIt, _link);
+  tinyxml2::XMLElement *projector = _blob->FirstChildElement("projector");
+  if (projector)
+  {
+    std::string projectorName = GetKeyValueAsString(projector);
+    size_t pos = projectorName.find("/");
+    if (pos == std::string::npos)
+    {
+      sdferr << "no slash in projector reference tag [" << projectorName
+             << "], expecting linkName/projector_name.\n";
+    }
+    else
+    {
+      std::string projectorLinkName = projectorName.substr(0, pos);
+      if (std::find(names.begin(), names.end(), projectorLinkName) ==
+          names.end())
+      {
+        names.push_back(projectorLinkName);
+      }
+    }
   }
+
+  return names;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2614,8 +2872,8 @@ void ReduceSDFExtensionsTransform(SDFExtensionPtr _ge)
 void URDF2SDF::ListSDFExtensions()
 {
   for (StringSDFExtensionPtrMap::iterator
-      sdfIt = g_extensions.begin();
-      sdfIt != g_extensions.end(); ++sdfIt)
+      sdfIt = this->dataPtr->extensions.begin();
+      sdfIt != this->dataPtr->extensions.end(); ++sdfIt)
   {
     int extCount = 0;
     for (std::vector<SDFExtensionPtr>::iterator ge = sdfIt->second.begin();
@@ -2642,8 +2900,8 @@ void URDF2SDF::ListSDFExtensions()
 void URDF2SDF::ListSDFExtensions(const std::string &_reference)
 {
   for (StringSDFExtensionPtrMap::iterator
-      sdfIt = g_extensions.begin();
-      sdfIt != g_extensions.end(); ++sdfIt)
+      sdfIt = this->dataPtr->extensions.begin();
+      sdfIt != this->dataPtr->extensions.end(); ++sdfIt)
   {
     if (sdfIt->first == _reference)
     {
@@ -2665,7 +2923,7 @@ void URDF2SDF::ListSDFExtensions(const std::string &_reference)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void CreateSDF(tinyxml2::XMLElement *_root,
+void CreateSDF(URDF2SDFPrivate &_conversion, tinyxml2::XMLElement *_root,
                urdf::LinkConstSharedPtr _link,
                const ignition::math::Pose3d &_transform)
 {
@@ -2708,17 +2966,17 @@ void CreateSDF(tinyxml2::XMLElement *_root,
 
   // create <body:...> block for non fixed joint attached bodies
   if ((_link->getParent() && _link->getParent()->name == "world") ||
-      !g_reduceFixedJoints ||
+      !_conversion.reduceFixedJoints ||
       (!_link->parent_joint ||
-       !FixedJointShouldBeReduced(_link->parent_joint)))
+       !FixedJointShouldBeReduced(_conversion, _link->parent_joint)))
   {
-    CreateLink(_root, _link, _currentTransform);
+    CreateLink(_conversion, _root, _link, _currentTransform);
   }
 
   // recurse into children
   for (unsigned int i = 0 ; i < _link->child_links.size() ; ++i)
   {
-    CreateSDF(_root, _link->child_links[i], _currentTransform);
+    CreateSDF(_conversion, _root, _link->child_links[i], _currentTransform);
   }
 }
 
@@ -2751,7 +3009,7 @@ urdf::Pose CopyPose(ignition::math::Pose3d _pose)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void CreateLink(tinyxml2::XMLElement *_root,
+void CreateLink(URDF2SDFPrivate &_conversion, tinyxml2::XMLElement *_root,
                 urdf::LinkConstSharedPtr _link,
                 ignition::math::Pose3d &_currentTransform)
 {
@@ -2786,23 +3044,23 @@ void CreateLink(tinyxml2::XMLElement *_root,
   CreateInertial(elem, _link);
 
   // create new collision block
-  CreateCollisions(elem, _link);
+  CreateCollisions(_conversion, elem, _link);
 
   // create new visual block
-  CreateVisuals(elem, _link);
+  CreateVisuals(_conversion, elem, _link);
 
   // copy sdf extensions data
-  InsertSDFExtensionLink(elem, _link->name);
+  InsertSDFExtensionLink(_conversion, elem, _link->name);
 
   // make a <joint:...> block
-  CreateJoint(_root, _link, _currentTransform);
+  CreateJoint(_conversion, _root, _link, _currentTransform);
 
   // add body to document
   _root->LinkEndChild(elem);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void CreateCollisions(tinyxml2::XMLElement* _elem,
+void CreateCollisions(URDF2SDFPrivate &_conversion, tinyxml2::XMLElement* _elem,
                       urdf::LinkConstSharedPtr _link)
 {
   // loop through all collisions in
@@ -2829,7 +3087,7 @@ void CreateCollisions(tinyxml2::XMLElement* _elem,
     }
 
     // add _collision extension
-    collisionName = collisionName + g_collisionExt;
+    collisionName = collisionName + _conversion.collisionExt;
 
     if (collisionCount > 0)
     {
@@ -2840,14 +3098,14 @@ void CreateCollisions(tinyxml2::XMLElement* _elem,
     }
 
     // make a <collision> block
-    CreateCollision(_elem, _link, *collision, collisionName);
+    CreateCollision(_conversion, _elem, _link, *collision, collisionName);
 
     ++collisionCount;
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void CreateVisuals(tinyxml2::XMLElement* _elem,
+void CreateVisuals(URDF2SDFPrivate &_conversion, tinyxml2::XMLElement* _elem,
                    urdf::LinkConstSharedPtr _link)
 {
   // loop through all visuals in
@@ -2874,7 +3132,7 @@ void CreateVisuals(tinyxml2::XMLElement* _elem,
     }
 
     // add _visual extension
-    visualName = visualName + g_visualExt;
+    visualName = visualName + _conversion.visualExt;
 
     if (visualCount > 0)
     {
@@ -2885,7 +3143,7 @@ void CreateVisuals(tinyxml2::XMLElement* _elem,
     }
 
     // make a <visual> block
-    CreateVisual(_elem, _link, *visual, visualName);
+    CreateVisual(_conversion, _elem, _link, *visual, visualName);
 
     ++visualCount;
   }
@@ -2931,7 +3189,7 @@ void CreateInertial(tinyxml2::XMLElement *_elem,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void CreateJoint(tinyxml2::XMLElement *_root,
+void CreateJoint(URDF2SDFPrivate &_conversion, tinyxml2::XMLElement *_root,
                  urdf::LinkConstSharedPtr _link,
                  ignition::math::Pose3d &/*_currentTransform*/)
 {
@@ -2971,16 +3229,17 @@ void CreateJoint(tinyxml2::XMLElement *_root,
   if (jtype == "fixed")
   {
     fixedJointConvertedToRevoluteJoint =
-      (g_fixedJointsTransformedInRevoluteJoints.find(_link->parent_joint->name)
-       != g_fixedJointsTransformedInRevoluteJoints.end());
+      (_conversion.fixedJointsTransformedInRevoluteJoints.find(
+           _link->parent_joint->name)
+       != _conversion.fixedJointsTransformedInRevoluteJoints.end());
   }
 
   // skip if joint type is fixed and it is lumped
   //   skip/return with the exception of root link being world,
   //   because there's no lumping there
   if (_link->getParent() && _link->getParent()->name != "world"
-      && FixedJointShouldBeReduced(_link->parent_joint)
-      && g_reduceFixedJoints)
+      && FixedJointShouldBeReduced(_conversion, _link->parent_joint)
+      && _conversion.reduceFixedJoints)
   {
     return;
   }
@@ -3038,7 +3297,7 @@ void CreateJoint(tinyxml2::XMLElement *_root,
                     Values2str(1, &_link->parent_joint->dynamics->friction));
       }
 
-      if (g_enforceLimits && _link->parent_joint->limits)
+      if (_conversion.enforceLimits && _link->parent_joint->limits)
       {
         if (jtype == "slider")
         {
@@ -3096,7 +3355,7 @@ void CreateJoint(tinyxml2::XMLElement *_root,
     }
 
     // copy sdf extensions data
-    InsertSDFExtensionJoint(joint, _link->parent_joint->name);
+    InsertSDFExtensionJoint(_conversion, joint, _link->parent_joint->name);
 
     // add joint to document
     _root->LinkEndChild(joint);
@@ -3104,7 +3363,7 @@ void CreateJoint(tinyxml2::XMLElement *_root,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void CreateCollision(tinyxml2::XMLElement* _elem,
+void CreateCollision(URDF2SDFPrivate &_conversion, tinyxml2::XMLElement* _elem,
                      urdf::LinkConstSharedPtr _link,
                      urdf::CollisionSharedPtr _collision,
                      const std::string &_oldLinkName)
@@ -3127,7 +3386,7 @@ void CreateCollision(tinyxml2::XMLElement* _elem,
   else
   {
     sdfCollision->SetAttribute("name", (_link->name
-        + g_lumpPrefix + _oldLinkName).c_str());
+        + _conversion.lumpPrefix + _oldLinkName).c_str());
   }
 
   // std::cerr << "collision [" << sdfCollision->Attribute("name") << "]\n";
@@ -3152,14 +3411,15 @@ void CreateCollision(tinyxml2::XMLElement* _elem,
   }
 
   // set additional data from extensions
-  InsertSDFExtensionCollision(sdfCollision, _link->name);
+  InsertSDFExtensionCollision(_conversion, sdfCollision, _link->name);
 
   // add geometry to body
   _elem->LinkEndChild(sdfCollision);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void CreateVisual(tinyxml2::XMLElement *_elem, urdf::LinkConstSharedPtr _link,
+void CreateVisual(URDF2SDFPrivate &_conversion,
+                  tinyxml2::XMLElement *_elem, urdf::LinkConstSharedPtr _link,
     urdf::VisualSharedPtr _visual, const std::string &_oldLinkName)
 {
   auto* doc = _elem->GetDocument();
@@ -3175,7 +3435,7 @@ void CreateVisual(tinyxml2::XMLElement *_elem, urdf::LinkConstSharedPtr _link,
   else
   {
     sdfVisual->SetAttribute("name",
-        (_link->name + g_lumpPrefix + _oldLinkName).c_str());
+        (_link->name + _conversion.lumpPrefix + _oldLinkName).c_str());
   }
 
   // add the visualisation transfrom
@@ -3198,7 +3458,7 @@ void CreateVisual(tinyxml2::XMLElement *_elem, urdf::LinkConstSharedPtr _link,
   }
 
   // set additional data from extensions
-  InsertSDFExtensionVisual(sdfVisual, _link->name);
+  InsertSDFExtensionVisual(_conversion, sdfVisual, _link->name);
 
   // end create _visual node
   _elem->LinkEndChild(sdfVisual);
@@ -3209,7 +3469,29 @@ void URDF2SDF::InitModelString(const std::string &_urdfStr,
                                tinyxml2::XMLDocument* _sdfXmlOut,
                                bool _enforceLimits)
 {
-  g_enforceLimits = _enforceLimits;
+  // A string that isn't well formed XML is reported by InitModelParsed,
+  // since parseURDF rejects it first.
+  tinyxml2::XMLDocument urdfXml;
+  urdfXml.Parse(_urdfStr.c_str());
+  this->InitModelParsed(_urdfStr, urdfXml, _sdfXmlOut, _enforceLimits);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool URDF2SDF::InitModelParsed(const std::string &_urdfStr,
+                               tinyxml2::XMLDocument &_urdfXml,
+                               tinyxml2::XMLDocument *_sdfXmlOut,
+                               bool _enforceLimits)
+{
+  // default options
+  this->dataPtr->enforceLimits = _enforceLimits;
+  this->dataPtr->reduceFixedJoints = true;
+  this->dataPtr->extensions.clear();
+  this->dataPtr->collisionExt = "_collision";
+  this->dataPtr->visualExt = "_visual";
+  this->dataPtr->lumpPrefix = "_fixed_joint_lump__";
+  this->dataPtr->initialRobotPoseValid = false;
+  this->dataPtr->fixedJointsTransformedInRevoluteJoints.clear();
+  this->dataPtr->fixedJointsTransformedInFixedJoints.clear();
 
   // Create a RobotModel from string
   urdf::ModelInterfaceSharedPtr robotModel = urdf::parseURDF(_urdfStr);
@@ -3217,7 +3499,7 @@ void URDF2SDF::InitModelString(const std::string &_urdfStr,
   if (!robotModel)
   {
     sdferr << "Unable to call parseURDF on robot model\n";
-    return;
+    return false;
   }
 
   // create root element and define needed namespaces
@@ -3231,19 +3513,15 @@ void URDF2SDF::InitModelString(const std::string &_urdfStr,
   ignition::math::Pose3d transform;
 
   // parse sdf extension
-  tinyxml2::XMLDocument urdfXml;
-  if (urdfXml.Parse(_urdfStr.c_str()))
+  if (_urdfXml.Error())
   {
-    sdferr << "Unable to parse URDF string: " << urdfXml.ErrorStr() << "\n";
-    return;
+    sdferr << "Unable to parse URDF string: " << _urdfXml.ErrorStr() << "\n";
+    return false;
   }
-  g_extensions.clear();
-  g_fixedJointsTransformedInFixedJoints.clear();
-  g_fixedJointsTransformedInRevoluteJoints.clear();
-  this->ParseSDFExtension(urdfXml);
+  this->ParseSDFExtension(_urdfXml);
 
   // Parse robot pose
-  ParseRobotOrigin(urdfXml);
+  ParseRobotOrigin(*this->dataPtr, _urdfXml);
 
   urdf::LinkConstSharedPtr rootLink = robotModel->getRoot();
   tinyxml2::XMLElement *sdf;
@@ -3260,9 +3538,10 @@ void URDF2SDF::InitModelString(const std::string &_urdfStr,
     // parent link recursively
     // using the disabledFixedJointLumping or preserveFixedJoint options
     // is possible to disable fixed joint lumping only for selected joints
-    if (g_reduceFixedJoints)
+    if (this->dataPtr->reduceFixedJoints)
     {
-      ReduceFixedJoints(robot, urdf::const_pointer_cast<urdf::Link>(rootLink));
+      ReduceFixedJoints(*this->dataPtr, robot,
+                        urdf::const_pointer_cast<urdf::Link>(rootLink));
     }
 
     if (rootLink->name == "world")
@@ -3272,19 +3551,19 @@ void URDF2SDF::InitModelString(const std::string &_urdfStr,
           child = rootLink->child_links.begin();
           child != rootLink->child_links.end(); ++child)
       {
-        CreateSDF(robot, (*child), transform);
+        CreateSDF(*this->dataPtr, robot, (*child), transform);
       }
     }
     else
     {
       // convert, starting from root link
-      CreateSDF(robot, rootLink, transform);
+      CreateSDF(*this->dataPtr, robot, rootLink, transform);
     }
 
     // insert the extensions without reference into <robot> root level
-    InsertSDFExtensionRobot(robot);
+    InsertSDFExtensionRobot(*this->dataPtr, robot);
 
-    InsertRobotOrigin(robot);
+    InsertRobotOrigin(*this->dataPtr, robot);
 
     // Create new sdf
     sdf = _sdfXmlOut->NewElement("sdf");
@@ -3308,26 +3587,38 @@ void URDF2SDF::InitModelString(const std::string &_urdfStr,
   }
 
   _sdfXmlOut->LinkEndChild(sdf);
+  return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void URDF2SDF::InitModelDoc(const tinyxml2::XMLDocument *_xmlDoc,
                             tinyxml2::XMLDocument *_sdfXmlDoc)
 {
+  // parseURDF only takes a string, but the extensions are read from a copy
+  // of the document, which is cheaper than parsing the string again.
   tinyxml2::XMLPrinter printer;
   _xmlDoc->Print(&printer);
   std::string urdfStr = printer.CStr();
-  InitModelString(urdfStr, _sdfXmlDoc);
+
+  tinyxml2::XMLDocument urdfXml;
+  const tinyxml2::XMLElement *robotXml = _xmlDoc->FirstChildElement("robot");
+  if (robotXml)
+  {
+    urdfXml.InsertEndChild(DeepClone(&urdfXml, robotXml));
+  }
+  this->InitModelParsed(urdfStr, urdfXml, _sdfXmlDoc);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void URDF2SDF::InitModelFile(const std::string &_filename,
                              tinyxml2::XMLDocument *_sdfXmlDoc)
 {
+  std::string urdfStr;
   tinyxml2::XMLDocument xmlDoc;
-  if (!xmlDoc.LoadFile(_filename.c_str()))
+  if (ReadFileToString(_filename, urdfStr) &&
+      !xmlDoc.Parse(urdfStr.c_str(), urdfStr.size()))
   {
-    this->InitModelDoc(&xmlDoc, _sdfXmlDoc);
+    this->InitModelParsed(urdfStr, xmlDoc, _sdfXmlDoc);
   }
   else
   {
@@ -3337,16 +3628,19 @@ void URDF2SDF::InitModelFile(const std::string &_filename,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-bool FixedJointShouldBeReduced(urdf::JointSharedPtr _jnt)
+bool FixedJointShouldBeReduced(URDF2SDFPrivate &_conversion,
+                               urdf::JointSharedPtr _jnt)
 {
     // A joint should be lumped only if its type is fixed and
     // the disabledFixedJointLumping or preserveFixedJoint
     // joint options are not set
     return (_jnt->type == urdf::Joint::FIXED &&
-              (g_fixedJointsTransformedInRevoluteJoints.find(_jnt->name) ==
-                 g_fixedJointsTransformedInRevoluteJoints.end()) &&
-              (g_fixedJointsTransformedInFixedJoints.find(_jnt->name) ==
-                 g_fixedJointsTransformedInFixedJoints.end()));
+              (_conversion.fixedJointsTransformedInRevoluteJoints.find(
+                   _jnt->name) ==
+                 _conversion.fixedJointsTransformedInRevoluteJoints.end()) &&
+              (_conversion.fixedJointsTransformedInFixedJoints.find(
+                   _jnt->name) ==
+                 _conversion.fixedJointsTransformedInFixedJoints.end()));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3392,13 +3686,11 @@ void ReduceSDFExtensionSensorTransformReduction(
     reductionQ.getRPY(reductionRpy.x, reductionRpy.y, reductionRpy.z);
 
     // output updated pose to text
-    std::ostringstream poseStream;
-    poseStream << reductionXyz.x << " " << reductionXyz.y
-               << " " << reductionXyz.z << " " << reductionRpy.x
-               << " " << reductionRpy.y << " " << reductionRpy.z;
+    const double pose[6] = {reductionXyz.x, reductionXyz.y, reductionXyz.z,
+                            reductionRpy.x, reductionRpy.y, reductionRpy.z};
 
     auto* doc = (*_blobIt)->GetDocument();
-    tinyxml2::XMLText *poseTxt = doc->NewText(poseStream.str().c_str());
+    tinyxml2::XMLText *poseTxt = doc->NewText(Values2str(6, pose).c_str());
     tinyxml2::XMLElement *poseKey = doc->NewElement("pose");
 
     poseKey->LinkEndChild(poseTxt);
@@ -3449,13 +3741,11 @@ void ReduceSDFExtensionProjectorTransformReduction(
     reductionQ.getRPY(reductionRpy.x, reductionRpy.y, reductionRpy.z);
 
     // output updated pose to text
-    std::ostringstream poseStream;
-    poseStream << reductionXyz.x << " " << reductionXyz.y
-               << " " << reductionXyz.z << " " << reductionRpy.x
-               << " " << reductionRpy.y << " " << reductionRpy.z;
+    const double pose[6] = {reductionXyz.x, reductionXyz.y, reductionXyz.z,
+                            reductionRpy.x, reductionRpy.y, reductionRpy.z};
 
     auto* doc = (*_blobIt)->GetDocument();
-    tinyxml2::XMLText *poseTxt = doc->NewText(poseStream.str().c_str());
+    tinyxml2::XMLText *poseTxt = doc->NewText(Values2str(6, pose).c_str());
     poseKey = doc->NewElement("pose");
     poseKey->LinkEndChild(poseTxt);
 
@@ -3465,6 +3755,7 @@ void ReduceSDFExtensionProjectorTransformReduction(
 
 ////////////////////////////////////////////////////////////////////////////////
 void ReduceSDFExtensionContactSensorFrameReplace(
+    URDF2SDFPrivate &_conversion,
     std::vector<XMLDocumentPtr>::iterator _blobIt,
     urdf::LinkSharedPtr _link)
 {
@@ -3481,14 +3772,14 @@ void ReduceSDFExtensionContactSensorFrameReplace(
       if (collision)
       {
         if (GetKeyValueAsString(collision->ToElement()) ==
-            linkName + g_collisionExt)
+            linkName + _conversion.collisionExt)
         {
           contact->DeleteChild(collision);
 
           auto* doc = contact->GetDocument();
           tinyxml2::XMLElement *collisionNameKey = doc->NewElement("collision");
           std::ostringstream collisionNameStream;
-          collisionNameStream << parentLinkName << g_collisionExt
+          collisionNameStream << parentLinkName << _conversion.collisionExt
                               << "_" << linkName;
           tinyxml2::XMLText *collisionNameTxt = doc->NewText(
               collisionNameStream.str().c_str());
@@ -3506,12 +3797,12 @@ void ReduceSDFExtensionContactSensorFrameReplace(
 ////////////////////////////////////////////////////////////////////////////////
 void ReduceSDFExtensionPluginFrameReplace(
     std::vector<XMLDocumentPtr>::iterator _blobIt,
-    urdf::LinkSharedPtr _link,
+    urdf::LinkSharedPtr _link, urdf::LinkSharedPtr _target,
     const std::string &_pluginName, const std::string &_elementName,
     ignition::math::Pose3d _reductionTransform)
 {
   std::string linkName = _link->name;
-  std::string parentLinkName = _link->getParent()->name;
+  std::string parentLinkName = _target->name;
   if ((*_blobIt)->FirstChildElement()->Name() == _pluginName)
   {
     // replace element containing _link names to parent link names
@@ -3554,9 +3845,14 @@ void ReduceSDFExtensionPluginFrameReplace(
           (*_blobIt)->DeleteChild(rpyKey);
         }
 
-        // pass through the parent transform from fixed joint reduction
-        _reductionTransform = inverseTransformToParentFrame(_reductionTransform,
-            _link->parent_joint->parent_to_joint_origin_transform);
+        // pass through the parent transforms from fixed joint reduction
+        for (urdf::LinkSharedPtr link = _link; link != _target;
+             link = link->getParent())
+        {
+          _reductionTransform = inverseTransformToParentFrame(
+              _reductionTransform,
+              link->parent_joint->parent_to_joint_origin_transform);
+        }
 
         // create new offset xml blocks
         xyzKey = doc->NewElement("xyzOffset");
@@ -3571,16 +3867,13 @@ void ReduceSDFExtensionPluginFrameReplace(
                                   _reductionTransform.Rot().Z(),
                                   _reductionTransform.Rot().W());
 
-        std::ostringstream xyzStream, rpyStream;
-        xyzStream << reductionXyz.x << " " << reductionXyz.y << " "
-                  << reductionXyz.z;
         urdf::Vector3 reductionRpy;
         reductionQ.getRPY(reductionRpy.x, reductionRpy.y, reductionRpy.z);
-        rpyStream << reductionRpy.x << " " << reductionRpy.y << " "
-                  << reductionRpy.z;
 
-        tinyxml2::XMLText *xyzTxt = doc->NewText(xyzStream.str().c_str());
-        tinyxml2::XMLText *rpyTxt = doc->NewText(rpyStream.str().c_str());
+        tinyxml2::XMLText *xyzTxt =
+          doc->NewText(Vector32Str(reductionXyz).c_str());
+        tinyxml2::XMLText *rpyTxt =
+          doc->NewText(Vector32Str(reductionRpy).c_str());
 
         xyzKey->LinkEndChild(xyzTxt);
         rpyKey->LinkEndChild(rpyTxt);
@@ -3595,10 +3888,10 @@ void ReduceSDFExtensionPluginFrameReplace(
 ////////////////////////////////////////////////////////////////////////////////
 void ReduceSDFExtensionProjectorFrameReplace(
     std::vector<XMLDocumentPtr>::iterator _blobIt,
-    urdf::LinkSharedPtr _link)
+    urdf::LinkSharedPtr _link, urdf::LinkSharedPtr _target)
 {
   std::string linkName = _link->name;
-  std::string parentLinkName = _link->getParent()->name;
+  std::string parentLinkName = _target->name;
 
   // updates _link reference for <projector> inside of
   // projector plugins
@@ -3645,10 +3938,10 @@ void ReduceSDFExtensionProjectorFrameReplace(
 ////////////////////////////////////////////////////////////////////////////////
 void ReduceSDFExtensionGripperFrameReplace(
     std::vector<XMLDocumentPtr>::iterator _blobIt,
-    urdf::LinkSharedPtr _link)
+    urdf::LinkSharedPtr _link, urdf::LinkSharedPtr _target)
 {
   std::string linkName = _link->name;
-  std::string parentLinkName = _link->getParent()->name;
+  std::string parentLinkName = _target->name;
 
   if (strcmp((*_blobIt)->FirstChildElement()->Name(), "gripper") == 0)
   {
@@ -3692,10 +3985,10 @@ void ReduceSDFExtensionGripperFrameReplace(
 ////////////////////////////////////////////////////////////////////////////////
 void ReduceSDFExtensionJointFrameReplace(
     std::vector<XMLDocumentPtr>::iterator _blobIt,
-    urdf::LinkSharedPtr _link)
+    urdf::LinkSharedPtr _link, urdf::LinkSharedPtr _target)
 {
   std::string linkName = _link->name;
-  std::string parentLinkName = _link->getParent()->name;
+  std::string parentLinkName = _target->name;
   auto* doc = (*_blobIt)->GetDocument();
 
   if (strcmp((*_blobIt)->FirstChildElement()->Name(), "joint") == 0)
@@ -20,6 +20,7 @@
 #include <tinyxml2.h>
 #include <sdf/sdf_config.h>
 
+#include <memory>
 #include <string>
 
 #include "sdf/Console.hh"
@@ -32,11 +33,17 @@ namespace sdf
   inline namespace SDF_VERSION_NAMESPACE {
   //
 
+  // Forward declare private data class.
+  class URDF2SDFPrivate;
+
   /// \brief URDF to SDF converter
   ///
   /// This is now deprecated for external usage and will be removed in the next
   /// major version of libsdformat. Instead, consider using `sdf::readFile` or
   /// `sdf::readString`, which automatically convert URDF to SDF.
+  ///
+  /// Each instance keeps its own conversion state, so different instances
+  /// can convert on different threads at the same time.
   class URDF2SDF
   {
     /// \brief constructor
@@ -66,6 +73,20 @@ namespace sdf
                                  tinyxml2::XMLDocument *_sdfXmlDoc,
                                  bool _enforceLimits = true);
 
+    /// \brief convert a urdf string that was already parsed to sdf xml
+    /// document. The <gazebo> extensions are read from the parsed document,
+    /// so the string isn't parsed again for them. Errors are reported like
+    /// InitModelString does.
+    /// \param[in] _urdfStr a string containing model urdf
+    /// \param[in] _urdfXml _urdfStr parsed by TinyXML2.
+    /// \param[inout] _sdfXmlDoc document to populate with the sdf model.
+    /// \param[in] _enforceLimits option to enforce joint limits
+    /// \return True if _urdfStr is a URDF model and was converted.
+    public: bool InitModelParsed(const std::string &_urdfStr,
+                                 tinyxml2::XMLDocument &_urdfXml,
+                                 tinyxml2::XMLDocument *_sdfXmlDoc,
+                                 bool _enforceLimits = true);
+
     /// \brief Return true if the filename is a URDF model.
     /// \param[in] _filename File to check.
     /// \return True if _filename is a URDF model.
@@ -80,6 +101,9 @@ namespace sdf
     /// things that do not belong in urdf but should be mapped into sdf
     /// @todo: do this using sdf definitions, not hard coded stuff
     private: void ParseSDFExtension(tinyxml2::XMLDocument &_urdfXml);
+
+    /// \brief Private data pointer.
+    private: std::unique_ptr<URDF2SDFPrivate> dataPtr;
   };
   }
 }
@@ -852,6 +852,49 @@ TEST(URDFParser, OutputPrecision)
   EXPECT_EQ("0", poseValues[5]);
 }
 
+/////////////////////////////////////////////////
+TEST(URDFParser, MeshScalePrecision)
+{
+  std::string str = R"(
+    <robot name='test_robot'>
+      <link name='link1'>
+        <inertial>
+          <mass value="1.0" />
+          <inertia ixx="1" ixy="0" ixz="0" iyy="1" iyz="0" izz="1" />
+        </inertial>
+        <visual>
+          <geometry>
+            <mesh filename="package://robot/mesh.dae"
+                  scale="0.123456789123456 -0.0 2"/>
+          </geometry>
+        </visual>
+      </link>
+    </robot>)";
+
+  sdf::URDF2SDF parser;
+  tinyxml2::XMLDocument sdfResult;
+  parser.InitModelString(str, &sdfResult);
+
+  auto root = sdfResult.RootElement();
+  auto model = root->FirstChildElement("model");
+  ASSERT_NE(nullptr, model);
+  auto link = model->FirstChildElement("link");
+  ASSERT_NE(nullptr, link);
+  auto visual = link->FirstChildElement("visual");
+  ASSERT_NE(nullptr, visual);
+  auto geometry = visual->FirstChildElement("geometry");
+  ASSERT_NE(nullptr, geometry);
+  auto mesh = geometry->FirstChildElement("mesh");
+  ASSERT_NE(nullptr, mesh);
+  auto scale = mesh->FirstChildElement("scale");
+  ASSERT_NE(nullptr, scale);
+  ASSERT_NE(nullptr, scale->FirstChild());
+
+  // The scale is written with the same precision as poses, and 0 doesn't
+  // get printed as -0
+  EXPECT_EQ("0.123456789123456 0 2", std::string(scale->FirstChild()->Value()));
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
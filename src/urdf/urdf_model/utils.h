@@ -37,7 +37,11 @@
 #ifndef URDF_INTERFACE_UTILS_H
 #define URDF_INTERFACE_UTILS_H
 
+#include <cctype>
+#include <charconv>
+#include <stdexcept>
 #include <string>
+#include <system_error>
 #include <vector>
 
 namespace urdf {
@@ -62,6 +66,64 @@ void split_string(std::vector<std::string> &result,
   }
 }
 
+// Replacement for std::stod and std::stof that doesn't depend on the C
+// locale, which may use a decimal comma. Like them, leading whitespace is
+// skipped, characters after the number are ignored, and
+// std::invalid_argument or std::out_of_range is thrown on failure.
+template <typename T>
+T strToFloatingPoint(const std::string &input)
+{
+  const char *first = input.data();
+  const char *last = first + input.size();
+  while (first != last && std::isspace(static_cast<unsigned char>(*first)))
+  {
+    ++first;
+  }
+
+  // std::from_chars accepts neither a plus sign nor a "0x" prefix
+  bool negative = false;
+  if (first != last && (*first == '+' || *first == '-'))
+  {
+    negative = *first == '-';
+    ++first;
+  }
+
+  T value = 0;
+  std::from_chars_result result{first, std::errc::invalid_argument};
+  if (last - first > 2 && first[0] == '0' &&
+      (first[1] == 'x' || first[1] == 'X'))
+  {
+    result = std::from_chars(first + 2, last, value, std::chars_format::hex);
+  }
+  if (result.ec == std::errc::invalid_argument &&
+      first != last && *first != '+' && *first != '-')
+  {
+    result = std::from_chars(first, last, value);
+  }
+
+  if (result.ec == std::errc::invalid_argument)
+  {
+    throw std::invalid_argument("no conversion of [" + input + "]");
+  }
+  if (result.ec == std::errc::result_out_of_range)
+  {
+    throw std::out_of_range("[" + input + "] is out of range");
+  }
+  return negative ? -value : value;
+}
+
+inline
+double strToDouble(const std::string &input)
+{
+  return strToFloatingPoint<double>(input);
+}
+
+inline
+float strToFloat(const std::string &input)
+{
+  return strToFloatingPoint<float>(input);
+}
+
 }
 
 #endif
@@ -15,6 +15,13 @@
  *
  */
 
+#ifndef _WIN32
+#include <sys/stat.h>
+#else
+#include <direct.h>
+#endif
+
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <gtest/gtest.h>
@@ -44,6 +51,45 @@ std::string findFileCb(const std::string &_input)
   return sdf::filesystem::append(g_testPath, "integration", "model", _input);
 }
 
+/////////////////////////////////////////////////
+/// \brief Sets the include thread count, and restores the previous one
+/// when it goes out of scope.
+class IncludeThreadCountGuard
+{
+  public: explicit IncludeThreadCountGuard(unsigned int _threadCount)
+    : previous(sdf::includeThreadCount())
+  {
+    sdf::setIncludeThreadCount(_threadCount);
+  }
+
+  public: ~IncludeThreadCountGuard()
+  {
+    sdf::setIncludeThreadCount(this->previous);
+  }
+
+  private: unsigned int previous;
+};
+
+/////////////////////////////////////////////////
+/// \brief Sets the include cache size, and restores the previous one and
+/// clears the cache when it goes out of scope.
+class IncludeCacheSizeGuard
+{
+  public: explicit IncludeCacheSizeGuard(std::size_t _maxEntries)
+    : previous(sdf::includeCacheSize())
+  {
+    sdf::setIncludeCacheSize(_maxEntries);
+  }
+
+  public: ~IncludeCacheSizeGuard()
+  {
+    sdf::setIncludeCacheSize(this->previous);
+    sdf::clearIncludeCache();
+  }
+
+  private: std::size_t previous;
+};
+
 //////////////////////////////////////////////////
 TEST(IncludesTest, Includes)
 {
@@ -318,3 +364,212 @@ TEST(IncludesTest, Includes_15_convert)
   EXPECT_EQ("1.6", modelElem->OriginalVersion());
   EXPECT_EQ("1.6", linkElem->OriginalVersion());
 }
+
+//////////////////////////////////////////////////
+TEST(IncludesTest, ParallelIncludes)
+{
+  sdf::setFindCallback(findFileCb);
+
+  const auto worldFile =
+    sdf::filesystem::append(g_testPath, "sdf", "includes.sdf");
+
+  EXPECT_EQ(1u, sdf::includeThreadCount());
+  sdf::Root serialRoot;
+  EXPECT_TRUE(serialRoot.Load(worldFile).empty());
+
+  sdf::Root parallelRoot;
+  {
+    IncludeThreadCountGuard guard(4);
+    EXPECT_EQ(4u, sdf::includeThreadCount());
+    EXPECT_TRUE(parallelRoot.Load(worldFile).empty());
+  }
+  EXPECT_EQ(1u, sdf::includeThreadCount());
+
+  // Zero selects the serial default
+  {
+    IncludeThreadCountGuard guard(0);
+    EXPECT_EQ(1u, sdf::includeThreadCount());
+  }
+
+  ASSERT_NE(nullptr, serialRoot.Element());
+  ASSERT_NE(nullptr, parallelRoot.Element());
+  EXPECT_EQ(serialRoot.Element()->ToString(""),
+            parallelRoot.Element()->ToString(""));
+}
+
+//////////////////////////////////////////////////
+TEST(IncludesTest, ParallelIncludesOrder)
+{
+  sdf::setFindCallback(findFileCb);
+
+  // Many includes, some of which can't be found
+  std::ostringstream stream;
+  stream << "<sdf version='" << SDF_VERSION << "'>"
+         << "<world name='default'>";
+  const int includeCount = 40;
+  for (int i = 0; i < includeCount; ++i)
+  {
+    stream << "<include>"
+           << "  <uri>" << (i % 10 == 5 ? "missing_model" : "test_model")
+           << "</uri>"
+           << "  <name>model_" << i << "</name>"
+           << "  <pose>" << i << " 0 0 0 0 0</pose>"
+           << "</include>";
+    if (i % 7 == 0)
+    {
+      stream << "<model name='inline_" << i << "'>"
+             << "  <link name='link'/>"
+             << "</model>";
+    }
+  }
+  stream << "</world></sdf>";
+
+  sdf::Root serialRoot;
+  sdf::Errors serialErrors = serialRoot.LoadSdfString(stream.str());
+
+  sdf::Root parallelRoot;
+  sdf::Errors parallelErrors;
+  {
+    IncludeThreadCountGuard guard(8);
+    parallelErrors = parallelRoot.LoadSdfString(stream.str());
+  }
+
+  ASSERT_FALSE(serialErrors.empty());
+  ASSERT_EQ(serialErrors.size(), parallelErrors.size());
+  for (std::size_t i = 0; i < serialErrors.size(); ++i)
+  {
+    EXPECT_EQ(serialErrors[i].Code(), parallelErrors[i].Code());
+    EXPECT_EQ(serialErrors[i].Message(), parallelErrors[i].Message());
+  }
+
+  const sdf::World *serialWorld = serialRoot.WorldByIndex(0);
+  const sdf::World *parallelWorld = parallelRoot.WorldByIndex(0);
+  ASSERT_NE(nullptr, serialWorld);
+  ASSERT_NE(nullptr, parallelWorld);
+  ASSERT_EQ(serialWorld->ModelCount(), parallelWorld->ModelCount());
+  for (uint64_t i = 0; i < serialWorld->ModelCount(); ++i)
+  {
+    EXPECT_EQ(serialWorld->ModelByIndex(i)->Name(),
+              parallelWorld->ModelByIndex(i)->Name());
+    EXPECT_EQ(serialWorld->ModelByIndex(i)->RawPose(),
+              parallelWorld->ModelByIndex(i)->RawPose());
+  }
+  EXPECT_EQ(serialRoot.Element()->ToString(""),
+            parallelRoot.Element()->ToString(""));
+}
+
+//////////////////////////////////////////////////
+TEST(IncludesTest, IncludeCache)
+{
+  sdf::setFindCallback(findFileCb);
+
+  const auto worldFile =
+    sdf::filesystem::append(g_testPath, "sdf", "includes.sdf");
+
+  // The cache is disabled by default
+  EXPECT_EQ(0u, sdf::includeCacheSize());
+  sdf::Root uncachedRoot;
+  EXPECT_TRUE(uncachedRoot.Load(worldFile).empty());
+
+  // The first load fills the cache and the second one uses it
+  IncludeCacheSizeGuard guard(100);
+  EXPECT_EQ(100u, sdf::includeCacheSize());
+  sdf::clearIncludeCache();
+  sdf::Root firstRoot;
+  EXPECT_TRUE(firstRoot.Load(worldFile).empty());
+  sdf::Root cachedRoot;
+  EXPECT_TRUE(cachedRoot.Load(worldFile).empty());
+
+  ASSERT_NE(nullptr, uncachedRoot.Element());
+  ASSERT_NE(nullptr, firstRoot.Element());
+  ASSERT_NE(nullptr, cachedRoot.Element());
+  EXPECT_EQ(uncachedRoot.Element()->ToString(""),
+            firstRoot.Element()->ToString(""));
+  EXPECT_EQ(uncachedRoot.Element()->ToString(""),
+            cachedRoot.Element()->ToString(""));
+
+  // Included elements keep the path of the file they were read from
+  const sdf::World *world = cachedRoot.WorldByIndex(0);
+  ASSERT_NE(nullptr, world);
+  const sdf::Model *model = world->ModelByIndex(0);
+  ASSERT_NE(nullptr, model);
+  EXPECT_EQ(
+      sdf::filesystem::append(g_modelsPath, "test_model", "model.sdf"),
+      model->Element()->FilePath());
+}
+
+//////////////////////////////////////////////////
+/// \brief Write a model with a single link to a directory.
+void writeModel(const std::string &_modelPath, const std::string &_linkName)
+{
+  std::ofstream config(sdf::filesystem::append(_modelPath, "model.config"));
+  config << "<?xml version='1.0'?>"
+         << "<model>"
+         << "  <name>cache_test</name>"
+         << "  <sdf version='" << SDF_VERSION << "'>model.sdf</sdf>"
+         << "</model>";
+
+  std::ofstream model(sdf::filesystem::append(_modelPath, "model.sdf"));
+  model << "<?xml version='1.0'?>"
+        << "<sdf version='" << SDF_VERSION << "'>"
+        << "  <model name='cache_test'>"
+        << "    <link name='" << _linkName << "'/>"
+        << "  </model>"
+        << "</sdf>";
+}
+
+//////////////////////////////////////////////////
+TEST(IncludesTest, IncludeCacheModifiedFile)
+{
+  const std::string modelPath =
+      sdf::filesystem::append(PROJECT_BINARY_DIR, "include_cache_model");
+#ifndef _WIN32
+  mkdir(modelPath.c_str(), 0755);
+#else
+  _mkdir(modelPath.c_str());
+#endif
+  ASSERT_TRUE(sdf::filesystem::is_directory(modelPath));
+
+  IncludeCacheSizeGuard guard(100);
+  sdf::setFindCallback([modelPath](const std::string &)
+  {
+    return modelPath;
+  });
+
+  const std::string worldString =
+      "<sdf version='" SDF_VERSION "'>"
+      "  <world name='default'>"
+      "    <include><uri>model://cache_test</uri></include>"
+      "  </world>"
+      "</sdf>";
+
+  auto linkName = [&]() -> std::string
+  {
+    sdf::Root root;
+    EXPECT_TRUE(root.LoadSdfString(worldString).empty());
+    const sdf::World *world = root.WorldByIndex(0);
+    if (!world || world->ModelCount() != 1u ||
+        world->ModelByIndex(0)->LinkCount() != 1u)
+    {
+      return "";
+    }
+    return world->ModelByIndex(0)->LinkByIndex(0)->Name();
+  };
+
+  writeModel(modelPath, "link_a");
+  EXPECT_EQ("link_a", linkName());
+  EXPECT_EQ("link_a", linkName());
+
+  // A longer name changes the size of the file, so the change is detected
+  // even if the modification time has a coarse resolution.
+  writeModel(modelPath, "link_abc");
+  EXPECT_EQ("link_abc", linkName());
+
+  // Changing the find callback clears the cache
+  writeModel(modelPath, "link_xyz");
+  sdf::setFindCallback([modelPath](const std::string &)
+  {
+    return modelPath;
+  });
+  EXPECT_EQ("link_xyz", linkName());
+}
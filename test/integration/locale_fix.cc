@@ -31,30 +31,47 @@ const std::string SDF_TEST_FILE =
 // Windows supports the setlocale call but we can not extract the
 // available locales using the Linux call
 #ifndef _MSC_VER
-TEST(CheckFixForLocal, MakeTestToFail)
+/////////////////////////////////////////////////
+/// \brief Get a locale whose decimal separator is a comma.
+/// \return Name of the locale, or an empty string if none is available.
+std::string latinLocale()
 {
   // Check if any of the latin locales is avilable
   FILE *fp = popen("locale -a | grep '^es\\|^pt_\\|^it_' | head -n 1", "r");
 
   if (!fp)
   {
-    FAIL() << "locale -a call failed";
-    return;
+    return "";
   }
 
   char buffer[1024];
   char *line = fgets(buffer, sizeof(buffer), fp);
   pclose(fp);
 
-  // Do not run test if not available
   if (!line)
+  {
+    return "";
+  }
+
+  std::string name = line;
+  name.erase(name.find_last_not_of(" \n") + 1);
+  return name;
+}
+
+/////////////////////////////////////////////////
+TEST(CheckFixForLocal, MakeTestToFail)
+{
+  const std::string locale = latinLocale();
+
+  // Do not run test if not available
+  if (locale.empty())
   {
     std::cout << "No latin locale available. Skip test" << std::endl;
     SUCCEED();
     return;
   }
 
-  setlocale(LC_NUMERIC, line);
+  ASSERT_NE(nullptr, setlocale(LC_NUMERIC, locale.c_str()));
 
   // fix to allow make test without make install
   sdf::SDFPtr p(new sdf::SDF());
@@ -79,5 +96,91 @@ TEST(CheckFixForLocal, MakeTestToFail)
   double tmp = 0.0;
   ASSERT_TRUE(param.Get<double>(tmp));
   ASSERT_DOUBLE_EQ(1.5, tmp);
+
+  setlocale(LC_NUMERIC, "C");
+}
+
+/////////////////////////////////////////////////
+TEST(CheckFixForLocal, Urdf)
+{
+  const std::string locale = latinLocale();
+
+  // Do not run test if not available
+  if (locale.empty())
+  {
+    std::cout << "No latin locale available. Skip test" << std::endl;
+    SUCCEED();
+    return;
+  }
+
+  const std::string urdfString =
+    "<robot name='locale'>"
+    "  <link name='base'>"
+    "    <inertial>"
+    "      <origin xyz='0.25 0 0'/>"
+    "      <mass value='0.5'/>"
+    "      <inertia ixx='0.5' ixy='0' ixz='0' iyy='0.5' iyz='0' izz='0.5'/>"
+    "    </inertial>"
+    "    <collision>"
+    "      <geometry><box size='0.5 1.5 2.5'/></geometry>"
+    "    </collision>"
+    "  </link>"
+    "  <link name='arm'>"
+    "    <inertial>"
+    "      <mass value='1.5'/>"
+    "      <inertia ixx='0.5' ixy='0' ixz='0' iyy='0.5' iyz='0' izz='0.5'/>"
+    "    </inertial>"
+    "  </link>"
+    "  <joint name='joint' type='revolute'>"
+    "    <parent link='base'/>"
+    "    <child link='arm'/>"
+    "    <origin xyz='0 0 0.75'/>"
+    "    <limit effort='2.5' velocity='0.5' lower='-0.5' upper='0.5'/>"
+    "    <dynamics damping='0.5'/>"
+    "  </joint>"
+    "  <gazebo reference='base'>"
+    "    <mu1>0.5</mu1>"
+    "  </gazebo>"
+    "</robot>";
+
+  ASSERT_NE(nullptr, setlocale(LC_NUMERIC, locale.c_str()));
+
+  sdf::Root root;
+  sdf::Errors errors = root.LoadSdfString(urdfString);
+  setlocale(LC_NUMERIC, "C");
+  EXPECT_TRUE(errors.empty());
+
+  const sdf::Model *model = root.ModelByIndex(0);
+  ASSERT_NE(nullptr, model);
+
+  const sdf::Link *base = model->LinkByName("base");
+  ASSERT_NE(nullptr, base);
+  EXPECT_DOUBLE_EQ(0.5, base->Inertial().MassMatrix().Mass());
+  EXPECT_DOUBLE_EQ(0.5, base->Inertial().MassMatrix().Ixx());
+  EXPECT_EQ(ignition::math::Vector3d(0.25, 0, 0),
+            base->Inertial().Pose().Pos());
+
+  const sdf::Collision *collision = base->CollisionByIndex(0);
+  ASSERT_NE(nullptr, collision);
+  ASSERT_NE(nullptr, collision->Geom()->BoxShape());
+  EXPECT_EQ(ignition::math::Vector3d(0.5, 1.5, 2.5),
+            collision->Geom()->BoxShape()->Size());
+  sdf::ElementPtr friction = collision->Element()->GetElement("surface")
+    ->GetElement("friction")->GetElement("ode");
+  EXPECT_DOUBLE_EQ(0.5, friction->Get<double>("mu"));
+
+  const sdf::Link *arm = model->LinkByName("arm");
+  ASSERT_NE(nullptr, arm);
+  EXPECT_EQ(ignition::math::Vector3d(0, 0, 0.75), arm->RawPose().Pos());
+
+  const sdf::Joint *joint = model->JointByName("joint");
+  ASSERT_NE(nullptr, joint);
+  const sdf::JointAxis *axis = joint->Axis(0);
+  ASSERT_NE(nullptr, axis);
+  EXPECT_DOUBLE_EQ(-0.5, axis->Lower());
+  EXPECT_DOUBLE_EQ(0.5, axis->Upper());
+  EXPECT_DOUBLE_EQ(2.5, axis->Effort());
+  EXPECT_DOUBLE_EQ(0.5, axis->MaxVelocity());
+  EXPECT_DOUBLE_EQ(0.5, axis->Damping());
 }
 #endif
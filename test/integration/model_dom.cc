@@ -15,6 +15,7 @@
  *
  */
 
+#include <map>
 #include <string>
 #include <gtest/gtest.h>
 
@@ -282,6 +283,197 @@ TEST(DOMLink, NestedModelPoseRelativeTo)
   EXPECT_EQ(nullptr, model->FrameByIndex(0));
 }
 
+/////////////////////////////////////////////////
+TEST(DOMModel, ResolveAllPoses)
+{
+  const std::string testFile =
+    sdf::filesystem::append(PROJECT_SOURCE_PATH, "test", "sdf",
+        "model_nested_model_relative_to.sdf");
+
+  // Load the SDF file
+  sdf::Root root;
+  EXPECT_TRUE(root.Load(testFile).empty());
+
+  using Pose = ignition::math::Pose3d;
+
+  const sdf::Model *model = root.ModelByIndex(0);
+  ASSERT_NE(nullptr, model);
+
+  // The poses are sorted by frame name, so the frames of each nested
+  // model follow the nested model frame
+  sdf::FramePoses poses;
+  EXPECT_TRUE(model->ResolveAllPoses(poses).empty());
+  ASSERT_EQ(8u, poses.size());
+  EXPECT_EQ("L", poses[0].first);
+  EXPECT_EQ(Pose::Zero, poses[0].second);
+  EXPECT_EQ("M1", poses[1].first);
+  EXPECT_EQ(Pose(1, 0, 0, 0, IGN_PI/2, 0), poses[1].second);
+  EXPECT_EQ("M1::L", poses[2].first);
+  EXPECT_EQ("M2", poses[3].first);
+  EXPECT_EQ(Pose(2, 0, 0, 0, 0, 0), poses[3].second);
+  EXPECT_EQ("M2::L", poses[4].first);
+  EXPECT_EQ("M3", poses[5].first);
+  EXPECT_EQ(Pose(1, 0, -3, 0, IGN_PI/2, 0), poses[5].second);
+  EXPECT_EQ("M3::L", poses[6].first);
+  EXPECT_EQ("__model__", poses[7].first);
+  EXPECT_EQ(Pose::Zero, poses[7].second);
+
+  // Frames of nested models are scoped, and match their semantic poses
+  for (std::size_t i = 1; i <= 3; ++i)
+  {
+    const std::string modelName = "M" + std::to_string(i);
+    Pose pose;
+    EXPECT_TRUE(model->ModelByName(modelName)->LinkByName("L")->
+        SemanticPose().Resolve(pose).empty());
+    EXPECT_EQ(poses[2 * i - 1].second * pose, poses[2 * i].second);
+  }
+
+  // Resolve the poses relative to another frame
+  EXPECT_TRUE(model->ResolveAllPoses(poses, "M3").empty());
+  ASSERT_EQ(8u, poses.size());
+  EXPECT_EQ("M1", poses[1].first);
+  EXPECT_EQ(Pose(-3, 0, 0, 0, 0, 0), poses[1].second);
+  EXPECT_EQ("M3", poses[5].first);
+  EXPECT_EQ(Pose::Zero, poses[5].second);
+  EXPECT_EQ("M3::L", poses[6].first);
+  EXPECT_EQ(Pose::Zero, poses[6].second);
+
+  EXPECT_TRUE(model->ResolveAllPoses(poses, "M1::L").empty());
+  EXPECT_EQ("M3::L", poses[6].first);
+  EXPECT_EQ(Pose(3, 0, 0, 0, 0, 0), poses[6].second);
+
+  // Unknown frame
+  sdf::Errors errors = model->ResolveAllPoses(poses, "invalid");
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::POSE_RELATIVE_TO_INVALID, errors[0].Code());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMModel, SetRawPoses)
+{
+  const std::string testFile =
+    sdf::filesystem::append(PROJECT_SOURCE_PATH, "test", "sdf",
+        "model_nested_model_relative_to.sdf");
+
+  // Load the SDF file
+  sdf::Root root;
+  EXPECT_TRUE(root.Load(testFile).empty());
+
+  using Pose = ignition::math::Pose3d;
+
+  const sdf::Model *model = root.ModelByIndex(0);
+  ASSERT_NE(nullptr, model);
+
+  // The copy shares the graphs of the model until its poses are set
+  sdf::Model copy(*model);
+  EXPECT_TRUE(copy.SetRawPoses({
+      {"L", Pose(1, 0, 0, 0, 0, 0)},
+      {"M1", Pose(0, 0, 1, 0, 0, 0)}}).empty());
+  EXPECT_EQ(Pose(1, 0, 0, 0, 0, 0), copy.LinkByName("L")->RawPose());
+  EXPECT_EQ(Pose(0, 0, 1, 0, 0, 0), copy.ModelByName("M1")->RawPose());
+
+  sdf::FramePoses poses;
+  EXPECT_TRUE(copy.ResolveAllPoses(poses).empty());
+  ASSERT_EQ(8u, poses.size());
+  EXPECT_EQ("L", poses[0].first);
+  EXPECT_EQ(Pose(1, 0, 0, 0, 0, 0), poses[0].second);
+  EXPECT_EQ("M1", poses[1].first);
+  EXPECT_EQ(Pose(0, 0, 1, 0, 0, 0), poses[1].second);
+  EXPECT_EQ("M2", poses[3].first);
+  EXPECT_EQ(Pose(2, 0, 0, 0, 0, 0), poses[3].second);
+  EXPECT_EQ("M3", poses[5].first);
+  EXPECT_EQ(Pose(3, 0, 1, 0, 0, 0), poses[5].second);
+  EXPECT_EQ("M3::L", poses[6].first);
+  EXPECT_EQ(Pose(3, 0, 1, 0, 0, 0), poses[6].second);
+
+  // The children of the copy use its updated graph
+  Pose pose;
+  EXPECT_TRUE(copy.ModelByName("M3")->SemanticPose().Resolve(
+      pose, "__model__").empty());
+  EXPECT_EQ(Pose(3, 0, 1, 0, 0, 0), pose);
+
+  // The original model keeps its poses
+  EXPECT_EQ(Pose::Zero, model->LinkByName("L")->RawPose());
+  EXPECT_TRUE(model->ResolveAllPoses(poses).empty());
+  ASSERT_EQ(8u, poses.size());
+  EXPECT_EQ(Pose::Zero, poses[0].second);
+  EXPECT_EQ(Pose(1, 0, 0, 0, IGN_PI/2, 0), poses[1].second);
+  EXPECT_EQ(Pose(1, 0, -3, 0, IGN_PI/2, 0), poses[5].second);
+  EXPECT_TRUE(model->ModelByName("M3")->SemanticPose().Resolve(
+      pose, "__model__").empty());
+  EXPECT_EQ(Pose(1, 0, -3, 0, IGN_PI/2, 0), pose);
+
+  // Unknown names are reported, and the other poses are still set
+  sdf::Errors errors = copy.SetRawPoses({
+      {"invalid", Pose::Zero},
+      {"M2", Pose(0, 2, 0, 0, 0, 0)}});
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::POSE_RELATIVE_TO_INVALID, errors[0].Code());
+  EXPECT_TRUE(copy.ResolveAllPoses(poses).empty());
+  EXPECT_EQ("M2", poses[3].first);
+  EXPECT_EQ(Pose(0, 2, 0, 0, 0, 0), poses[3].second);
+
+  // A model that wasn't loaded has no graph
+  sdf::Model empty;
+  errors = empty.SetRawPoses({{"L", Pose::Zero}});
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR, errors[0].Code());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMModel, SetRawPosesPlacementFrame)
+{
+  using Pose = ignition::math::Pose3d;
+
+  auto modelSdf = [](const std::string &_childPose)
+  {
+    return
+      "<sdf version='1.8'>"
+      "  <model name='parent'>"
+      "    <link name='L'/>"
+      "    <model name='child' placement_frame='P'>"
+      "      <pose>" + _childPose + "</pose>"
+      "      <link name='CL'/>"
+      "      <frame name='P'>"
+      "        <pose>0 0 1 0 0 1.5707963267948966</pose>"
+      "      </frame>"
+      "    </model>"
+      "  </model>"
+      "</sdf>";
+  };
+
+  sdf::Root root;
+  EXPECT_TRUE(root.LoadSdfString(modelSdf("1 0 0 0 0 0")).empty());
+  const sdf::Model *model = root.ModelByIndex(0);
+  ASSERT_NE(nullptr, model);
+
+  sdf::Root expectedRoot;
+  EXPECT_TRUE(expectedRoot.LoadSdfString(modelSdf("0 2 0 0 0 0")).empty());
+  const sdf::Model *expectedModel = expectedRoot.ModelByIndex(0);
+  ASSERT_NE(nullptr, expectedModel);
+
+  // The pose of a nested model is the pose of its placement frame, so the
+  // copy gets the same poses as a model loaded with the new pose
+  sdf::Model copy(*model);
+  EXPECT_TRUE(copy.SetRawPoses({{"child", Pose(0, 2, 0, 0, 0, 0)}}).empty());
+  EXPECT_EQ(expectedModel->ModelByName("child")->RawPose(),
+            copy.ModelByName("child")->RawPose());
+
+  sdf::FramePoses poses;
+  sdf::FramePoses expectedPoses;
+  EXPECT_TRUE(copy.ResolveAllPoses(poses).empty());
+  EXPECT_TRUE(expectedModel->ResolveAllPoses(expectedPoses).empty());
+  ASSERT_EQ(expectedPoses.size(), poses.size());
+  for (std::size_t i = 0; i < poses.size(); ++i)
+  {
+    EXPECT_EQ(expectedPoses[i].first, poses[i].first);
+    EXPECT_EQ(expectedPoses[i].second, poses[i].second);
+  }
+
+  std::map<std::string, Pose> posesByName(poses.begin(), poses.end());
+  EXPECT_EQ(Pose(0, 2, 0, 0, 0, 0), posesByName["child::P"]);
+}
+
 /////////////////////////////////////////////////
 TEST(DOMRoot, LoadCanonicalLink)
 {
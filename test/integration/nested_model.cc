@@ -1013,4 +1013,38 @@ TEST_F(PlacementFrame, ModelPlacementFrameAttribute)
       "model_with_placement_frame_and_pose_relative_to", "L4");
 }
 
+//////////////////////////////////////////////////
+TEST_F(PlacementFrame, SetRawPoses)
+{
+  const Pose3d placementPose(1, 2, 3, 0, 0, IGN_PI_2);
+
+  // Setting the pose of a model with a placement_frame attribute moves its
+  // placement frame to that pose, as loading does
+  sdf::World worldCopy(*this->world);
+  EXPECT_TRUE(worldCopy.SetRawPoses(
+      {{"model_with_link_placement_frame", placementPose}}).empty());
+  const sdf::Model *model =
+      worldCopy.ModelByName("model_with_link_placement_frame");
+  ASSERT_NE(nullptr, model);
+  Pose3d modelPose;
+  EXPECT_TRUE(model->SemanticPose().Resolve(modelPose, "world").empty());
+  Pose3d linkPose;
+  EXPECT_TRUE(model->LinkByName("L4")->SemanticPose().Resolve(
+      linkPose, "__model__").empty());
+  EXPECT_EQ(placementPose, modelPose * linkPose);
+
+  // The same goes for the model frame of an included model
+  const sdf::Model *parentModel =
+      this->world->ModelByName("parent_model_include");
+  ASSERT_NE(nullptr, parentModel);
+  sdf::Model modelCopy(*parentModel);
+  EXPECT_TRUE(modelCopy.SetRawPoses(
+      {{"placement_frame_using_link::__model__", placementPose}}).empty());
+  const sdf::Link *link =
+      modelCopy.LinkByName("placement_frame_using_link::L4");
+  ASSERT_NE(nullptr, link);
+  EXPECT_TRUE(link->SemanticPose().Resolve(linkPose, "__model__").empty());
+  EXPECT_EQ(placementPose, linkPose);
+}
+
 // TODO (addisu) Add NestedModelPlacementFrameAttribute tests
@@ -0,0 +1,278 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "sdf/Filesystem.hh"
+#include "sdf/Root.hh"
+#include "sdf/parser.hh"
+#include "test_config.h"
+
+// These tests are meant to be run on a build configured with
+// -DSANITIZE_THREAD=ON, so that ThreadSanitizer reports data races between
+// concurrent loads.
+
+const auto g_testPath = sdf::filesystem::append(PROJECT_SOURCE_PATH, "test");
+
+/// \brief Number of threads that load files at the same time.
+const unsigned int kThreadCount = 8;
+
+/// \brief Number of times each thread loads every file.
+const unsigned int kIterations = 4;
+
+/////////////////////////////////////////////////
+std::string findFileCb(const std::string &_input)
+{
+  return sdf::filesystem::append(g_testPath, "integration", "model", _input);
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the files loaded by the tests. These include valid and invalid
+/// files, files with includes, files that need conversion and URDF files.
+std::vector<std::string> testFiles()
+{
+  std::vector<std::string> files;
+  for (const std::string name : {
+      "box_plane_low_friction_test.world", "double_pendulum.sdf",
+      "empty_invalid.sdf", "includes.sdf", "includes_1.5.sdf",
+      "joint_complete.sdf", "joint_invalid_child.sdf", "material.sdf",
+      "model_frame_attached_to.sdf", "model_invalid_frame_relative_to.sdf",
+      "nested_model.sdf", "sensors.sdf", "shapes.sdf",
+      "world_complete.sdf"})
+  {
+    files.push_back(sdf::filesystem::append(g_testPath, "sdf", name));
+  }
+
+  for (const std::string name : {
+      "fixed_joint_reduction.urdf", "force_torque_sensor.urdf"})
+  {
+    files.push_back(
+        sdf::filesystem::append(g_testPath, "integration", name));
+  }
+  return files;
+}
+
+/////////////////////////////////////////////////
+/// \brief Result of loading a file.
+struct LoadResult
+{
+  /// \brief Number of errors reported.
+  std::size_t errorCount = 0;
+
+  /// \brief Loaded document as a string.
+  std::string document;
+};
+
+/////////////////////////////////////////////////
+/// \brief Load a file with sdf::Root::Load.
+LoadResult rootLoad(const std::string &_filename)
+{
+  LoadResult result;
+  sdf::Root root;
+  result.errorCount = root.Load(_filename).size();
+  if (root.Element())
+  {
+    result.document = root.Element()->ToString("");
+  }
+  return result;
+}
+
+/////////////////////////////////////////////////
+/// \brief Load a file with sdf::readFile.
+LoadResult readFile(const std::string &_filename)
+{
+  LoadResult result;
+  sdf::Errors errors;
+  sdf::SDFPtr sdfParsed = sdf::readFile(_filename, errors);
+  result.errorCount = errors.size();
+  if (sdfParsed)
+  {
+    result.document = sdfParsed->Root()->ToString("");
+  }
+  return result;
+}
+
+/////////////////////////////////////////////////
+/// \brief Load the contents of a file with sdf::readString.
+LoadResult readString(const std::string &_contents)
+{
+  LoadResult result;
+  sdf::SDFPtr sdfParsed(new sdf::SDF());
+  sdf::init(sdfParsed);
+  sdf::Errors errors;
+  if (sdf::readString(_contents, sdfParsed, errors))
+  {
+    result.document = sdfParsed->Root()->ToString("");
+  }
+  result.errorCount = errors.size();
+  return result;
+}
+
+/////////////////////////////////////////////////
+/// \brief Load every input with the given function, first on this thread and
+/// then from several threads at once, and check that the concurrent results
+/// match the sequential ones.
+template <typename LoadFunc>
+void checkConcurrentLoads(const std::vector<std::string> &_inputs,
+                          LoadFunc _load)
+{
+  std::vector<LoadResult> expected;
+  for (const std::string &input : _inputs)
+  {
+    expected.push_back(_load(input));
+  }
+
+  std::atomic<unsigned int> mismatches{0};
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < kThreadCount; ++t)
+  {
+    threads.emplace_back([&, t]()
+    {
+      for (unsigned int i = 0; i < kIterations * _inputs.size(); ++i)
+      {
+        // Start each thread at a different input, so that different files
+        // are loaded at the same time.
+        const std::size_t index = (t + i) % _inputs.size();
+        LoadResult result = _load(_inputs[index]);
+        if (result.errorCount != expected[index].errorCount ||
+            result.document != expected[index].document)
+        {
+          ++mismatches;
+        }
+      }
+    });
+  }
+
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+  EXPECT_EQ(0u, mismatches);
+}
+
+/////////////////////////////////////////////////
+TEST(ParserConcurrency, RootLoad)
+{
+  sdf::setFindCallback(findFileCb);
+  checkConcurrentLoads(testFiles(), rootLoad);
+}
+
+/////////////////////////////////////////////////
+TEST(ParserConcurrency, ReadFile)
+{
+  sdf::setFindCallback(findFileCb);
+  checkConcurrentLoads(testFiles(), readFile);
+}
+
+/////////////////////////////////////////////////
+TEST(ParserConcurrency, ReadString)
+{
+  std::vector<std::string> contents;
+  for (const std::string &filename : testFiles())
+  {
+    std::ifstream file(filename);
+    std::stringstream stream;
+    stream << file.rdbuf();
+    contents.push_back(stream.str());
+  }
+  checkConcurrentLoads(contents, readString);
+}
+
+/////////////////////////////////////////////////
+/// \brief Get URDF files with fixed joint reduction, <gazebo> extensions
+/// and robot origins, whose conversions would interfere if they shared
+/// state.
+std::vector<std::string> urdfFiles()
+{
+  std::vector<std::string> files;
+  for (const std::string name : {
+      "cfm_damping_implicit_spring_damper.urdf",
+      "fixed_joint_reduction.urdf",
+      "fixed_joint_reduction_collision.urdf",
+      "fixed_joint_reduction_collision_visual_extension.urdf",
+      "fixed_joint_reduction_disabled.urdf",
+      "fixed_joint_reduction_visual.urdf",
+      "force_torque_sensor.urdf", "provide_feedback.urdf",
+      "urdf_gazebo_extensions.urdf", "urdf_joint_parameters.urdf"})
+  {
+    files.push_back(
+        sdf::filesystem::append(g_testPath, "integration", name));
+  }
+  files.push_back(sdf::filesystem::append(g_testPath, "performance",
+      "parser_urdf_atlas.urdf"));
+  return files;
+}
+
+/////////////////////////////////////////////////
+TEST(ParserConcurrency, UrdfConversion)
+{
+  const std::vector<std::string> files = urdfFiles();
+  checkConcurrentLoads(files, readFile);
+
+  std::vector<std::string> contents;
+  for (const std::string &filename : files)
+  {
+    std::ifstream file(filename);
+    std::stringstream stream;
+    stream << file.rdbuf();
+    contents.push_back(stream.str());
+  }
+  checkConcurrentLoads(contents, readString);
+}
+
+/////////////////////////////////////////////////
+TEST(ParserConcurrency, FindFile)
+{
+  sdf::setFindCallback(findFileCb);
+  const std::string modelPath =
+      sdf::filesystem::append(g_testPath, "integration", "model");
+
+  // Register URI paths while other threads search for files
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < kThreadCount; ++t)
+  {
+    threads.emplace_back([&, t]()
+    {
+      for (unsigned int i = 0; i < 100; ++i)
+      {
+        if (t == 0)
+        {
+          sdf::addURIPath("concurrency" + std::to_string(i) + "://",
+              modelPath);
+          sdf::setFindCallback(findFileCb);
+        }
+        else
+        {
+          EXPECT_FALSE(sdf::findFile("box", false, true).empty());
+        }
+      }
+    });
+  }
+
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+  EXPECT_FALSE(sdf::findFile("concurrency99://box", false, false).empty());
+}
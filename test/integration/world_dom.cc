@@ -16,12 +16,18 @@
  */
 
 #include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <vector>
 #include <gtest/gtest.h>
 
 #include "sdf/SDFImpl.hh"
 #include "sdf/parser.hh"
 #include "sdf/Frame.hh"
+#include "sdf/Light.hh"
+#include "sdf/Link.hh"
 #include "sdf/Model.hh"
 #include "sdf/Root.hh"
 #include "sdf/World.hh"
@@ -220,3 +226,254 @@ TEST(DOMWorld, LoadModelFrameSameName)
       SemanticPose().Resolve(pose, "ground").empty());
   EXPECT_EQ(Pose(0, -2, 3, 0, 0, 0), pose);
 }
+
+/////////////////////////////////////////////////
+TEST(DOMWorld, ResolveAllPoses)
+{
+  const std::string testFile =
+    sdf::filesystem::append(PROJECT_SOURCE_PATH, "test", "sdf",
+        "world_frame_relative_to.sdf");
+
+  // Load the SDF file
+  sdf::Root root;
+  EXPECT_TRUE(root.Load(testFile).empty());
+
+  using Pose = ignition::math::Pose3d;
+
+  const sdf::World *world = root.WorldByIndex(0);
+  ASSERT_NE(nullptr, world);
+
+  sdf::FramePoses poses;
+  EXPECT_TRUE(world->ResolveAllPoses(poses).empty());
+
+  // The poses are sorted by frame name
+  const std::vector<std::string> expectedNames = {"F0", "F1", "F2", "M1",
+      "M1::F0", "M1::L", "M2", "M2::L", "M3", "M3::L", "M4", "M4::L",
+      "world", "world_frame"};
+  std::vector<std::string> names;
+  for (const auto &pose : poses)
+  {
+    names.push_back(pose.first);
+  }
+  EXPECT_EQ(expectedNames, names);
+
+  std::map<std::string, Pose> posesByName(poses.begin(), poses.end());
+  EXPECT_EQ(poses.size(), posesByName.size());
+  ASSERT_EQ(14u, posesByName.size());
+  EXPECT_EQ(Pose::Zero, posesByName["world"]);
+  EXPECT_EQ(Pose::Zero, posesByName["world_frame"]);
+  EXPECT_EQ(Pose(1, 0, 0, 0, 0, 0), posesByName["F0"]);
+  EXPECT_EQ(Pose(3, 0, 0, 0, 0, 0), posesByName["F1"]);
+  EXPECT_EQ(Pose(3, 0, 0, 0, 0, 0), posesByName["F2"]);
+  EXPECT_EQ(Pose::Zero, posesByName["M1"]);
+  EXPECT_EQ(Pose::Zero, posesByName["M1::L"]);
+  EXPECT_EQ(Pose(0, 3, 0, 0, 0, 0), posesByName["M1::F0"]);
+  EXPECT_EQ(Pose(0, 0, 4, 0, 0, 0), posesByName["M2"]);
+  EXPECT_EQ(Pose(0, 0, 4, 0, 0, 0), posesByName["M2::L"]);
+  EXPECT_EQ(Pose(0, 0, 9, 0, 0, 0), posesByName["M3"]);
+  EXPECT_EQ(Pose(0, 0, 9, 0, 0, 0), posesByName["M3::L"]);
+  EXPECT_EQ(Pose(3, 0, 6, 0, 0, 0), posesByName["M4"]);
+  EXPECT_EQ(Pose(3, 0, 6, 0, 0, 0), posesByName["M4::L"]);
+
+  // The model frames match their semantic poses
+  for (uint64_t i = 0; i < world->ModelCount(); ++i)
+  {
+    const sdf::Model *model = world->ModelByIndex(i);
+    Pose pose;
+    EXPECT_TRUE(model->SemanticPose().Resolve(pose).empty());
+    EXPECT_EQ(pose, posesByName[model->Name()]);
+  }
+
+  // Resolve the poses relative to a frame in a model
+  EXPECT_TRUE(world->ResolveAllPoses(poses, "M2::L").empty());
+  posesByName = std::map<std::string, Pose>(poses.begin(), poses.end());
+  EXPECT_EQ(Pose(0, 0, -4, 0, 0, 0), posesByName["world"]);
+  EXPECT_EQ(Pose(0, 0, 5, 0, 0, 0), posesByName["M3::L"]);
+}
+
+/////////////////////////////////////////////////
+TEST(DOMWorld, SetRawPoses)
+{
+  const std::string testFile =
+    sdf::filesystem::append(PROJECT_SOURCE_PATH, "test", "sdf",
+        "world_frame_relative_to.sdf");
+
+  // Load the SDF file
+  sdf::Root root;
+  EXPECT_TRUE(root.Load(testFile).empty());
+
+  using Pose = ignition::math::Pose3d;
+
+  const sdf::World *world = root.WorldByIndex(0);
+  ASSERT_NE(nullptr, world);
+
+  // The copy shares the graphs of the world until its poses are set
+  sdf::World copy(*world);
+  EXPECT_TRUE(copy.SetRawPoses({
+      {"F0", Pose(0, 1, 0, 0, 0, 0)},
+      {"M2", Pose(0, 0, 2, 0, 0, 0)}}).empty());
+  EXPECT_EQ(Pose(0, 1, 0, 0, 0, 0), copy.FrameByName("F0")->RawPose());
+  EXPECT_EQ(Pose(0, 0, 2, 0, 0, 0), copy.ModelByName("M2")->RawPose());
+
+  sdf::FramePoses poses;
+  EXPECT_TRUE(copy.ResolveAllPoses(poses).empty());
+  std::map<std::string, Pose> posesByName(poses.begin(), poses.end());
+  EXPECT_EQ(Pose(0, 1, 0, 0, 0, 0), posesByName["F0"]);
+  EXPECT_EQ(Pose(2, 1, 0, 0, 0, 0), posesByName["F1"]);
+  EXPECT_EQ(Pose(0, 0, 2, 0, 0, 0), posesByName["M2::L"]);
+  EXPECT_EQ(Pose(0, 0, 7, 0, 0, 0), posesByName["M3::L"]);
+  EXPECT_EQ(Pose(2, 1, 6, 0, 0, 0), posesByName["M4::L"]);
+
+  // The children of the copy use its updated graph
+  Pose pose;
+  EXPECT_TRUE(copy.ModelByName("M4")->SemanticPose().Resolve(pose).empty());
+  EXPECT_EQ(Pose(2, 1, 6, 0, 0, 0), pose);
+
+  // The original world keeps its poses
+  EXPECT_EQ(Pose(1, 0, 0, 0, 0, 0), world->FrameByName("F0")->RawPose());
+  EXPECT_TRUE(world->ResolveAllPoses(poses).empty());
+  posesByName = std::map<std::string, Pose>(poses.begin(), poses.end());
+  EXPECT_EQ(Pose(3, 0, 0, 0, 0, 0), posesByName["F1"]);
+  EXPECT_EQ(Pose(0, 0, 9, 0, 0, 0), posesByName["M3::L"]);
+  EXPECT_TRUE(world->ModelByName("M4")->SemanticPose().Resolve(pose).empty());
+  EXPECT_EQ(Pose(3, 0, 6, 0, 0, 0), pose);
+
+  // Unknown names are reported
+  sdf::Errors errors = copy.SetRawPoses({{"invalid", Pose::Zero}});
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::POSE_RELATIVE_TO_INVALID, errors[0].Code());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMWorld, CopySharesGraphs)
+{
+  const std::string testFile =
+    sdf::filesystem::append(PROJECT_SOURCE_PATH, "test", "sdf",
+        "world_complete.sdf");
+
+  using Pose = ignition::math::Pose3d;
+
+  auto root = std::make_unique<sdf::Root>();
+  EXPECT_TRUE(root->Load(testFile).empty());
+  const sdf::World *world = root->WorldByIndex(0);
+  ASSERT_NE(nullptr, world);
+
+  sdf::FramePoses expectedPoses;
+  EXPECT_TRUE(world->ResolveAllPoses(expectedPoses).empty());
+  EXPECT_FALSE(expectedPoses.empty());
+
+  // The copies keep working after the original is destroyed, since they
+  // share its graphs.
+  sdf::World copy(*world);
+  sdf::World assigned;
+  assigned = *world;
+  root.reset();
+
+  for (const sdf::World *w : {&copy, &assigned})
+  {
+    sdf::FramePoses poses;
+    EXPECT_TRUE(w->ResolveAllPoses(poses).empty());
+    EXPECT_EQ(expectedPoses, poses);
+
+    Pose pose;
+    const sdf::Light *light = w->LightByIndex(0);
+    ASSERT_NE(nullptr, light);
+    EXPECT_TRUE(light->SemanticPose().Resolve(pose).empty());
+    EXPECT_EQ(Pose(1, 2, 10, 0, 0, 0), pose);
+
+    light = w->LightByIndex(2);
+    ASSERT_NE(nullptr, light);
+    EXPECT_TRUE(light->SemanticPose().Resolve(pose).empty());
+    EXPECT_EQ(Pose(1, 12, 23, 0, 0, 0), pose);
+
+    const sdf::Model *model = w->ModelByIndex(0);
+    ASSERT_NE(nullptr, model);
+    EXPECT_TRUE(model->SemanticPose().Resolve(pose).empty());
+    EXPECT_EQ(Pose(1, 2, 3, 0, 0, 0), pose);
+
+    const sdf::Link *link = model->LinkByIndex(0);
+    ASSERT_NE(nullptr, link);
+    light = link->LightByIndex(0);
+    ASSERT_NE(nullptr, light);
+    EXPECT_TRUE(light->SemanticPose().Resolve(pose, "__model__").empty());
+    EXPECT_EQ(Pose(11, 13, 15, 0, 0, 0), pose);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(DOMWorld, ParallelLoad)
+{
+  // Many models and lights, some of which are invalid or have duplicate
+  // names
+  std::ostringstream stream;
+  stream << "<sdf version='" << SDF_VERSION << "'>"
+         << "<world name='default'>";
+  const int modelCount = 60;
+  for (int i = 0; i < modelCount; ++i)
+  {
+    stream << "<model name='model_" << (i % 13 == 12 ? i - 1 : i) << "'>"
+           << "  <pose>" << i << " 0 0 0 0 0</pose>";
+    if (i % 10 != 3)
+    {
+      stream << "  <link name='link'/>";
+    }
+    stream << "</model>"
+           << "<light type='point' name='light_" << i % 50 << "'/>";
+  }
+  stream << "</world></sdf>";
+
+  // Load the world directly, since sdf::Root skips worlds with errors
+  auto loadWorld = [&stream](sdf::World &_world)
+  {
+    sdf::SDFPtr sdfParsed(new sdf::SDF());
+    sdf::init(sdfParsed);
+    EXPECT_TRUE(sdf::readString(stream.str(), sdfParsed));
+    return _world.Load(sdfParsed->Root()->GetElement("world"));
+  };
+
+  EXPECT_EQ(1u, sdf::domLoadThreadCount());
+  sdf::World serialWorld;
+  sdf::Errors serialErrors = loadWorld(serialWorld);
+
+  sdf::setDomLoadThreadCount(8);
+  EXPECT_EQ(8u, sdf::domLoadThreadCount());
+  sdf::World parallelWorld;
+  sdf::Errors parallelErrors = loadWorld(parallelWorld);
+  sdf::setDomLoadThreadCount(0);
+  EXPECT_EQ(1u, sdf::domLoadThreadCount());
+
+  ASSERT_FALSE(serialErrors.empty());
+  ASSERT_EQ(serialErrors.size(), parallelErrors.size());
+  for (std::size_t i = 0; i < serialErrors.size(); ++i)
+  {
+    EXPECT_EQ(serialErrors[i].Code(), parallelErrors[i].Code());
+    EXPECT_EQ(serialErrors[i].Message(), parallelErrors[i].Message());
+  }
+
+  // The duplicated models and lights are skipped
+  ASSERT_EQ(56u, serialWorld.ModelCount());
+  ASSERT_EQ(serialWorld.ModelCount(), parallelWorld.ModelCount());
+  for (uint64_t i = 0; i < serialWorld.ModelCount(); ++i)
+  {
+    const sdf::Model *serialModel = serialWorld.ModelByIndex(i);
+    const sdf::Model *parallelModel = parallelWorld.ModelByIndex(i);
+    EXPECT_EQ(serialModel->Name(), parallelModel->Name());
+    EXPECT_EQ(serialModel->RawPose(), parallelModel->RawPose());
+    EXPECT_EQ(serialModel->LinkCount(), parallelModel->LinkCount());
+    EXPECT_EQ(parallelModel, parallelWorld.ModelByName(serialModel->Name()));
+  }
+
+  ASSERT_EQ(50u, serialWorld.LightCount());
+  ASSERT_EQ(serialWorld.LightCount(), parallelWorld.LightCount());
+  for (uint64_t i = 0; i < serialWorld.LightCount(); ++i)
+  {
+    EXPECT_EQ(serialWorld.LightByIndex(i)->Name(),
+              parallelWorld.LightByIndex(i)->Name());
+  }
+
+  sdf::FramePoses serialPoses;
+  sdf::FramePoses parallelPoses;
+  serialWorld.ResolveAllPoses(serialPoses);
+  parallelWorld.ResolveAllPoses(parallelPoses);
+  EXPECT_EQ(serialPoses, parallelPoses);
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string>
+#include <gtest/gtest.h>
+
+#include "sdf/Filesystem.hh"
+#include "sdf/Model.hh"
+#include "sdf/parser.hh"
+#include "sdf/Root.hh"
+#include "sdf/SDFImpl.hh"
+#include "test_config.h"
+
+const auto g_testPath = sdf::filesystem::append(PROJECT_SOURCE_PATH, "test");
+
+/////////////////////////////////////////////////
+std::string findFileCb(const std::string &_input)
+{
+  return sdf::filesystem::append(g_testPath, "integration", "model", _input);
+}
+
+/////////////////////////////////////////////////
+/// \brief Restores the default XML parsing mode when it goes out of scope.
+class XmlStreamingGuard
+{
+  public: ~XmlStreamingGuard()
+  {
+    sdf::setXmlStreaming(false);
+  }
+};
+
+/////////////////////////////////////////////////
+/// \brief Result of reading a file.
+struct ReadResult
+{
+  bool success = false;
+  std::size_t errorCount = 0;
+  std::string text;
+};
+
+/////////////////////////////////////////////////
+/// \brief Read a file with the given XML parsing mode.
+ReadResult readFile(const std::string &_path, bool _streaming)
+{
+  sdf::setXmlStreaming(_streaming);
+  sdf::clearIncludeCache();
+
+  ReadResult result;
+  sdf::SDFPtr sdf(new sdf::SDF());
+  sdf::init(sdf);
+  sdf::Errors errors;
+  result.success = sdf::readFile(_path, sdf, errors);
+  result.errorCount = errors.size();
+  result.text = sdf->Root()->ToString("");
+  return result;
+}
+
+/////////////////////////////////////////////////
+TEST(XmlStreaming, Setting)
+{
+  XmlStreamingGuard guard;
+  EXPECT_FALSE(sdf::xmlStreaming());
+  sdf::setXmlStreaming(true);
+  EXPECT_TRUE(sdf::xmlStreaming());
+  sdf::setXmlStreaming(false);
+  EXPECT_FALSE(sdf::xmlStreaming());
+}
+
+/////////////////////////////////////////////////
+TEST(XmlStreaming, SameResultAsDom)
+{
+  XmlStreamingGuard guard;
+  sdf::setFindCallback(findFileCb);
+
+  for (const std::string file : {
+      "double_pendulum.sdf", "empty.sdf", "empty_invalid.sdf",
+      "ignore_sdf_in_namespaced_elements.sdf", "ignore_sdf_in_plugin.sdf",
+      "includes.sdf", "includes_1.5.sdf", "joint_complete.sdf",
+      "material_pbr.sdf", "nested_model.sdf", "sensors.sdf", "shapes.sdf",
+      "world_complete.sdf", "world_noname.sdf"})
+  {
+    const std::string path = sdf::filesystem::append(g_testPath, "sdf", file);
+    const ReadResult dom = readFile(path, false);
+    const ReadResult stream = readFile(path, true);
+    EXPECT_EQ(dom.success, stream.success) << file;
+    EXPECT_EQ(dom.errorCount, stream.errorCount) << file;
+    EXPECT_EQ(dom.text, stream.text) << file;
+  }
+
+  // A URDF file is still converted
+  const std::string urdf = sdf::filesystem::append(
+      g_testPath, "integration", "fixed_joint_reduction.urdf");
+  const ReadResult dom = readFile(urdf, false);
+  const ReadResult stream = readFile(urdf, true);
+  EXPECT_TRUE(stream.success);
+  EXPECT_EQ(dom.text, stream.text);
+}
+
+/////////////////////////////////////////////////
+TEST(XmlStreaming, String)
+{
+  XmlStreamingGuard guard;
+  sdf::setXmlStreaming(true);
+
+  const std::string sdfString =
+    "<?xml version='1.0'?>"
+    "<sdf version='" + std::string(SDF_VERSION) + "'>"
+    "  <model name='m'>"
+    "    <link name='l'><pose>1 2 3 0 0 0</pose></link>"
+    "    <unknown_element a='b'><c>d</c></unknown_element>"
+    "  </model>"
+    "</sdf>";
+
+  sdf::Root root;
+  sdf::Errors errors = root.LoadSdfString(sdfString);
+  EXPECT_TRUE(errors.empty());
+  ASSERT_EQ(1u, root.ModelCount());
+  const sdf::Model *model = root.ModelByIndex(0);
+  ASSERT_NE(nullptr, model);
+  EXPECT_EQ("m", model->Name());
+  EXPECT_EQ(1u, model->LinkCount());
+
+  // Malformed XML fails
+  sdf::SDFPtr sdf(new sdf::SDF());
+  sdf::init(sdf);
+  EXPECT_FALSE(sdf::readString(
+      "<sdf version='" + std::string(SDF_VERSION) +
+      "'><model name='m'></sdf>", sdf));
+}
+
+/////////////////////////////////////////////////
+TEST(XmlStreaming, InvalidDocumentLeavesSdfUnchanged)
+{
+  XmlStreamingGuard guard;
+  sdf::setXmlStreaming(true);
+
+  sdf::SDFPtr sdf(new sdf::SDF());
+  sdf::init(sdf);
+  const std::string before = sdf->Root()->ToString("");
+
+  // The model is read before the error at the end of the document is found
+  sdf::Errors errors;
+  EXPECT_FALSE(sdf::readString(
+      "<sdf version='" + std::string(SDF_VERSION) + "'>"
+      "  <model name='m'><link name='l'/></model>"
+      "</sdf><sdf>", sdf, errors));
+  EXPECT_FALSE(sdf->Root()->HasElement("model"));
+  EXPECT_EQ(before, sdf->Root()->ToString(""));
+  EXPECT_TRUE(sdf->OriginalVersion().empty());
+
+  // So is a document that isn't valid SDFormat
+  errors.clear();
+  EXPECT_FALSE(sdf::readString(
+      "<sdf version='" + std::string(SDF_VERSION) + "'>"
+      "  <model name='m'><link name='l'/></model>"
+      "  <model><link name='l'/></model>"
+      "</sdf>", sdf, errors));
+  EXPECT_FALSE(errors.empty());
+  EXPECT_EQ(before, sdf->Root()->ToString(""));
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "sdf/sdf.hh"
+
+/////////////////////////////////////////////////
+/// \brief Generate a model with chains of frames. Each frame is attached to
+/// and posed relative to the previous frame of its chain, so that resolving
+/// the frames requires following long paths through the frame graphs.
+/// \param[in] _chainCount Number of chains.
+/// \param[in] _chainLength Number of frames in each chain.
+/// \return The SDFormat document.
+std::string frameChains(int _chainCount, int _chainLength)
+{
+  std::ostringstream stream;
+  stream << "<?xml version='1.0'?>\n"
+         << "<sdf version='" << SDF_VERSION << "'>\n"
+         << "<model name='frame_chains'>\n"
+         << "  <link name='base'/>\n";
+
+  for (int c = 0; c < _chainCount; ++c)
+  {
+    for (int f = 0; f < _chainLength; ++f)
+    {
+      const std::string parent = f == 0 ? std::string("base") :
+          "frame_" + std::to_string(c) + "_" + std::to_string(f - 1);
+      stream << "  <frame name='frame_" << c << "_" << f
+             << "' attached_to='" << parent << "'>\n"
+             << "    <pose relative_to='" << parent << "'>"
+             << "0 0 0.1 0 0 0.01</pose>\n"
+             << "  </frame>\n";
+    }
+  }
+
+  stream << "</model>\n"
+         << "</sdf>\n";
+  return stream.str();
+}
+
+/////////////////////////////////////////////////
+TEST(FrameGraph, BuildAndValidate_performance)
+{
+  const int chainCount = 100;
+  const int chainLength = 100;
+  const std::string sdfString = frameChains(chainCount, chainLength);
+
+  // Loading the model builds and validates its frame graphs, and caches the
+  // resolved poses
+  auto start = std::chrono::steady_clock::now();
+  sdf::Root root;
+  sdf::Errors errors = root.LoadSdfString(sdfString);
+  auto end = std::chrono::steady_clock::now();
+  EXPECT_TRUE(errors.empty());
+  for (const auto &e : errors)
+    std::cerr << e.Message() << std::endl;
+
+  std::cout << "Root::LoadSdfString of " << chainCount * chainLength
+            << " frames took "
+            << std::chrono::duration<double, std::milli>(end - start).count()
+            << " ms" << std::endl;
+
+  const sdf::Model *model = root.ModelByIndex(0);
+  ASSERT_NE(nullptr, model);
+  ASSERT_EQ(static_cast<uint64_t>(chainCount * chainLength),
+      model->FrameCount());
+
+  // Check both graphs, which reuses the results of Load
+  start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(sdf::checkFrameAttachedToGraph(&root));
+  EXPECT_TRUE(sdf::checkPoseRelativeToGraph(&root));
+  end = std::chrono::steady_clock::now();
+
+  std::cout << "Checking the frame graphs of "
+            << chainCount * chainLength << " frames took "
+            << std::chrono::duration<double, std::milli>(end - start).count()
+            << " ms" << std::endl;
+
+  // Resolve every frame through its semantic pose
+  start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < model->FrameCount(); ++i)
+  {
+    ignition::math::Pose3d pose;
+    EXPECT_TRUE(model->FrameByIndex(i)->SemanticPose().Resolve(pose).empty());
+  }
+  end = std::chrono::steady_clock::now();
+
+  std::cout << "Resolving the poses of " << chainCount * chainLength
+            << " frames took "
+            << std::chrono::duration<double, std::milli>(end - start).count()
+            << " ms" << std::endl;
+
+  std::string body;
+  EXPECT_TRUE(model->FrameByName("frame_0_99")->ResolveAttachedToBody(body)
+      .empty());
+  EXPECT_EQ("base", body);
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <ignition/math/Pose3.hh>
+
+#include "sdf/sdf.hh"
+#include "FrameSemantics.hh"
+
+using Pose = ignition::math::Pose3d;
+
+/////////////////////////////////////////////////
+/// \brief Generate a model with chains of frames, each posed relative to the
+/// previous frame of its chain.
+/// \param[in] _chainCount Number of chains.
+/// \param[in] _chainLength Number of frames in each chain.
+/// \return The SDFormat document.
+std::string frameChains(int _chainCount, int _chainLength)
+{
+  std::ostringstream stream;
+  stream << "<?xml version='1.0'?>\n"
+         << "<sdf version='" << SDF_VERSION << "'>\n"
+         << "<model name='frame_chains'>\n"
+         << "  <link name='base'/>\n";
+
+  for (int c = 0; c < _chainCount; ++c)
+  {
+    for (int f = 0; f < _chainLength; ++f)
+    {
+      const std::string parent = f == 0 ? std::string("base") :
+          "frame_" + std::to_string(c) + "_" + std::to_string(f - 1);
+      stream << "  <frame name='frame_" << c << "_" << f
+             << "' attached_to='" << parent << "'>\n"
+             << "    <pose relative_to='" << parent << "'>"
+             << "0 0 0.1 0 0 0.01</pose>\n"
+             << "  </frame>\n";
+    }
+  }
+
+  stream << "</model>\n"
+         << "</sdf>\n";
+  return stream.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Resolve the pose of a vertex relative to its source vertex by
+/// querying the ignition graph, as frame graphs were resolved before they
+/// had a flat tree.
+/// \param[in] _graph Graph to read from.
+/// \param[in] _vertexId Id of the vertex.
+/// \return The pose.
+Pose resolveByGraphWalk(const sdf::PoseRelativeToGraph &_graph,
+    ignition::math::graph::VertexId _vertexId)
+{
+  Pose pose;
+  std::set<ignition::math::graph::VertexId> visited = {_vertexId};
+  auto vertexId = _vertexId;
+  while (true)
+  {
+    const auto incoming = _graph.graph.IncidentsTo(vertexId);
+    if (incoming.size() != 1)
+    {
+      break;
+    }
+    const auto &edge = incoming.begin()->second.get();
+    vertexId = edge.Tail();
+    if (!visited.insert(vertexId).second)
+    {
+      break;
+    }
+    pose = edge.Data() * pose;
+  }
+  return pose;
+}
+
+/////////////////////////////////////////////////
+TEST(FrameTree, ResolveBeforeAndAfter_performance)
+{
+  const int chainCount = 100;
+  const int chainLength = 100;
+  sdf::Root root;
+  EXPECT_TRUE(root.LoadSdfString(frameChains(chainCount, chainLength))
+      .empty());
+  const sdf::Model *model = root.ModelByIndex(0);
+  ASSERT_NE(nullptr, model);
+
+  sdf::PoseRelativeToGraph graph;
+  EXPECT_TRUE(sdf::buildPoseRelativeToGraph(graph, model).empty());
+
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(sdf::validatePoseRelativeToGraph(graph).empty());
+  auto end = std::chrono::steady_clock::now();
+  const double validateTime =
+      std::chrono::duration<double, std::milli>(end - start).count();
+
+  // Before: walk the ignition graph from every vertex
+  std::vector<Pose> walkedPoses;
+  start = std::chrono::steady_clock::now();
+  for (const auto &namePair : graph.map)
+  {
+    walkedPoses.push_back(resolveByGraphWalk(graph, namePair.second));
+  }
+  end = std::chrono::steady_clock::now();
+  const double graphTime =
+      std::chrono::duration<double, std::milli>(end - start).count();
+
+  // After: walk the flat tree from every vertex
+  std::vector<Pose> treePoses;
+  start = std::chrono::steady_clock::now();
+  for (const auto &namePair : graph.map)
+  {
+    Pose pose;
+    EXPECT_TRUE(
+        sdf::resolvePoseRelativeToRoot(pose, graph, namePair.first).empty());
+    treePoses.push_back(pose);
+  }
+  end = std::chrono::steady_clock::now();
+  const double treeTime =
+      std::chrono::duration<double, std::milli>(end - start).count();
+
+  // After, with the poses cached in a single pass
+  start = std::chrono::steady_clock::now();
+  sdf::cachePosesRelativeToRoot(graph);
+  for (const auto &namePair : graph.map)
+  {
+    Pose pose;
+    EXPECT_TRUE(
+        sdf::resolvePoseRelativeToRoot(pose, graph, namePair.first).empty());
+  }
+  end = std::chrono::steady_clock::now();
+  const double cachedTime =
+      std::chrono::duration<double, std::milli>(end - start).count();
+
+  std::cout << "Validating the pose graph of " << graph.map.size()
+            << " frames took " << validateTime << " ms" << std::endl;
+  std::cout << "Resolving " << graph.map.size() << " frames took "
+            << graphTime << " ms by walking the graph, "
+            << treeTime << " ms by walking the tree and "
+            << cachedTime << " ms with cached poses" << std::endl;
+
+  ASSERT_EQ(walkedPoses.size(), treePoses.size());
+  for (std::size_t i = 0; i < walkedPoses.size(); ++i)
+  {
+    EXPECT_EQ(walkedPoses[i], treePoses[i]) << i;
+  }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "sdf/sdf.hh"
+
+/////////////////////////////////////////////////
+/// \brief Generate a model with many links and frames, followed by a link
+/// whose name is a duplicate.
+/// \param[in] _count Number of links, and number of frames.
+/// \return The SDFormat document.
+std::string manyLinks(int _count)
+{
+  std::ostringstream stream;
+  stream << "<?xml version='1.0'?>\n"
+         << "<sdf version='" << SDF_VERSION << "'>\n"
+         << "<model name='many_links'>\n";
+
+  for (int i = 0; i < _count; ++i)
+  {
+    stream << "  <link name='link_" << i << "'/>\n"
+           << "  <frame name='frame_" << i << "' attached_to='link_" << i
+           << "'/>\n";
+  }
+  stream << "  <link name='link_0'/>\n"
+         << "</model>\n"
+         << "</sdf>\n";
+  return stream.str();
+}
+
+/////////////////////////////////////////////////
+TEST(ModelLookup, ByName_performance)
+{
+  const int count = 20000;
+  const std::string sdfString = manyLinks(count);
+
+  // Loading checks every name for duplicates
+  auto start = std::chrono::steady_clock::now();
+  sdf::Root root;
+  sdf::Errors errors = root.LoadSdfString(sdfString);
+  auto end = std::chrono::steady_clock::now();
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::DUPLICATE_NAME, errors[0].Code());
+
+  std::cout << "Root::LoadSdfString of " << count << " links and "
+            << count << " frames took "
+            << std::chrono::duration<double, std::milli>(end - start).count()
+            << " ms" << std::endl;
+
+  const sdf::Model *model = root.ModelByIndex(0);
+  ASSERT_NE(nullptr, model);
+  ASSERT_EQ(static_cast<uint64_t>(count), model->LinkCount());
+  ASSERT_EQ(static_cast<uint64_t>(count), model->FrameCount());
+
+  // Look up every link and frame by name, in a copy of the model so that
+  // the lookups must return its own links and frames
+  const sdf::Model copy = *model;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < count; ++i)
+  {
+    const std::string suffix = std::to_string(i);
+    EXPECT_EQ(copy.LinkByIndex(i), copy.LinkByName("link_" + suffix));
+    EXPECT_EQ(copy.FrameByIndex(i), copy.FrameByName("frame_" + suffix));
+  }
+  end = std::chrono::steady_clock::now();
+
+  std::cout << "Looking up " << count << " links and " << count
+            << " frames by name took "
+            << std::chrono::duration<double, std::milli>(end - start).count()
+            << " ms" << std::endl;
+
+  EXPECT_TRUE(copy.LinkNameExists("link_0"));
+  EXPECT_FALSE(copy.LinkNameExists("frame_0"));
+  EXPECT_EQ(nullptr, copy.LinkByName("link_" + std::to_string(count)));
+  EXPECT_EQ(nullptr, copy.JointByName("link_0"));
+}
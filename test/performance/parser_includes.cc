@@ -0,0 +1,94 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "sdf/sdf.hh"
+
+#include "test_config.h"
+
+/////////////////////////////////////////////////
+std::string findFileCb(const std::string &_input)
+{
+  return sdf::filesystem::append(PROJECT_SOURCE_PATH, "test", "integration",
+      "model", _input);
+}
+
+/////////////////////////////////////////////////
+/// \brief Create a world that includes the same model many times.
+std::string includesWorld(int _includeCount)
+{
+  std::ostringstream stream;
+  stream << "<sdf version='" << SDF_VERSION << "'>"
+         << "<world name='default'>";
+  for (int i = 0; i < _includeCount; ++i)
+  {
+    stream << "<include>"
+           << "  <uri>test_model</uri>"
+           << "  <name>model_" << i << "</name>"
+           << "  <pose>" << i << " 0 0 0 0 0</pose>"
+           << "</include>";
+  }
+  stream << "</world></sdf>";
+  return stream.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Load a world and return the time it took in milliseconds.
+double loadWorld(const std::string &_sdfString, int _includeCount)
+{
+  auto start = std::chrono::steady_clock::now();
+  sdf::Root root;
+  sdf::Errors errors = root.LoadSdfString(_sdfString);
+  auto end = std::chrono::steady_clock::now();
+  EXPECT_TRUE(errors.empty());
+  EXPECT_EQ(1u, root.WorldCount());
+  if (root.WorldCount() == 1u)
+  {
+    EXPECT_EQ(static_cast<uint64_t>(_includeCount),
+        root.WorldByIndex(0)->ModelCount());
+  }
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/////////////////////////////////////////////////
+TEST(Includes, IncludeCache_performance)
+{
+  sdf::setFindCallback(findFileCb);
+
+  const int includeCount = 500;
+  const std::string sdfString = includesWorld(includeCount);
+
+  // The cache is disabled by default
+  const double uncached = loadWorld(sdfString, includeCount);
+
+  sdf::setIncludeCacheSize(100);
+  sdf::clearIncludeCache();
+  const double cached = loadWorld(sdfString, includeCount);
+  sdf::setIncludeCacheSize(0);
+  sdf::clearIncludeCache();
+
+  std::cout << "Loading " << includeCount << " includes took "
+            << uncached << " ms without the include cache and "
+            << cached << " ms with it" << std::endl;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "sdf/sdf.hh"
+
+/////////////////////////////////////////////////
+TEST(ParserInit, Init_performance)
+{
+  // The first call builds the spec description from the generated tables
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(sdf::warmSchemaCache());
+  auto end = std::chrono::steady_clock::now();
+  std::cout << "Building the spec description took "
+            << std::chrono::duration<double, std::micro>(end - start).count()
+            << " us" << std::endl;
+
+  // Later calls copy the cached description
+  const int count = 1000;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < count; ++i)
+  {
+    sdf::SDFPtr sdfParsed(new sdf::SDF());
+    EXPECT_TRUE(sdf::init(sdfParsed));
+  }
+  end = std::chrono::steady_clock::now();
+  std::cout << "sdf::init took "
+            << std::chrono::duration<double, std::micro>(end - start).count() /
+               count
+            << " us on average" << std::endl;
+}
+
+/////////////////////////////////////////////////
+TEST(ParserInit, SingleModelLoad_performance)
+{
+  const std::string sdfString =
+    "<sdf version='" SDF_VERSION "'>"
+    "  <model name='model'>"
+    "    <link name='link'>"
+    "      <visual name='visual'>"
+    "        <geometry><box><size>1 1 1</size></box></geometry>"
+    "      </visual>"
+    "    </link>"
+    "  </model>"
+    "</sdf>";
+
+  const int count = 1000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < count; ++i)
+  {
+    sdf::Root root;
+    EXPECT_TRUE(root.LoadSdfString(sdfString).empty());
+  }
+  auto end = std::chrono::steady_clock::now();
+  std::cout << "Root::LoadSdfString of a single model took "
+            << std::chrono::duration<double, std::micro>(end - start).count() /
+               count
+            << " us on average" << std::endl;
+}
@@ -0,0 +1,301 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "sdf/sdf.hh"
+
+namespace
+{
+  /// \brief Size of the header used to store the size of each allocation.
+  constexpr std::size_t kHeaderSize = alignof(std::max_align_t);
+
+  /// \brief Number of allocations made through operator new.
+  std::atomic<std::size_t> g_allocationCount{0};
+
+  /// \brief Number of bytes currently allocated through operator new.
+  std::atomic<std::size_t> g_liveBytes{0};
+
+  /// \brief Largest value of g_liveBytes since the last reset.
+  std::atomic<std::size_t> g_peakBytes{0};
+
+  /// \brief Reset the allocation counters.
+  void resetAllocationCounters()
+  {
+    g_allocationCount = 0;
+    g_peakBytes = g_liveBytes.load();
+  }
+}
+
+/////////////////////////////////////////////////
+void *operator new(std::size_t _size)
+{
+  char *ptr = static_cast<char *>(std::malloc(_size + kHeaderSize));
+  if (!ptr)
+  {
+    throw std::bad_alloc();
+  }
+  *reinterpret_cast<std::size_t *>(ptr) = _size;
+
+  ++g_allocationCount;
+  std::size_t live = g_liveBytes += _size;
+  std::size_t peak = g_peakBytes;
+  while (live > peak && !g_peakBytes.compare_exchange_weak(peak, live))
+  {
+  }
+
+  return ptr + kHeaderSize;
+}
+
+/////////////////////////////////////////////////
+void operator delete(void *_ptr) noexcept
+{
+  if (!_ptr)
+  {
+    return;
+  }
+  char *ptr = static_cast<char *>(_ptr) - kHeaderSize;
+  g_liveBytes -= *reinterpret_cast<std::size_t *>(ptr);
+  std::free(ptr);
+}
+
+/////////////////////////////////////////////////
+void operator delete(void *_ptr, std::size_t) noexcept
+{
+  ::operator delete(_ptr);
+}
+
+/////////////////////////////////////////////////
+/// \brief Generate a world with many models, each containing a chain of
+/// links connected by revolute joints.
+/// \param[in] _modelCount Number of models in the world.
+/// \param[in] _linkCount Number of links in each model.
+/// \return SDFormat string of the world.
+std::string largeWorld(int _modelCount, int _linkCount)
+{
+  std::ostringstream stream;
+  stream << "<?xml version='1.0'?>\n"
+         << "<sdf version='" << SDF_VERSION << "'>\n"
+         << "<world name='large_world'>\n";
+
+  for (int m = 0; m < _modelCount; ++m)
+  {
+    stream << "<model name='model_" << m << "'>\n"
+           << "  <pose>" << m << " 0 0 0 0 0</pose>\n";
+    for (int l = 0; l < _linkCount; ++l)
+    {
+      stream << "  <link name='link_" << l << "'>\n"
+             << "    <pose>0 0 " << l << " 0 0 0</pose>\n"
+             << "    <inertial>\n"
+             << "      <mass>1.0</mass>\n"
+             << "      <inertia>\n"
+             << "        <ixx>0.1</ixx><iyy>0.1</iyy><izz>0.1</izz>\n"
+             << "      </inertia>\n"
+             << "    </inertial>\n"
+             << "    <collision name='collision'>\n"
+             << "      <geometry><box><size>1 1 1</size></box></geometry>\n"
+             << "    </collision>\n"
+             << "    <visual name='visual'>\n"
+             << "      <geometry><box><size>1 1 1</size></box></geometry>\n"
+             << "      <material><diffuse>1 0 0 1</diffuse></material>\n"
+             << "    </visual>\n"
+             << "  </link>\n";
+      if (l > 0)
+      {
+        stream << "  <joint name='joint_" << l << "' type='revolute'>\n"
+               << "    <parent>link_" << l - 1 << "</parent>\n"
+               << "    <child>link_" << l << "</child>\n"
+               << "    <axis><xyz>0 0 1</xyz></axis>\n"
+               << "  </joint>\n";
+      }
+    }
+    stream << "</model>\n";
+  }
+
+  stream << "</world>\n"
+         << "</sdf>\n";
+  return stream.str();
+}
+
+/////////////////////////////////////////////////
+TEST(LargeWorld, ReadString_performance)
+{
+  const int modelCount = 200;
+  const int linkCount = 25;
+  const std::string sdfString = largeWorld(modelCount, linkCount);
+
+  sdf::SDFPtr sdfParsed(new sdf::SDF());
+  ASSERT_TRUE(sdf::init(sdfParsed));
+
+  auto start = std::chrono::steady_clock::now();
+  sdf::Errors errors;
+  EXPECT_TRUE(sdf::readString(sdfString, sdfParsed, errors));
+  auto end = std::chrono::steady_clock::now();
+  EXPECT_TRUE(errors.empty());
+
+  std::cout << "readString of " << modelCount * linkCount << " links took "
+            << std::chrono::duration<double, std::milli>(end - start).count()
+            << " ms" << std::endl;
+
+  sdf::ElementPtr worldElem = sdfParsed->Root()->GetElement("world");
+  ASSERT_NE(nullptr, worldElem);
+  int models = 0;
+  for (sdf::ElementPtr model = worldElem->GetElement("model"); model;
+       model = model->GetNextElement("model"))
+  {
+    ++models;
+  }
+  EXPECT_EQ(modelCount, models);
+}
+
+/////////////////////////////////////////////////
+TEST(LargeWorld, RootLoad_performance)
+{
+  const int modelCount = 200;
+  const int linkCount = 25;
+  const std::string sdfString = largeWorld(modelCount, linkCount);
+
+  auto start = std::chrono::steady_clock::now();
+  sdf::Root root;
+  sdf::Errors errors = root.LoadSdfString(sdfString);
+  auto end = std::chrono::steady_clock::now();
+  EXPECT_TRUE(errors.empty());
+
+  std::cout << "Root::LoadSdfString of " << modelCount * linkCount
+            << " links took "
+            << std::chrono::duration<double, std::milli>(end - start).count()
+            << " ms" << std::endl;
+
+  ASSERT_EQ(1u, root.WorldCount());
+  EXPECT_EQ(static_cast<uint64_t>(modelCount),
+      root.WorldByIndex(0)->ModelCount());
+}
+
+/////////////////////////////////////////////////
+TEST(LargeWorld, LargeModel_performance)
+{
+  // A single model with many children of the same type
+  const int linkCount = 5000;
+  const std::string sdfString = largeWorld(1, linkCount);
+
+  auto start = std::chrono::steady_clock::now();
+  sdf::Root root;
+  sdf::Errors errors = root.LoadSdfString(sdfString);
+  auto end = std::chrono::steady_clock::now();
+  EXPECT_TRUE(errors.empty());
+
+  std::cout << "Root::LoadSdfString of a model with " << linkCount
+            << " links took "
+            << std::chrono::duration<double, std::milli>(end - start).count()
+            << " ms" << std::endl;
+
+  ASSERT_EQ(1u, root.WorldCount());
+  ASSERT_EQ(1u, root.WorldByIndex(0)->ModelCount());
+  EXPECT_EQ(static_cast<uint64_t>(linkCount),
+      root.WorldByIndex(0)->ModelByIndex(0)->LinkCount());
+}
+
+/////////////////////////////////////////////////
+TEST(LargeWorld, ParallelDomLoad_performance)
+{
+  const int modelCount = 2000;
+  const int linkCount = 5;
+  const std::string sdfString = largeWorld(modelCount, linkCount);
+  const unsigned int threadCount =
+      std::max(2u, std::thread::hardware_concurrency());
+
+  // Parse the document beforehand, so that only the construction of the
+  // DOM objects is timed
+  double times[2];
+  for (unsigned int threads : {1u, threadCount})
+  {
+    sdf::SDFPtr sdfParsed(new sdf::SDF());
+    ASSERT_TRUE(sdf::init(sdfParsed));
+    sdf::Errors errors;
+    ASSERT_TRUE(sdf::readString(sdfString, sdfParsed, errors));
+
+    sdf::setDomLoadThreadCount(threads);
+    auto start = std::chrono::steady_clock::now();
+    sdf::Root root;
+    errors = root.Load(sdfParsed);
+    auto end = std::chrono::steady_clock::now();
+    sdf::setDomLoadThreadCount(1);
+    EXPECT_TRUE(errors.empty());
+
+    ASSERT_EQ(1u, root.WorldCount());
+    EXPECT_EQ(static_cast<uint64_t>(modelCount),
+        root.WorldByIndex(0)->ModelCount());
+    times[threads == 1 ? 0 : 1] =
+        std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  std::cout << "Root::Load of " << modelCount << " models took "
+            << times[0] << " ms with 1 thread and "
+            << times[1] << " ms with " << threadCount << " threads"
+            << std::endl;
+}
+
+/////////////////////////////////////////////////
+TEST(LargeWorld, ReadString_memory)
+{
+  const int modelCount = 200;
+  const int linkCount = 25;
+  const std::string sdfString = largeWorld(modelCount, linkCount);
+
+  sdf::SDFPtr sdfParsed(new sdf::SDF());
+  ASSERT_TRUE(sdf::init(sdfParsed));
+
+  const std::size_t startBytes = g_liveBytes;
+  resetAllocationCounters();
+
+  sdf::Errors errors;
+  EXPECT_TRUE(sdf::readString(sdfString, sdfParsed, errors));
+  EXPECT_TRUE(errors.empty());
+
+  const std::size_t allocations = g_allocationCount;
+  const std::size_t peakBytes = g_peakBytes - startBytes;
+  const std::size_t retainedBytes = g_liveBytes - startBytes;
+
+  std::cout << "readString of " << modelCount * linkCount << " links:\n"
+            << "  allocations: " << allocations << "\n"
+            << "  peak memory: " << peakBytes / 1024 << " KiB\n"
+            << "  retained memory: " << retainedBytes / 1024 << " KiB"
+            << std::endl;
+
+  // Cloning the parsed tree only copies values, since element descriptions
+  // are shared between clones.
+  resetAllocationCounters();
+  const std::size_t beforeCloneBytes = g_liveBytes;
+  sdf::ElementPtr clone = sdfParsed->Root()->Clone();
+  std::cout << "Clone of the parsed tree:\n"
+            << "  allocations: " << g_allocationCount << "\n"
+            << "  memory: "
+            << (g_liveBytes - beforeCloneBytes) / 1024 << " KiB" << std::endl;
+  EXPECT_EQ(sdfParsed->Root()->GetElementDescriptionCount(),
+            clone->GetElementDescriptionCount());
+}
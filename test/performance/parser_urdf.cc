@@ -15,6 +15,11 @@
  *
  */
 
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
 #include <string>
 
 #include <gtest/gtest.h>
@@ -34,3 +39,112 @@ TEST(URDFParser, AtlasURDF_5runs_performance)
     sdf::SDFPtr root = sdf::readFile(URDF_TEST_FILE);
   }
 }
+
+/////////////////////////////////////////////////
+TEST(URDFParser, AtlasURDFString_5runs_performance)
+{
+  const std::string
+    URDF_TEST_FILE = sdf::filesystem::append(PROJECT_SOURCE_PATH, "test",
+                                             "performance",
+                                             "parser_urdf_atlas.urdf");
+  std::ifstream stream(URDF_TEST_FILE);
+  const std::string urdfString((std::istreambuf_iterator<char>(stream)),
+                               std::istreambuf_iterator<char>());
+  ASSERT_FALSE(urdfString.empty());
+
+  for (int i = 0; i < 5; i++)
+  {
+    sdf::SDFPtr root(new sdf::SDF());
+    sdf::init(root);
+    ASSERT_TRUE(sdf::readString(urdfString, root));
+    EXPECT_TRUE(root->Root()->HasElement("model"));
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Get a URDF with a chain of links attached by fixed joints, like
+/// a sensor mast, with a revolute joint and a link at its end.
+/// \param[in] _length Number of fixed joints.
+std::string fixedJointChainUrdf(const int _length)
+{
+  const std::string inertial =
+    "<inertial><mass value='0.1'/>"
+    "<inertia ixx='0.01' ixy='0' ixz='0' iyy='0.01' iyz='0' izz='0.01'/>"
+    "</inertial>";
+  const std::string geometry =
+    "<origin xyz='0 0 0.05'/><geometry><box size='0.1 0.1 0.1'/></geometry>";
+
+  std::ostringstream stream;
+  stream << "<robot name='mast'>";
+  for (int i = 0; i <= _length; ++i)
+  {
+    stream << "<link name='link_" << i << "'>" << inertial
+           << "<visual>" << geometry << "</visual>"
+           << "<collision>" << geometry << "</collision>"
+           << "</link>";
+    if (i > 0)
+    {
+      stream << "<joint name='joint_" << i << "' type='fixed'>"
+             << "<parent link='link_" << i - 1 << "'/>"
+             << "<child link='link_" << i << "'/>"
+             << "<origin xyz='0 0 0.1' rpy='0 0 0.01'/>"
+             << "</joint>";
+    }
+    stream << "<gazebo reference='link_" << i << "'>"
+           << "<sensor name='sensor_" << i << "' type='imu'/>"
+           << "</gazebo>";
+  }
+  stream << "<link name='tip'>" << inertial << "</link>"
+         << "<joint name='tip_joint' type='revolute'>"
+         << "<parent link='link_" << _length << "'/>"
+         << "<child link='tip'/>"
+         << "<limit effort='1' velocity='1' lower='-1' upper='1'/>"
+         << "</joint>"
+         << "</robot>";
+  return stream.str();
+}
+
+/////////////////////////////////////////////////
+TEST(URDFParser, DeepFixedJointChain_performance)
+{
+  const int length = 1000;
+  const std::string urdfString = fixedJointChainUrdf(length);
+
+  sdf::SDFPtr root(new sdf::SDF());
+  sdf::init(root);
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(sdf::readString(urdfString, root));
+  auto end = std::chrono::steady_clock::now();
+
+  std::cout << "readString of a chain of " << length
+            << " fixed joints took "
+            << std::chrono::duration<double, std::milli>(end - start).count()
+            << " ms" << std::endl;
+
+  // The whole chain is lumped into its first link
+  sdf::ElementPtr model = root->Root()->GetElement("model");
+  ASSERT_NE(nullptr, model);
+  sdf::ElementPtr link = model->GetElement("link");
+  EXPECT_EQ("link_0", link->Get<std::string>("name"));
+
+  int visualCount = 0;
+  for (sdf::ElementPtr visual = link->GetElement("visual"); visual;
+       visual = visual->GetNextElement("visual"))
+  {
+    ++visualCount;
+  }
+  EXPECT_EQ(length + 1, visualCount);
+
+  int sensorCount = 0;
+  for (sdf::ElementPtr sensor = link->GetElement("sensor"); sensor;
+       sensor = sensor->GetNextElement("sensor"))
+  {
+    ++sensorCount;
+  }
+  EXPECT_EQ(length + 1, sensorCount);
+
+  sdf::ElementPtr joint = model->GetElement("joint");
+  ASSERT_NE(nullptr, joint);
+  EXPECT_EQ("tip_joint", joint->Get<std::string>("name"));
+  EXPECT_EQ("link_0", joint->Get<std::string>("parent"));
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <ignition/math/Pose3.hh>
+
+#include "PoseBatch.hh"
+
+using Pose = ignition::math::Pose3d;
+
+/////////////////////////////////////////////////
+TEST(PoseBatch, ComposePoses_performance)
+{
+  // Many short chains hanging from a few roots, like the frames of the
+  // models of a large world, sorted by depth
+  const std::size_t rootCount = 100;
+  const std::size_t chainCount = 1000;
+  const std::size_t chainLength = 10;
+
+  std::vector<std::size_t> parents(rootCount, 0);
+  std::vector<std::size_t> depthOffsets = {0, rootCount};
+  for (std::size_t depth = 1; depth <= chainLength; ++depth)
+  {
+    const std::size_t begin = depthOffsets[depth - 1];
+    for (std::size_t i = 0; i < chainCount; ++i)
+    {
+      parents.push_back(depth == 1 ? i % rootCount : begin + i);
+    }
+    depthOffsets.push_back(parents.size());
+  }
+
+  std::vector<Pose> relative(parents.size());
+  sdf::PoseArrays relativeArrays;
+  relativeArrays.Resize(parents.size());
+  for (std::size_t i = 0; i < parents.size(); ++i)
+  {
+    const double d = static_cast<double>(i % 97);
+    relative[i] = Pose(0.1 * d, 0.2, -0.3 * d, 0.01 * d, 0.2, -0.02 * d);
+    relativeArrays.Set(i, relative[i]);
+  }
+
+  const int repeats = 20;
+
+  // Compose one pose at a time
+  std::vector<Pose> poses(parents.size());
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < repeats; ++r)
+  {
+    for (std::size_t i = 0; i < parents.size(); ++i)
+    {
+      poses[i] = i < rootCount ? relative[i] : poses[parents[i]] * relative[i];
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  const double scalarTime =
+      std::chrono::duration<double, std::milli>(end - start).count() / repeats;
+
+  // Compose as a batch
+  sdf::PoseArrays batchPoses;
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < repeats; ++r)
+  {
+    sdf::composePoses(relativeArrays, parents, depthOffsets, batchPoses);
+  }
+  end = std::chrono::steady_clock::now();
+  const double batchTime =
+      std::chrono::duration<double, std::milli>(end - start).count() / repeats;
+
+  std::cout << "Composing " << parents.size() << " poses took "
+            << scalarTime << " ms one at a time and "
+            << batchTime << " ms as a batch" << std::endl;
+
+  ASSERT_EQ(parents.size(), batchPoses.Size());
+  for (std::size_t i = 0; i < parents.size(); i += 101)
+  {
+    EXPECT_EQ(poses[i], batchPoses.Pose(i)) << i;
+  }
+}